@@ -0,0 +1,82 @@
+// MIT License
+
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Canonical server for the benchmark suite. Every scenario ecewo-bench runs
+// hits one of these routes, so results stay comparable between commits.
+//
+//   ecewo-bench-server [port] [threads]
+
+#include "ecewo.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DEFAULT_PORT 18900
+
+static void plaintext(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_static(res, 200, "Hello, World!", 13);
+}
+
+static void json(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_json(res, 200, "{\"message\":\"Hello, World!\"}");
+}
+
+static void user_post(ecewo_request_t *req, ecewo_response_t *res) {
+  const char *body = ecewo_sprintf(ecewo_req_arena(req), "user %s post %s",
+                                   ecewo_param(req, "id"),
+                                   ecewo_param(req, "post"));
+  ecewo_send_text(res, 200, body ? body : "");
+}
+
+static void echo_length(ecewo_request_t *req, ecewo_response_t *res) {
+  const char *body = ecewo_sprintf(ecewo_req_arena(req), "%zu", ecewo_req_body_len(req));
+  ecewo_send_text(res, 200, body ? body : "");
+}
+
+int main(int argc, char **argv) {
+  int port = argc > 1 ? atoi(argv[1]) : DEFAULT_PORT;
+  int threads = argc > 2 ? atoi(argv[2]) : 1;
+
+  if (port <= 0 || port > 65535 || threads <= 0) {
+    fprintf(stderr, "usage: %s [port] [threads]\n", argv[0]);
+    return 1;
+  }
+
+  ecewo_app_t *app = ecewo_create();
+  if (!app)
+    return 1;
+
+  ecewo_set_threads(app, threads);
+
+  ECEWO_GET(app, "/plaintext", plaintext);
+  ECEWO_GET(app, "/json", json);
+  ECEWO_GET(app, "/users/:id/posts/:post", user_post);
+  ECEWO_POST(app, "/echo", echo_length);
+  ECEWO_GET(app, "/metrics", ecewo_metrics_handler);
+
+  if (ecewo_bind(app, (uint16_t)port) != 0)
+    return 1;
+
+  ecewo_run();
+  return 0;
+}
@@ -0,0 +1,862 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// HTTP/1.1 load generator and benchmark runner.
+//
+// Starts ecewo-bench-server, runs every canonical scenario against it over
+// loopback and prints one JSON document with the throughput and latency
+// percentiles of each. Closed-loop scenarios keep a fixed number of requests
+// in flight per connection; the open-loop one sends at a fixed rate and
+// measures from the time a request was due, so a stalled server can't hide
+// its queueing delay (coordinated omission).
+//
+//   ecewo-bench --server PATH [options]   spawn the server and run the suite
+//   ecewo-bench --port N [options]        run against a server already up
+
+#include "ecewo.h"
+#include "uv.h"
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_PORT 18900
+#define HEADER_MAX 8192
+#define READ_CHUNK 65536
+#define MAX_IN_FLIGHT 256 // per connection
+#define OPEN_LOOP_TICK_MS 1
+
+// -------------------------------------------------------------------------
+// Latency histogram
+// -------------------------------------------------------------------------
+
+// Log-linear in microseconds: exact below 2^HIST_SUB_BITS, then every
+// power of two split into 2^(HIST_SUB_BITS - 1) buckets (< 1.6% error)
+#define HIST_SUB_BITS 7
+#define HIST_MAX_BITS 36
+#define HIST_SUB_COUNT (1 << HIST_SUB_BITS)
+#define HIST_HALF_COUNT (1 << (HIST_SUB_BITS - 1))
+#define HIST_BUCKETS (HIST_SUB_COUNT + (HIST_MAX_BITS - HIST_SUB_BITS) * HIST_HALF_COUNT)
+
+typedef struct {
+  uint64_t counts[HIST_BUCKETS];
+  uint64_t total;
+  uint64_t max;
+} histogram_t;
+
+static int hist_index(uint64_t us) {
+  if (us < HIST_SUB_COUNT)
+    return (int)us;
+  if (us >> HIST_MAX_BITS)
+    return HIST_BUCKETS - 1;
+
+  int bit = 63;
+  while (!(us >> bit))
+    bit--;
+
+  int shift = bit - (HIST_SUB_BITS - 1);
+  int sub = (int)(us >> shift) - HIST_HALF_COUNT;
+  return HIST_SUB_COUNT + (bit - HIST_SUB_BITS) * HIST_HALF_COUNT + sub;
+}
+
+static uint64_t hist_upper(int index) {
+  if (index < HIST_SUB_COUNT)
+    return (uint64_t)index;
+
+  int k = index - HIST_SUB_COUNT;
+  int bit = k / HIST_HALF_COUNT + HIST_SUB_BITS;
+  int shift = bit - (HIST_SUB_BITS - 1);
+  uint64_t sub = (uint64_t)(k % HIST_HALF_COUNT + HIST_HALF_COUNT);
+  return ((sub + 1) << shift) - 1;
+}
+
+static void hist_record(histogram_t *h, uint64_t us) {
+  h->counts[hist_index(us)]++;
+  h->total++;
+  if (us > h->max)
+    h->max = us;
+}
+
+static void hist_merge(histogram_t *dst, const histogram_t *src) {
+  for (int i = 0; i < HIST_BUCKETS; i++)
+    dst->counts[i] += src->counts[i];
+  dst->total += src->total;
+  if (src->max > dst->max)
+    dst->max = src->max;
+}
+
+static uint64_t hist_percentile(const histogram_t *h, double percentile) {
+  if (h->total == 0)
+    return 0;
+
+  double rank = percentile / 100.0 * (double)h->total;
+  uint64_t target = (uint64_t)rank;
+  if ((double)target < rank || target == 0)
+    target++;
+
+  uint64_t seen = 0;
+  for (int i = 0; i < HIST_BUCKETS; i++) {
+    seen += h->counts[i];
+    if (seen >= target) {
+      uint64_t upper = hist_upper(i);
+      return upper < h->max ? upper : h->max;
+    }
+  }
+  return h->max;
+}
+
+// -------------------------------------------------------------------------
+// Options and scenarios
+// -------------------------------------------------------------------------
+
+typedef struct {
+  const char *server; // NULL: a server is already listening on port
+  const char *host;
+  const char *only; // run just this scenario
+  int port;
+  int server_threads;
+  int threads; // load generator threads, one loop each
+  int connections;
+  int idle;
+  int pipeline;
+  double rate;
+  double duration;
+  double warmup;
+} options_t;
+
+typedef struct {
+  const char *name;
+  const char *method;
+  const char *path;
+  size_t body_size;
+  bool pipelined; // keep options.pipeline requests in flight per connection
+  bool idle; // hold options.idle extra connections open without traffic
+  bool open_loop; // send at options.rate instead of after each reply
+} scenario_t;
+
+static const scenario_t scenarios[] = {
+  { "plaintext", "GET", "/plaintext", 0, false, false, false },
+  { "json", "GET", "/json", 0, false, false, false },
+  { "params", "GET", "/users/42/posts/7", 0, false, false, false },
+  { "post-1k", "POST", "/echo", 1024, false, false, false },
+  { "pipelined", "GET", "/plaintext", 0, true, false, false },
+  { "idle-connections", "GET", "/plaintext", 0, false, true, false },
+  { "open-loop", "GET", "/plaintext", 0, false, false, true },
+};
+
+#define SCENARIO_COUNT (sizeof(scenarios) / sizeof(scenarios[0]))
+
+// -------------------------------------------------------------------------
+// Connections
+// -------------------------------------------------------------------------
+
+typedef struct worker_s worker_t;
+
+typedef struct {
+  uv_tcp_t tcp;
+  uv_connect_t connect_req;
+  worker_t *w;
+  bool idle;
+  bool connected;
+  bool closing;
+
+  // Send time of every request in flight, oldest first
+  uint64_t sent_at[MAX_IN_FLIGHT];
+  unsigned head;
+  unsigned in_flight;
+
+  // Response framing; the benchmark server always sends Content-Length
+  char header[HEADER_MAX];
+  size_t header_len;
+  uint64_t body_left;
+  bool in_body;
+  int status;
+} conn_t;
+
+struct worker_s {
+  uv_loop_t loop;
+  uv_thread_t thread;
+  uv_timer_t stop_timer;
+  uv_timer_t tick_timer;
+  const options_t *opt;
+  const scenario_t *sc;
+  struct sockaddr_storage addr;
+  uv_buf_t request;
+
+  conn_t *conns;
+  int conn_count;
+  int active_count; // conns[0..active_count) carry traffic, the rest idle
+  int open_handles;
+
+  uint64_t start; // uv_hrtime()
+  uint64_t measure_from;
+  bool stopping;
+
+  int in_flight_target; // closed loop
+  double rate; // open loop, requests per second for this worker
+  uint64_t issued;
+  int next_conn;
+
+  histogram_t hist;
+  uint64_t completed;
+  uint64_t errors;
+  uint64_t dropped;
+};
+
+static void on_conn_closed(uv_handle_t *handle) {
+  conn_t *c = handle->data;
+  c->w->open_handles--;
+}
+
+static void conn_close(conn_t *c) {
+  if (c->closing)
+    return;
+  c->closing = true;
+  uv_close((uv_handle_t *)&c->tcp, on_conn_closed);
+}
+
+static void on_write(uv_write_t *req, int status) {
+  conn_t *c = req->data;
+  free(req);
+
+  if (status < 0 && !c->closing) {
+    c->w->errors++;
+    conn_close(c);
+  }
+}
+
+static bool conn_send(conn_t *c, uint64_t due) {
+  if (c->closing || !c->connected || c->in_flight >= MAX_IN_FLIGHT)
+    return false;
+
+  uv_write_t *req = malloc(sizeof(uv_write_t));
+  if (!req)
+    return false;
+  req->data = c;
+
+  // Every connection writes the same immutable request bytes
+  if (uv_write(req, (uv_stream_t *)&c->tcp, &c->w->request, 1, on_write) != 0) {
+    free(req);
+    return false;
+  }
+
+  c->sent_at[(c->head + c->in_flight) % MAX_IN_FLIGHT] = due;
+  c->in_flight++;
+  return true;
+}
+
+static void response_done(conn_t *c) {
+  worker_t *w = c->w;
+  uint64_t now = uv_hrtime();
+
+  if (c->in_flight == 0) {
+    w->errors++;
+    conn_close(c);
+    return;
+  }
+
+  uint64_t sent = c->sent_at[c->head];
+  c->head = (c->head + 1) % MAX_IN_FLIGHT;
+  c->in_flight--;
+
+  if (sent >= w->measure_from) {
+    if (c->status >= 200 && c->status < 300) {
+      hist_record(&w->hist, (now - sent) / 1000);
+      w->completed++;
+    } else {
+      w->errors++;
+    }
+  }
+
+  if (!w->stopping && w->rate == 0)
+    conn_send(c, now);
+}
+
+static bool header_has(const char *line, const char *name) {
+  for (; *name; name++, line++) {
+    char ch = *line;
+    if (ch >= 'A' && ch <= 'Z')
+      ch = (char)(ch - 'A' + 'a');
+    if (ch != *name)
+      return false;
+  }
+  return true;
+}
+
+// Called with the complete head, CRLFCRLF included
+static bool parse_head(conn_t *c) {
+  c->header[c->header_len] = '\0';
+
+  if (c->header_len < 12 || strncmp(c->header, "HTTP/1.", 7) != 0)
+    return false;
+
+  c->status = atoi(c->header + 9);
+  c->body_left = 0;
+
+  const char *line = strstr(c->header, "\r\n");
+  while (line && line[2] != '\r') {
+    line += 2;
+    if (header_has(line, "content-length:"))
+      c->body_left = strtoull(line + 15, NULL, 10);
+    line = strstr(line, "\r\n");
+  }
+  return true;
+}
+
+static void conn_feed(conn_t *c, const char *p, size_t n) {
+  while (n > 0 && !c->closing) {
+    if (c->in_body) {
+      size_t take = n < c->body_left ? n : (size_t)c->body_left;
+      c->body_left -= take;
+      p += take;
+      n -= take;
+      if (c->body_left == 0) {
+        c->in_body = false;
+        response_done(c);
+      }
+      continue;
+    }
+
+    bool complete = false;
+    while (n > 0) {
+      if (c->header_len >= HEADER_MAX - 1) {
+        c->w->errors++;
+        conn_close(c);
+        return;
+      }
+
+      c->header[c->header_len++] = *p++;
+      n--;
+
+      if (c->header_len >= 4 && memcmp(c->header + c->header_len - 4, "\r\n\r\n", 4) == 0) {
+        complete = true;
+        break;
+      }
+    }
+
+    if (!complete)
+      return;
+
+    if (!parse_head(c)) {
+      c->w->errors++;
+      conn_close(c);
+      return;
+    }
+
+    c->header_len = 0;
+    if (c->body_left > 0)
+      c->in_body = true;
+    else
+      response_done(c);
+  }
+}
+
+static void on_alloc(uv_handle_t *handle, size_t suggested, uv_buf_t *buf) {
+  (void)handle;
+  (void)suggested;
+  static _Thread_local char chunk[READ_CHUNK];
+  *buf = uv_buf_init(chunk, sizeof(chunk));
+}
+
+static void on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+  conn_t *c = stream->data;
+
+  if (nread < 0) {
+    if (!c->w->stopping)
+      c->w->errors++;
+    conn_close(c);
+    return;
+  }
+
+  conn_feed(c, buf->base, (size_t)nread);
+}
+
+static void on_connect(uv_connect_t *req, int status) {
+  conn_t *c = req->data;
+  worker_t *w = c->w;
+
+  if (status < 0) {
+    w->errors++;
+    conn_close(c);
+    return;
+  }
+
+  c->connected = true;
+  uv_tcp_nodelay(&c->tcp, 1);
+  uv_read_start((uv_stream_t *)&c->tcp, on_alloc, on_read);
+
+  if (c->idle || w->rate > 0 || w->stopping)
+    return;
+
+  uint64_t now = uv_hrtime();
+  for (int i = 0; i < w->in_flight_target; i++)
+    conn_send(c, now);
+}
+
+// -------------------------------------------------------------------------
+// Workers
+// -------------------------------------------------------------------------
+
+static void on_stop(uv_timer_t *timer) {
+  worker_t *w = timer->data;
+  w->stopping = true;
+
+  uv_close((uv_handle_t *)&w->stop_timer, NULL);
+  if (w->rate > 0)
+    uv_close((uv_handle_t *)&w->tick_timer, NULL);
+
+  // Replies still in flight are not counted
+  for (int i = 0; i < w->conn_count; i++)
+    conn_close(&w->conns[i]);
+}
+
+// Open loop: send everything that has come due since the start, spread
+// over the connections. A request is timed from when it was due.
+static void on_tick(uv_timer_t *timer) {
+  worker_t *w = timer->data;
+  uint64_t now = uv_hrtime();
+  double interval = 1e9 / w->rate;
+  uint64_t due = (uint64_t)((double)(now - w->start) / interval);
+  int active = w->active_count;
+
+  while (w->issued < due) {
+    uint64_t due_at = w->start + (uint64_t)((double)w->issued * interval);
+    bool sent = false;
+
+    for (int tries = 0; tries < active && !sent; tries++) {
+      conn_t *c = &w->conns[w->next_conn];
+      w->next_conn = (w->next_conn + 1) % active;
+      sent = conn_send(c, due_at);
+    }
+
+    // Every connection is saturated; the server is past this rate
+    if (!sent && due_at >= w->measure_from)
+      w->dropped++;
+
+    w->issued++;
+  }
+}
+
+static int worker_init(worker_t *w, const options_t *opt, const scenario_t *sc, int index, uv_buf_t request) {
+  memset(w, 0, sizeof(*w));
+  w->opt = opt;
+  w->sc = sc;
+  w->request = request;
+
+  int active = opt->connections / opt->threads + (index < opt->connections % opt->threads ? 1 : 0);
+  int idle = sc->idle ? opt->idle / opt->threads : 0;
+  w->conn_count = active + idle;
+  w->active_count = active;
+  w->in_flight_target = sc->pipelined ? opt->pipeline : 1;
+  w->rate = sc->open_loop ? opt->rate / opt->threads : 0;
+
+  if (uv_ip4_addr(opt->host, opt->port, (struct sockaddr_in *)&w->addr) != 0
+      && uv_ip6_addr(opt->host, opt->port, (struct sockaddr_in6 *)&w->addr) != 0)
+    return -1;
+
+  w->conns = calloc((size_t)(w->conn_count > 0 ? w->conn_count : 1), sizeof(conn_t));
+  if (!w->conns)
+    return -1;
+
+  for (int i = 0; i < w->conn_count; i++)
+    w->conns[i].idle = i >= active;
+
+  return uv_loop_init(&w->loop);
+}
+
+static void worker_run(void *arg) {
+  worker_t *w = arg;
+
+  w->start = uv_hrtime();
+  w->measure_from = w->start + (uint64_t)(w->opt->warmup * 1e9);
+
+  for (int i = 0; i < w->conn_count; i++) {
+    conn_t *c = &w->conns[i];
+    c->w = w;
+    c->tcp.data = c;
+    c->connect_req.data = c;
+
+    if (uv_tcp_init(&w->loop, &c->tcp) != 0) {
+      c->closing = true;
+      w->errors++;
+      continue;
+    }
+    w->open_handles++;
+
+    if (uv_tcp_connect(&c->connect_req, &c->tcp, (const struct sockaddr *)&w->addr, on_connect) != 0) {
+      w->errors++;
+      conn_close(c);
+    }
+  }
+
+  uv_timer_init(&w->loop, &w->stop_timer);
+  w->stop_timer.data = w;
+  uv_timer_start(&w->stop_timer, on_stop, (uint64_t)((w->opt->warmup + w->opt->duration) * 1000), 0);
+
+  if (w->rate > 0) {
+    uv_timer_init(&w->loop, &w->tick_timer);
+    w->tick_timer.data = w;
+    uv_timer_start(&w->tick_timer, on_tick, OPEN_LOOP_TICK_MS, OPEN_LOOP_TICK_MS);
+  }
+
+  uv_run(&w->loop, UV_RUN_DEFAULT);
+  uv_loop_close(&w->loop);
+}
+
+static char *build_request(const scenario_t *sc, const options_t *opt, size_t *len_out) {
+  size_t head_max = 256 + strlen(sc->path) + strlen(opt->host);
+  char *buf = malloc(head_max + sc->body_size);
+  if (!buf)
+    return NULL;
+
+  int n;
+  if (sc->body_size > 0) {
+    n = snprintf(buf, head_max,
+                 "%s %s HTTP/1.1\r\nHost: %s:%d\r\n"
+                 "Content-Type: application/octet-stream\r\nContent-Length: %zu\r\n\r\n",
+                 sc->method, sc->path, opt->host, opt->port, sc->body_size);
+  } else {
+    n = snprintf(buf, head_max, "%s %s HTTP/1.1\r\nHost: %s:%d\r\n\r\n",
+                 sc->method, sc->path, opt->host, opt->port);
+  }
+
+  if (n < 0 || (size_t)n >= head_max) {
+    free(buf);
+    return NULL;
+  }
+
+  memset(buf + n, 'x', sc->body_size);
+  *len_out = (size_t)n + sc->body_size;
+  return buf;
+}
+
+typedef struct {
+  histogram_t hist;
+  uint64_t completed;
+  uint64_t errors;
+  uint64_t dropped;
+} result_t;
+
+static int run_scenario(const options_t *opt, const scenario_t *sc, result_t *result) {
+  size_t request_len = 0;
+  char *request = build_request(sc, opt, &request_len);
+  if (!request)
+    return -1;
+
+  worker_t *workers = calloc((size_t)opt->threads, sizeof(worker_t));
+  if (!workers) {
+    free(request);
+    return -1;
+  }
+
+  int started = 0;
+  int rc = 0;
+  for (int i = 0; i < opt->threads; i++) {
+    if (worker_init(&workers[i], opt, sc, i, uv_buf_init(request, (unsigned int)request_len)) != 0) {
+      free(workers[i].conns);
+      rc = -1;
+      break;
+    }
+    if (uv_thread_create(&workers[i].thread, worker_run, &workers[i]) != 0) {
+      uv_loop_close(&workers[i].loop);
+      free(workers[i].conns);
+      rc = -1;
+      break;
+    }
+    started++;
+  }
+
+  memset(result, 0, sizeof(*result));
+  for (int i = 0; i < started; i++) {
+    uv_thread_join(&workers[i].thread);
+    hist_merge(&result->hist, &workers[i].hist);
+    result->completed += workers[i].completed;
+    result->errors += workers[i].errors;
+    result->dropped += workers[i].dropped;
+    free(workers[i].conns);
+  }
+
+  free(workers);
+  free(request);
+  return rc;
+}
+
+static void print_result(const options_t *opt, const scenario_t *sc, const result_t *r, bool first) {
+  printf("%s\n    {\"scenario\": \"%s\", \"mode\": \"%s\", \"connections\": %d,"
+         " \"idle_connections\": %d, \"pipeline\": %d, \"target_rps\": %.0f,\n"
+         "     \"requests\": %" PRIu64 ", \"errors\": %" PRIu64 ", \"dropped\": %" PRIu64 ","
+         " \"rps\": %.1f,\n"
+         "     \"latency_us\": {\"p50\": %" PRIu64 ", \"p90\": %" PRIu64 ", \"p99\": %" PRIu64
+         ", \"p999\": %" PRIu64 ", \"max\": %" PRIu64 "}}",
+         first ? "" : ",",
+         sc->name,
+         sc->open_loop ? "open" : "closed",
+         opt->connections,
+         sc->idle ? opt->idle / opt->threads * opt->threads : 0,
+         sc->pipelined ? opt->pipeline : 1,
+         sc->open_loop ? opt->rate : 0.0,
+         r->completed,
+         r->errors,
+         r->dropped,
+         (double)r->completed / opt->duration,
+         hist_percentile(&r->hist, 50),
+         hist_percentile(&r->hist, 90),
+         hist_percentile(&r->hist, 99),
+         hist_percentile(&r->hist, 99.9),
+         r->hist.max);
+  fflush(stdout);
+}
+
+// -------------------------------------------------------------------------
+// Server process
+// -------------------------------------------------------------------------
+
+typedef struct {
+  uv_process_t process;
+  bool exited;
+  int64_t exit_status;
+} server_t;
+
+static void on_server_exit(uv_process_t *process, int64_t exit_status, int term_signal) {
+  server_t *s = process->data;
+  (void)term_signal;
+  s->exited = true;
+  s->exit_status = exit_status;
+  uv_close((uv_handle_t *)process, NULL);
+}
+
+static int server_start(uv_loop_t *loop, server_t *s, const options_t *opt) {
+  char port[16];
+  char threads[16];
+  snprintf(port, sizeof(port), "%d", opt->port);
+  snprintf(threads, sizeof(threads), "%d", opt->server_threads);
+
+  char *args[] = { (char *)opt->server, port, threads, NULL };
+
+  // The server's banner would corrupt the JSON on stdout
+  uv_stdio_container_t stdio[3];
+  stdio[0].flags = UV_IGNORE;
+  stdio[1].flags = UV_IGNORE;
+  stdio[2].flags = UV_INHERIT_FD;
+  stdio[2].data.fd = 2;
+
+  uv_process_options_t options;
+  memset(&options, 0, sizeof(options));
+  options.file = opt->server;
+  options.args = args;
+  options.exit_cb = on_server_exit;
+  options.stdio = stdio;
+  options.stdio_count = 3;
+
+  memset(s, 0, sizeof(*s));
+  s->process.data = s;
+  int r = uv_spawn(loop, &s->process, &options);
+  if (r != 0)
+    fprintf(stderr, "ecewo-bench: can't start %s: %s\n", opt->server, uv_strerror(r));
+  return r;
+}
+
+typedef struct {
+  uv_tcp_t tcp;
+  uv_connect_t req;
+  int status;
+  bool done;
+} probe_t;
+
+static void on_probe_connect(uv_connect_t *req, int status) {
+  probe_t *p = req->data;
+  p->status = status;
+  uv_close((uv_handle_t *)&p->tcp, NULL);
+}
+
+// Polls until something accepts connections on the port
+static bool wait_for_port(const options_t *opt, uint64_t timeout_ms) {
+  struct sockaddr_storage addr;
+  if (uv_ip4_addr(opt->host, opt->port, (struct sockaddr_in *)&addr) != 0
+      && uv_ip6_addr(opt->host, opt->port, (struct sockaddr_in6 *)&addr) != 0)
+    return false;
+
+  uint64_t deadline = uv_hrtime() + timeout_ms * 1000000ull;
+  while (uv_hrtime() < deadline) {
+    uv_loop_t loop;
+    if (uv_loop_init(&loop) != 0)
+      return false;
+
+    probe_t p = { .status = -1 };
+    p.req.data = &p;
+    uv_tcp_init(&loop, &p.tcp);
+    if (uv_tcp_connect(&p.req, &p.tcp, (const struct sockaddr *)&addr, on_probe_connect) != 0)
+      uv_close((uv_handle_t *)&p.tcp, NULL);
+    uv_run(&loop, UV_RUN_DEFAULT);
+    uv_loop_close(&loop);
+
+    if (p.status == 0)
+      return true;
+    uv_sleep(50);
+  }
+  return false;
+}
+
+// -------------------------------------------------------------------------
+// Command line
+// -------------------------------------------------------------------------
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "usage: %s [--server PATH] [options]\n"
+          "  --server PATH        spawn this ecewo-bench-server (otherwise one must be running)\n"
+          "  --host ADDR          server address (default 127.0.0.1)\n"
+          "  --port N             server port (default %d)\n"
+          "  --server-threads N   worker threads of the spawned server (default 1)\n"
+          "  --threads N          load generator threads (default 1)\n"
+          "  --connections N      active connections (default 64)\n"
+          "  --idle N             idle connections for idle-connections (default 1000)\n"
+          "  --pipeline N         requests in flight per connection for pipelined (default 16)\n"
+          "  --rate N             requests per second for open-loop (default 20000)\n"
+          "  --duration SEC       measured time per scenario (default 5)\n"
+          "  --warmup SEC         unmeasured time before it (default 1)\n"
+          "  --scenario NAME      run only this scenario\n",
+          argv0, DEFAULT_PORT);
+}
+
+static int parse_options(int argc, char **argv, options_t *opt) {
+  *opt = (options_t) {
+    .host = "127.0.0.1",
+    .port = DEFAULT_PORT,
+    .server_threads = 1,
+    .threads = 1,
+    .connections = 64,
+    .idle = 1000,
+    .pipeline = 16,
+    .rate = 20000,
+    .duration = 5,
+    .warmup = 1,
+  };
+
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+
+    if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0)
+      return -1;
+    if (!val)
+      return -1;
+    i++;
+
+    if (strcmp(arg, "--server") == 0)
+      opt->server = val;
+    else if (strcmp(arg, "--host") == 0)
+      opt->host = val;
+    else if (strcmp(arg, "--port") == 0)
+      opt->port = atoi(val);
+    else if (strcmp(arg, "--server-threads") == 0)
+      opt->server_threads = atoi(val);
+    else if (strcmp(arg, "--threads") == 0)
+      opt->threads = atoi(val);
+    else if (strcmp(arg, "--connections") == 0)
+      opt->connections = atoi(val);
+    else if (strcmp(arg, "--idle") == 0)
+      opt->idle = atoi(val);
+    else if (strcmp(arg, "--pipeline") == 0)
+      opt->pipeline = atoi(val);
+    else if (strcmp(arg, "--rate") == 0)
+      opt->rate = atof(val);
+    else if (strcmp(arg, "--duration") == 0)
+      opt->duration = atof(val);
+    else if (strcmp(arg, "--warmup") == 0)
+      opt->warmup = atof(val);
+    else if (strcmp(arg, "--scenario") == 0)
+      opt->only = val;
+    else
+      return -1;
+  }
+
+  if (opt->port <= 0 || opt->port > 65535 || opt->server_threads <= 0 || opt->threads <= 0
+      || opt->connections < opt->threads || opt->idle < 0 || opt->pipeline <= 0
+      || opt->pipeline > MAX_IN_FLIGHT || opt->rate <= 0 || opt->duration <= 0 || opt->warmup < 0)
+    return -1;
+
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  options_t opt;
+  if (parse_options(argc, argv, &opt) != 0) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  uv_loop_t *loop = uv_default_loop();
+  server_t server;
+
+  if (opt.server) {
+    if (server_start(loop, &server, &opt) != 0)
+      return 1;
+  }
+
+  if (!wait_for_port(&opt, 5000)) {
+    fprintf(stderr, "ecewo-bench: nothing is listening on %s:%d\n", opt.host, opt.port);
+    if (opt.server)
+      uv_process_kill(&server.process, SIGKILL);
+    uv_run(loop, UV_RUN_DEFAULT);
+    return 1;
+  }
+
+  printf("{\"ecewo\": \"%s\", \"host\": \"%s\", \"port\": %d, \"server_threads\": %d,"
+         " \"threads\": %d, \"duration_s\": %.1f, \"warmup_s\": %.1f,\n  \"results\": [",
+         ecewo_version(), opt.host, opt.port, opt.server_threads,
+         opt.threads, opt.duration, opt.warmup);
+
+  int status = 0;
+  bool first = true;
+  for (size_t i = 0; i < SCENARIO_COUNT; i++) {
+    const scenario_t *sc = &scenarios[i];
+    if (opt.only && strcmp(opt.only, sc->name) != 0)
+      continue;
+
+    fprintf(stderr, "ecewo-bench: %s...\n", sc->name);
+
+    result_t result;
+    if (run_scenario(&opt, sc, &result) != 0) {
+      fprintf(stderr, "ecewo-bench: %s failed to start\n", sc->name);
+      status = 1;
+      continue;
+    }
+
+    if (result.errors > 0 || result.completed == 0)
+      status = 1;
+
+    print_result(&opt, sc, &result, first);
+    first = false;
+  }
+
+  printf("\n  ]}\n");
+
+  if (opt.server && !server.exited) {
+    uv_process_kill(&server.process, SIGTERM);
+    uv_run(loop, UV_RUN_DEFAULT);
+    if (server.exit_status != 0)
+      status = 1;
+  }
+
+  uv_loop_close(loop);
+  return status;
+}
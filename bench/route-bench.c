@@ -0,0 +1,173 @@
+// MIT License
+
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// Microbenchmark for route matching. Registers the routes of
+// tests/test-router-stress.c plus a wildcard and runs each request path
+// through the recursive two-pass matcher (after tokenize_path), the
+// iterative one and the iterative one behind a route cache, printing one
+// JSON object per path.
+//
+//   ecewo-bench-route [iterations]
+
+#include "ecewo.h"
+#include "arena-internal.h"
+#include "route-table.h"
+#include "route-cache.h"
+#include "llhttp.h"
+#include "uv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_ITERATIONS 1000000
+
+// The arena is reset this often rather than on every lookup
+#define ARENA_RESET_INTERVAL 1024
+
+static void noop(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  (void)res;
+}
+
+typedef struct {
+  llhttp_method_t method;
+  const char *path;
+} bench_path_t;
+
+static const char *stress_routes[] = {
+  "/a/:id", "/b/:id", "/c/:id", "/d/:id", "/e/:id",
+  "/f/:id", "/g/:id", "/h/:id", "/i/:id", "/j/:id",
+  "/a/admin", "/:category/:id",
+};
+
+static const bench_path_t paths[] = {
+  { HTTP_GET, "/a/admin" }, // static beats dynamic
+  { HTTP_GET, "/c/42" }, // specific param route
+  { HTTP_GET, "/unknown/999" }, // generic fallback after a literal miss
+  { HTTP_POST, "/a/123" }, // no route for the method
+  { HTTP_GET, "/files/2024/06/report.pdf" }, // wildcard after backtracking
+};
+
+// Keeps the compiler from dropping the work
+static volatile size_t sink;
+
+static double run_recursive(route_table_t *table, llhttp_t *parser, const char *path, ecewo_arena_t *arena, int iterations) {
+  size_t len = strlen(path);
+  uint64_t start = uv_hrtime();
+  for (int i = 0; i < iterations; i++) {
+    tokenized_path_t tok;
+    route_match_t match;
+    if (tokenize_path(arena, path, len, &tok) == 0)
+      sink += route_table_match_recursive(table, parser, &tok, &match, arena);
+    if (i % ARENA_RESET_INTERVAL == 0)
+      arena_reset(arena);
+  }
+  return (double)(uv_hrtime() - start) / iterations;
+}
+
+static double run_iterative(route_table_t *table, llhttp_t *parser, const char *path, ecewo_arena_t *arena, int iterations) {
+  size_t len = strlen(path);
+  uint64_t start = uv_hrtime();
+  for (int i = 0; i < iterations; i++) {
+    route_match_t match;
+    sink += route_table_match(table, parser, path, len, &match, arena);
+    if (i % ARENA_RESET_INTERVAL == 0)
+      arena_reset(arena);
+  }
+  return (double)(uv_hrtime() - start) / iterations;
+}
+
+// The router's lookup with ecewo_set_route_cache(): every request but the
+// first is a hit, unless the path has no route
+static double run_cached(route_table_t *table, route_cache_t *cache, llhttp_t *parser, const char *path, ecewo_arena_t *arena, int iterations) {
+  size_t len = strlen(path);
+  llhttp_method_t method = llhttp_get_method(parser);
+  uint32_t generation = route_table_generation(table);
+  uint64_t start = uv_hrtime();
+  for (int i = 0; i < iterations; i++) {
+    route_match_t match;
+    uint64_t hash = route_cache_hash(method, path, len);
+    if (route_cache_lookup(cache, generation, hash, method, path, len, &match)) {
+      sink++;
+    } else if (route_table_match(table, parser, path, len, &match, arena)) {
+      route_cache_insert(cache, hash, method, path, len, &match);
+      sink++;
+    }
+    if (i % ARENA_RESET_INTERVAL == 0)
+      arena_reset(arena);
+  }
+  return (double)(uv_hrtime() - start) / iterations;
+}
+
+int main(int argc, char **argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+  if (iterations <= 0) {
+    fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  ecewo_arena_t app_arena = { 0 };
+  ecewo_arena_t request_arena = { 0 };
+
+  route_table_t *table = route_table_create(&app_arena);
+  if (!table) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+
+  for (size_t i = 0; i < sizeof(stress_routes) / sizeof(stress_routes[0]); i++)
+    route_table_add(table, &app_arena, HTTP_GET, stress_routes[i], noop, NULL);
+  route_table_add(table, &app_arena, HTTP_GET, "/files/*", noop, NULL);
+
+  if (route_table_freeze(table) != 0) {
+    fprintf(stderr, "failed to compile the route table\n");
+    return 1;
+  }
+
+  route_cache_t *cache = route_cache_create(64);
+  if (!cache) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+
+  llhttp_settings_t settings;
+  llhttp_settings_init(&settings);
+  llhttp_t parser;
+  llhttp_init(&parser, HTTP_REQUEST, &settings);
+
+  for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+    parser.method = paths[i].method;
+
+    double recursive = run_recursive(table, &parser, paths[i].path, &request_arena, iterations);
+    double iterative = run_iterative(table, &parser, paths[i].path, &request_arena, iterations);
+    double cached = run_cached(table, cache, &parser, paths[i].path, &request_arena, iterations);
+
+    printf("{\"method\":\"%s\",\"path\":\"%s\",\"recursive_ns\":%.1f,\"iterative_ns\":%.1f,\"cached_ns\":%.1f,\"speedup\":%.2f}\n",
+           llhttp_method_name(paths[i].method), paths[i].path,
+           recursive, iterative, cached, iterative > 0 ? recursive / iterative : 0.0);
+  }
+
+  route_cache_free(cache);
+  route_table_free(table);
+  arena_free(&request_arena);
+  arena_free(&app_arena);
+  return 0;
+}
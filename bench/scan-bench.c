@@ -0,0 +1,182 @@
+// MIT License
+
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// Microbenchmark for the delimiter scanner and url_decode() on long URLs.
+// Each case runs the selected kernel against the portable byte loop over
+// the same input and prints one JSON object per case.
+//
+//   ecewo-bench-scan [iterations]
+
+#include "scan.h"
+#include "utils.h"
+#include "uv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_ITERATIONS 200000
+
+// url_decode() as it was before it used scan_find2(): one byte at a time
+static void url_decode_bytewise(char *str, bool plus_as_space) {
+  unsigned char *src = (unsigned char *)str;
+  unsigned char *dst = (unsigned char *)str;
+
+  while (*src) {
+    if (*src == '%') {
+      int hi = (src[1] != '\0') ? hex_digit(src[1]) : -1;
+      int lo = (hi >= 0 && src[2] != '\0') ? hex_digit(src[2]) : -1;
+      if (hi >= 0 && lo >= 0) {
+        *dst++ = (unsigned char)((hi << 4) | lo);
+        src += 3;
+      } else {
+        *dst++ = *src++;
+      }
+    } else if (plus_as_space && *src == '+') {
+      *dst++ = ' ';
+      src++;
+    } else {
+      *dst++ = *src++;
+    }
+  }
+
+  *dst = '\0';
+}
+
+typedef struct {
+  const char *name;
+  char *input;
+  size_t len;
+} bench_case_t;
+
+// Keeps the compiler from dropping the work
+static volatile size_t sink;
+
+static size_t split_pairs(scan_find2_fn find, const char *s, size_t len) {
+  const char *p = s;
+  const char *end = s + len;
+  size_t hits = 0;
+
+  while (p < end) {
+    p = find(p, end, '=', '&');
+    if (p < end) {
+      hits++;
+      p++;
+    }
+  }
+  return hits;
+}
+
+static double run_split(scan_find2_fn find, const bench_case_t *c, int iterations) {
+  uint64_t start = uv_hrtime();
+  for (int i = 0; i < iterations; i++)
+    sink += split_pairs(find, c->input, c->len);
+  return (double)(uv_hrtime() - start) / iterations;
+}
+
+static double run_decode(void (*decode)(char *, bool), const bench_case_t *c, int iterations) {
+  char *buf = malloc(c->len + 1);
+  if (!buf)
+    return 0.0;
+
+  uint64_t elapsed = 0;
+  for (int i = 0; i < iterations; i++) {
+    memcpy(buf, c->input, c->len + 1);
+    uint64_t start = uv_hrtime();
+    decode(buf, true);
+    elapsed += uv_hrtime() - start;
+    sink += (unsigned char)buf[0];
+  }
+
+  free(buf);
+  return (double)elapsed / iterations;
+}
+
+// A query string of `pairs` key=value pairs whose values are `value_len`
+// bytes long, with an escape every `escape_every` bytes (0 for none)
+static bench_case_t make_query(const char *name, int pairs, int value_len, int escape_every) {
+  bench_case_t c = { name, NULL, 0 };
+  size_t cap = (size_t)pairs * (size_t)(value_len + 16) + 1;
+  char *s = malloc(cap);
+  if (!s)
+    return c;
+
+  size_t n = 0;
+  for (int i = 0; i < pairs; i++) {
+    n += (size_t)snprintf(s + n, cap - n, "%sk%d=", i ? "&" : "", i);
+    for (int j = 0; j < value_len && n + 4 < cap; j++) {
+      if (escape_every && j % escape_every == escape_every - 1) {
+        memcpy(s + n, "%2F", 3);
+        n += 3;
+      } else {
+        s[n++] = (char)('a' + j % 26);
+      }
+    }
+  }
+  s[n] = '\0';
+
+  c.input = s;
+  c.len = n;
+  return c;
+}
+
+static void print_result(const bench_case_t *c, const char *op, double scalar_ns, double kernel_ns) {
+  printf("{\"case\":\"%s\",\"op\":\"%s\",\"bytes\":%zu,\"kernel\":\"%s\","
+         "\"scalar_ns\":%.1f,\"kernel_ns\":%.1f,\"speedup\":%.2f}\n",
+         c->name, op, c->len, scan_kernel_name(),
+         scalar_ns, kernel_ns, kernel_ns > 0 ? scalar_ns / kernel_ns : 0.0);
+}
+
+int main(int argc, char **argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+  if (iterations <= 0) {
+    fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  bench_case_t cases[] = {
+    make_query("short-query", 4, 8, 0),
+    make_query("long-values", 8, 256, 0),
+    make_query("long-values-escaped", 8, 256, 64),
+    make_query("long-url", 1, 4096, 512),
+  };
+  size_t case_count = sizeof(cases) / sizeof(cases[0]);
+
+  for (size_t i = 0; i < case_count; i++) {
+    const bench_case_t *c = &cases[i];
+    if (!c->input) {
+      fprintf(stderr, "out of memory\n");
+      return 1;
+    }
+
+    double split_scalar = run_split(scan_find2_scalar, c, iterations);
+    double split_kernel = run_split(scan_find2, c, iterations);
+    print_result(c, "split", split_scalar, split_kernel);
+
+    double decode_scalar = run_decode(url_decode_bytewise, c, iterations);
+    double decode_kernel = run_decode(url_decode, c, iterations);
+    print_result(c, "url_decode", decode_scalar, decode_kernel);
+  }
+
+  for (size_t i = 0; i < case_count; i++)
+    free(cases[i].input);
+
+  return 0;
+}
@@ -39,6 +39,7 @@
 //    to ensure the trie/memory management is robust against malformed input.
 // ---------------------------------------------------------------------------
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -115,7 +116,8 @@ int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
     ecewo_arena_t arena = {0};
     tokenized_path_t tok = {0};
 
-    tokenize_path(&arena, path, path_len, &tok);
+    // Fails past MAX_PATH_SEGMENTS; the iterative matcher has no such limit
+    bool tokenized = tokenize_path(&arena, path, path_len, &tok) == 0;
 
     llhttp_settings_t settings;
     llhttp_settings_init(&settings);
@@ -124,7 +126,17 @@ int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
     parser.method = method_map[method_byte];
 
     route_match_t match;
-    route_table_match(route_table, &parser, &tok, &match, &arena);
+    route_table_match_static(route_table, &parser, path, path_len, &match);
+
+    // The iterative matcher must agree with the recursive reference
+    route_match_t reference;
+    bool found = route_table_match(route_table, &parser, path, path_len, &match, &arena);
+    bool expected = route_table_match_recursive(route_table, &parser, &tok, &reference, &arena);
+    // Every route has its own stats, so they tell which one won
+    if (tokenized && (found != expected
+                      || (found && (match.stats != reference.stats
+                                    || match.param_count != reference.param_count))))
+      abort();
 
     arena_free(&arena);
   }
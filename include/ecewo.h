@@ -237,12 +237,67 @@ ECEWO_EXPORT int ecewo_timeout_request(ecewo_response_t *res, uint64_t timeout_m
 ECEWO_EXPORT const char *ecewo_param(const ecewo_request_t *req, const char *key);
 
 /** Return the value of a named query string parameter, or NULL if not found.
- *  For the URL "/search?q=hello", ecewo_query(req, "q") returns "hello". */
+ *  For the URL "/search?q=hello", ecewo_query(req, "q") returns "hello". Keys and values are
+ *  URL-decoded; the query string is parsed on the first call for a request. */
 ECEWO_EXPORT const char *ecewo_query(const ecewo_request_t *req, const char *key);
 
+/** Called by ecewo_query_each() for each key=value pair; return false to stop. */
+typedef bool (*ecewo_query_cb_t)(const char *key, size_t key_len, const char *value, size_t value_len, void *user_data);
+
+/** Visit the query string's pairs in order, as they appear in the URL: not
+ *  URL-decoded and not NUL-terminated. A pair without '=' has a NULL value;
+ *  empty pairs ("a=1&&b=2") are skipped. Does not parse the query string for
+ *  ecewo_query(), so it is the cheap way to pass a query on verbatim.
+ *  Returns the number of pairs visited. */
+ECEWO_EXPORT size_t ecewo_query_each(const ecewo_request_t *req, ecewo_query_cb_t cb, void *user_data);
+
 /** Return the value of an incoming request header by name (case-insensitive), or NULL if absent. */
 ECEWO_EXPORT const char *ecewo_header_get(const ecewo_request_t *req, const char *key);
 
+/** Well-known request headers. The parser records where each one is as it
+ *  reads the request, so looking one up by id costs no scan. */
+typedef enum {
+  ECEWO_HDR_ACCEPT = 0,
+  ECEWO_HDR_ACCEPT_ENCODING,
+  ECEWO_HDR_ACCEPT_LANGUAGE,
+  ECEWO_HDR_ACCESS_CONTROL_REQUEST_HEADERS,
+  ECEWO_HDR_ACCESS_CONTROL_REQUEST_METHOD,
+  ECEWO_HDR_AUTHORIZATION,
+  ECEWO_HDR_CACHE_CONTROL,
+  ECEWO_HDR_CONNECTION,
+  ECEWO_HDR_CONTENT_ENCODING,
+  ECEWO_HDR_CONTENT_LENGTH,
+  ECEWO_HDR_CONTENT_TYPE,
+  ECEWO_HDR_COOKIE,
+  ECEWO_HDR_EXPECT,
+  ECEWO_HDR_FORWARDED,
+  ECEWO_HDR_HOST,
+  ECEWO_HDR_IF_MATCH,
+  ECEWO_HDR_IF_MODIFIED_SINCE,
+  ECEWO_HDR_IF_NONE_MATCH,
+  ECEWO_HDR_IF_RANGE,
+  ECEWO_HDR_IF_UNMODIFIED_SINCE,
+  ECEWO_HDR_ORIGIN,
+  ECEWO_HDR_RANGE,
+  ECEWO_HDR_REFERER,
+  ECEWO_HDR_SEC_WEBSOCKET_KEY,
+  ECEWO_HDR_SEC_WEBSOCKET_PROTOCOL,
+  ECEWO_HDR_SEC_WEBSOCKET_VERSION,
+  ECEWO_HDR_TRANSFER_ENCODING,
+  ECEWO_HDR_UPGRADE,
+  ECEWO_HDR_USER_AGENT,
+  ECEWO_HDR_X_FORWARDED_FOR,
+  ECEWO_HDR_X_FORWARDED_PROTO,
+  ECEWO_HDR_X_REAL_IP,
+  ECEWO_HDR_X_REQUEST_ID,
+  ECEWO_HDR_COUNT
+} ecewo_header_id_t;
+
+/** Return the value of a well-known request header, or NULL if absent or id is out of range.
+ *  Same result as ecewo_header_get() with the header's name; if the header was sent more
+ *  than once, both return the first. */
+ECEWO_EXPORT const char *ecewo_header_get_id(const ecewo_request_t *req, ecewo_header_id_t id);
+
 /** Append a response header. Does NOT check for duplicates - calling this twice with the
  *  same name will produce two headers in the response (legitimate for e.g. Set-Cookie).
  *
@@ -264,6 +319,18 @@ ECEWO_EXPORT void ecewo_header_set(ecewo_response_t *res, const char *name, cons
  *  After this call, res must not be accessed again. */
 ECEWO_EXPORT void ecewo_send(ecewo_response_t *res, int status, const void *body, size_t body_len);
 
+/** Releases a body handed to ecewo_send_owned(). Runs on the event-loop thread. */
+typedef void (*ecewo_free_cb_t)(void *data);
+
+/** Like ecewo_send(), but takes ownership of body instead of copying it.
+ *  free_cb(body) is called exactly once when the response no longer needs it,
+ *  including when sending fails. With free_cb NULL this behaves like ecewo_send_static(). */
+ECEWO_EXPORT void ecewo_send_owned(ecewo_response_t *res, int status, void *body, size_t body_len, ecewo_free_cb_t free_cb);
+
+/** Like ecewo_send(), for a body that outlives every response (string literals,
+ *  static tables, memory kept for the life of the process). The body is never copied. */
+ECEWO_EXPORT void ecewo_send_static(ecewo_response_t *res, int status, const void *body, size_t body_len);
+
 /** Send an HTTP redirect response to url with the given 3xx status code.
  *  Sets the Location header automatically. After this call, res must not be accessed again. */
 ECEWO_EXPORT void ecewo_redirect(ecewo_response_t *res, int status, const char *url);
@@ -277,6 +344,83 @@ ECEWO_EXPORT void ecewo_send_html(ecewo_response_t *res, int status, const char
 /** Send a JSON response (Content-Type: application/json). Convenience wrapper around ecewo_send(). */
 ECEWO_EXPORT void ecewo_send_json(ecewo_response_t *res, int status, const char *body);
 
+// ---------------------------------------------------------------------------
+// RESPONSE TEMPLATES
+// ---------------------------------------------------------------------------
+
+/** A response serialized once, e.g. at startup, for replies that never change
+ *  (health checks, robots.txt, canned errors). Build it before ecewo_run(); it
+ *  is read-only afterwards and may be sent from every thread. */
+typedef struct ecewo_response_template_s ecewo_response_template_t;
+
+/** Create a template with the given status and an empty body. Returns NULL for
+ *  a 1xx status or when out of memory. */
+ECEWO_EXPORT ecewo_response_template_t *ecewo_template_new(int status);
+
+/** Add a header to the template. Headers the framework sets (Content-Length,
+ *  Connection, Date...) are refused like in ecewo_header_set(). Returns 0 or -1. */
+ECEWO_EXPORT int ecewo_template_header(ecewo_response_template_t *tpl, const char *name, const char *value);
+
+/** Set the template's body; it is copied. Returns 0, or -1 when out of memory
+ *  or when the status is 204. */
+ECEWO_EXPORT int ecewo_template_body(ecewo_response_template_t *tpl, const void *body, size_t body_len);
+
+/** Free a template. Replies that use it may still be writing until ecewo_run()
+ *  returns, so free templates after that. */
+ECEWO_EXPORT void ecewo_template_free(ecewo_response_template_t *tpl);
+
+/** Send tpl. Only the status line, Date, Connection and headers set on res with
+ *  ecewo_header_set() are written per call; the template's headers and body are
+ *  shared and sent in place. After this call, res must not be accessed again. */
+ECEWO_EXPORT void ecewo_send_template(ecewo_response_t *res, const ecewo_response_template_t *tpl);
+
+// ---------------------------------------------------------------------------
+// STREAMING RESPONSES
+// ---------------------------------------------------------------------------
+
+/** Called once a chunk passed to ecewo_stream_write() has been written (status 0) or
+ *  dropped (status < 0). buf is the pointer that was passed in; it may be reused or freed here. */
+typedef void (*ecewo_stream_write_cb_t)(void *buf, int status);
+
+/** Start a streamed response with Transfer-Encoding: chunked (close-delimited for
+ *  HTTP/1.0 peers). Headers set with ecewo_header_set() are sent now.
+ *  The request timeout keeps running; extend it with ecewo_timeout_request() for long streams.
+ *  Returns 0 on success, -1 on error (the response can then still be sent normally). */
+ECEWO_EXPORT int ecewo_stream_begin(ecewo_response_t *res, int status);
+
+/** Like ecewo_stream_begin(), for a body whose total size is known up front.
+ *  Sends Content-Length instead of chunked framing; writes past the length are rejected. */
+ECEWO_EXPORT int ecewo_stream_begin_length(ecewo_response_t *res, int status, uint64_t content_length);
+
+/** Queue len bytes of body. With done_cb, buf is sent in place and must stay valid until
+ *  done_cb(buf, status) runs; with done_cb NULL the bytes are copied. done_cb may run before
+ *  this returns. Returns 0 if queued, -1 on error (done_cb is then not called). */
+ECEWO_EXPORT int ecewo_stream_write(ecewo_response_t *res, const void *buf, size_t len, ecewo_stream_write_cb_t done_cb);
+
+/** Finish a streamed response. After this call, res must not be accessed again.
+ *  Returns -1 if the connection is gone or a Content-Length body was cut short. */
+ECEWO_EXPORT int ecewo_stream_end(ecewo_response_t *res);
+
+/** Bytes queued on the connection but not yet accepted by the socket. Producers should
+ *  pause above their own threshold and resume from a write callback. */
+ECEWO_EXPORT size_t ecewo_stream_queue_size(const ecewo_response_t *res);
+
+// ---------------------------------------------------------------------------
+// STATIC FILES
+// ---------------------------------------------------------------------------
+
+/** Send the file at path with status 200, or 304 when the request's If-None-Match or
+ *  If-Modified-Since still matches. The body goes from the file to the socket via sendfile.
+ *  ETag, Last-Modified and (unless already set) Content-Type are added.
+ *  Returns 0 once the response is sent, -1 if path is not a readable regular file (nothing is sent). */
+ECEWO_EXPORT int ecewo_send_file(ecewo_response_t *res, const char *path);
+
+/** Serve the files under dir for GET and HEAD requests below prefix, e.g.
+ *  ecewo_static(app, "/assets", "./public") maps /assets/app.js to ./public/app.js.
+ *  Paths ending in '/' serve index.html; anything else that isn't a file gets 404.
+ *  Returns 0 on success, -1 on error. */
+ECEWO_EXPORT int ecewo_static(ecewo_app_t *app, const char *prefix, const char *dir);
+
 // ---------------------------------------------------------------------------
 // MEMORY MANAGEMENT
 // ---------------------------------------------------------------------------
@@ -350,7 +494,8 @@ ECEWO_EXPORT void ecewo_set_idle_timeout(ecewo_app_t *app, uint64_t ms);
 /** Set the per-request timeout in milliseconds; 0 disables (default: 0). */
 ECEWO_EXPORT void ecewo_set_request_timeout(ecewo_app_t *app, uint64_t ms);
 
-/** Set how often the cleanup timer runs in milliseconds (default: 30000). */
+/** No effect; kept for compatibility. Idle and request timeouts fire from a
+ *  per-loop timing wheel with TIMER_WHEEL_TICK_MS resolution. */
 ECEWO_EXPORT void ecewo_set_cleanup_interval(ecewo_app_t *app, uint64_t ms);
 
 /** Set the graceful shutdown drain timeout in milliseconds (default: 15000). */
@@ -363,6 +508,23 @@ ECEWO_EXPORT void ecewo_set_shutdown_timeout(ecewo_app_t *app, uint64_t ms);
  *  address. Must be set before ecewo_listen() / ecewo_bind(). */
 ECEWO_EXPORT void ecewo_set_listen_address(ecewo_app_t *app, const char *address);
 
+/** Serve the app from `count` threads, each running its own event loop with
+ *  its own SO_REUSEPORT listener and connections (default: 1). 0 or a negative
+ *  count means one thread per available CPU. Routes and middleware are shared
+ *  and must be registered before ecewo_run(); handlers then run concurrently.
+ *  Linux/BSD only; elsewhere the app stays on one thread. Must be set before
+ *  ecewo_listen() / ecewo_bind(). */
+ECEWO_EXPORT void ecewo_set_threads(ecewo_app_t *app, int count);
+
+/** Cache the routes matched for the `entries` most recently requested
+ *  (method, path) pairs whose route has params or a wildcard, so that a hot
+ *  path like "/users/42" skips the route tree on repeat requests; 0 disables
+ *  (default: 0). The count is rounded up, and every thread keeps a cache of
+ *  its own. Paths longer than ROUTE_CACHE_MAX_PATH (128) bytes are not
+ *  cached. Adding a route empties it. Hits and misses are reported by
+ *  ecewo_metrics_render(). Must be set before ecewo_listen() / ecewo_bind(). */
+ECEWO_EXPORT void ecewo_set_route_cache(ecewo_app_t *app, size_t entries);
+
 // ---------------------------------------------------------------------------
 // MIDDLEWARE REGISTRATION
 // ---------------------------------------------------------------------------
@@ -416,6 +578,16 @@ ECEWO_EXPORT void ecewo_route_middleware(ecewo_route_t *route, ecewo_middleware_
  *  After this call the builder must not be used again. */
 ECEWO_EXPORT void ecewo_route_handler(ecewo_route_t *route, ecewo_handler_t handler);
 
+/** Compile the registered routes for matching. Routes without `:param` or
+ *  `*` segments go into a perfect-hash table keyed on method and path, so
+ *  they are found with one hash and one comparison; the rest are flattened
+ *  into arrays. `ecewo_bind()` does this itself, so calling it is only
+ *  needed to catch an allocation failure early. A route registered
+ *  afterwards invalidates the compiled table, and it is rebuilt on the next
+ *  request; register every route before `ecewo_bind()` when serving from
+ *  several threads. Returns 0 on success, -1 on error. */
+ECEWO_EXPORT int ecewo_routes_freeze(ecewo_app_t *app);
+
 // Helper used by the macros below.
 // Reach for this only when you already have a flat function-pointer array and want to skip the builder steps.
 // fns = [middleware0, ..., middlewareN, handler], count = total elements.
@@ -598,10 +770,11 @@ ECEWO_EXPORT void ecewo_increment_async_work(void);
  *  Must be paired with a prior ecewo_increment_async_work(). For plugin authors only. */
 ECEWO_EXPORT void ecewo_decrement_async_work(void);
 
-/** Return the libuv event loop used by the runtime as a void pointer.
+/** Return the libuv event loop of the calling thread as a void pointer.
  *  Cast to uv_loop_t * (include uv.h) to use with libuv APIs directly.
- *  The loop is a process singleton - every app, timer, and ecewo_spawn() call
- *  shares it. Use this to integrate additional libuv handles with ecewo. */
+ *  Outside worker threads this is the runtime loop, a process singleton shared
+ *  by every app. Inside a handler of an app using ecewo_set_threads() it is
+ *  that worker's loop. Timers and ecewo_spawn() follow the same rule. */
 ECEWO_EXPORT void *ecewo_get_loop(void);
 
 /**
@@ -667,6 +840,45 @@ ECEWO_EXPORT bool ecewo_is_running(ecewo_app_t *app);
 /** Return the number of currently open client connections. Useful for monitoring and testing. */
 ECEWO_EXPORT int ecewo_active_connections(ecewo_app_t *app);
 
+/** Return how many connections have been closed by the idle or request timeout
+ *  since the app was created. Summed over all worker threads. */
+ECEWO_EXPORT uint64_t ecewo_timeout_expirations(ecewo_app_t *app);
+
+/** Render the app's metrics (connections, responses by status class, bytes,
+ *  parse errors, request durations, arena pool and ecewo_spawn() queue) in
+ *  the Prometheus text format. Writes at most size bytes including the NUL and
+ *  returns the full length, like snprintf(). Safe to call from any thread. */
+ECEWO_EXPORT size_t ecewo_metrics_render(ecewo_app_t *app, char *buf, size_t size);
+
+/** Handler that serves ecewo_metrics_render() output, e.g.
+ *  ECEWO_GET(app, "/metrics", ecewo_metrics_handler). Renders on the stack;
+ *  see METRICS_BUFFER_SIZE. */
+ECEWO_EXPORT void ecewo_metrics_handler(ecewo_request_t *req, ecewo_response_t *res);
+
+/** Latency statistics of one registered route and method. Opaque; owned by the app. */
+typedef struct ecewo_route_stats_s ecewo_route_stats_t;
+
+/** Called once per registered route by ecewo_route_stats_each(). */
+typedef void (*ecewo_route_stats_cb_t)(const ecewo_route_stats_t *stats, void *user_data);
+
+/** Visit the latency stats of every registered (method, pattern), in
+ *  registration order. Latency runs from the end of the request headers to
+ *  the start of the reply. Safe to call from any thread while serving. */
+ECEWO_EXPORT void ecewo_route_stats_each(ecewo_app_t *app, ecewo_route_stats_cb_t cb, void *user_data);
+
+/** Route pattern as registered, e.g. "/users/:id". */
+ECEWO_EXPORT const char *ecewo_route_stats_pattern(const ecewo_route_stats_t *stats);
+
+/** Method the route was registered for. */
+ECEWO_EXPORT ecewo_method_t ecewo_route_stats_method(const ecewo_route_stats_t *stats);
+
+/** Number of replies recorded. */
+ECEWO_EXPORT uint64_t ecewo_route_stats_count(const ecewo_route_stats_t *stats);
+
+/** Latency in microseconds at the given percentile (e.g. 50, 99, 99.9); at
+ *  most 1/8 above the exact value. 0 if nothing was recorded. */
+ECEWO_EXPORT uint64_t ecewo_route_stats_percentile(const ecewo_route_stats_t *stats, double percentile);
+
 // Dynamic Array Macros for C Users
 // Copyright 2022 Alexey Kutepov <reximkut@gmail.com>
 // Copyright 2026 Savas Sahin <savashn@proton.me>
@@ -51,4 +51,12 @@ void arena_pool_init(void);
 void arena_pool_destroy(void);
 bool arena_pool_is_initialized(void);
 
+// Threads get an arena cache on first borrow/return. Long-lived threads that
+// exit before the pool is destroyed should detach to hand theirs back.
+void arena_pool_thread_detach(void);
+
+// Borrows served from a cache and borrows that had to allocate, summed over
+// all threads, plus the number of live arenas. Lock-free; for metrics.
+void arena_pool_counters(uint64_t *hits, uint64_t *misses, uint64_t *live);
+
 #endif
@@ -21,11 +21,26 @@
 
 #include "arena-internal.h"
 #include "logger.h"
+#include "utils.h"
+#include "uv.h"
 #include <stdlib.h>
 #include <stdint.h>
-
-// Soft cap on the LIFO recycle cache. Arenas beyond this point are freed at
-// return rather than retained. Does NOT limit the number of live arenas;
+#include <stdatomic.h>
+
+// Arenas are recycled through two tiers:
+//
+//   thread cache: every thread that borrows or returns owns two magazines
+//                 (fixed-size stacks of arenas). Hits never lock.
+//   depot:        a shared LIFO of full magazines plus spare empty shells,
+//                 guarded by a mutex. Threads trade a whole magazine at a
+//                 time, so the lock is taken once per ARENA_MAGAZINE_SIZE
+//                 borrows or returns at most.
+//
+// An arena borrowed on one thread may be returned on any other; e.g. the
+// loop borrows for ecewo_spawn() and the worker returns it when done.
+
+// Soft cap on arenas parked in the depot. Arenas beyond this point are freed
+// at return rather than retained. Does NOT limit the number of live arenas;
 // borrow always tries malloc and only fails on OS allocation failure.
 #ifndef ARENA_POOL_CAP
 #define ARENA_POOL_CAP 1024
@@ -35,121 +50,206 @@
 #define PREALLOCATED_ARENA 32
 #endif
 
-#ifndef ARENA_POOL_LOW_WATERMARK
-#define ARENA_POOL_LOW_WATERMARK 8 /* Grow when <= 8 available */
-#endif
-
 #ifndef ARENA_POOL_HIGH_WATERMARK
-#define ARENA_POOL_HIGH_WATERMARK 64 /* Shrink when >= 64 available */
+#define ARENA_POOL_HIGH_WATERMARK 64 /* Shrink when >= 64 in the depot */
 #endif
 
 #ifndef ARENA_POOL_GROW_BATCH
 #define ARENA_POOL_GROW_BATCH 8 /* Allocate 8 at a time */
 #endif
 
+#ifndef ARENA_MAGAZINE_SIZE
+#define ARENA_MAGAZINE_SIZE 8
+#endif
+
+typedef struct arena_magazine_s arena_magazine_t;
+
+struct arena_magazine_s {
+  arena_magazine_t *next; // depot list link
+  uint32_t count;
+  ecewo_arena_t *rounds[ARENA_MAGAZINE_SIZE];
+};
+
+// Only the owning thread touches loaded/previous. `previous` is always
+// either empty or full, which keeps a thread that alternates borrow/return
+// around a magazine boundary from hitting the depot on every call.
+typedef struct arena_thread_cache_s arena_thread_cache_t;
+
+struct arena_thread_cache_s {
+  arena_thread_cache_t *next; // registry link; records are never unlinked
+  atomic_bool owned;
+  arena_magazine_t *loaded;
+  arena_magazine_t *previous;
+  // Written only by the owner; summed by arena_pool_counters()
+  atomic_uint_fast64_t hits;
+  atomic_uint_fast64_t misses;
+};
+
 typedef struct {
-  ecewo_arena_t **arenas; // heap-allocated LIFO of size pool_capacity
-  uint32_t pool_capacity; // size of the arenas[] array (recycle cache size)
-  uint32_t head;
-  uint32_t total_allocated; // live arenas (cached + in flight)
+  arena_magazine_t *full;  // non-empty magazines, LIFO
+  arena_magazine_t *empty; // spare magazine shells
+  uint32_t capacity;       // max arenas parked in the depot
+  uint32_t cached;         // arenas in depot magazines
+  atomic_uint total_allocated; // live arenas (depot + thread caches + in flight)
 
 #ifdef ECEWO_DEBUG
   uint32_t peak_usage;
-  uint32_t grow_count;
+  atomic_uint grow_count;
   uint32_t shrink_count;
 #endif
+  uv_mutex_t lock; // guards the depot fields above
+
+  // Every thread cache ever handed out; pushed lock-free, freed at destroy.
+  _Atomic(arena_thread_cache_t *) caches;
+  // Bumped by destroy so threads drop their cache pointer on next use
+  atomic_uint generation;
   bool initialized;
 } arena_pool_t;
 
 static arena_pool_t arena_pool = { 0 };
 
-// Called when acquiring
-static void arena_pool_try_grow(void) {
-  if (arena_pool.head > ARENA_POOL_LOW_WATERMARK)
-    return;
+static ECEWO_THREAD_LOCAL arena_thread_cache_t *thread_cache;
+static ECEWO_THREAD_LOCAL unsigned thread_cache_generation;
 
-  if (arena_pool.head >= arena_pool.pool_capacity)
-    return;
+static ecewo_arena_t *arena_new(void) {
+  ecewo_arena_t *arena = malloc(sizeof(ecewo_arena_t));
+  if (!arena)
+    return NULL;
 
-  uint32_t space_available = arena_pool.pool_capacity - arena_pool.head;
-  uint32_t to_allocate = ARENA_POOL_GROW_BATCH;
-  if (to_allocate > space_available)
-    to_allocate = space_available;
+  if (!new_region_to(&arena->begin, &arena->end, ARENA_REGION_SIZE)) {
+    free(arena);
+    return NULL;
+  }
 
-#ifdef ECEWO_DEBUG
+  return arena;
+}
+
+static void arena_delete(ecewo_arena_t *arena) {
+  arena_free(arena);
+  free(arena);
+  atomic_fetch_sub_explicit(&arena_pool.total_allocated, 1, memory_order_relaxed);
+}
+
+// Keep only the first region and rewind it
+static void arena_trim(ecewo_arena_t *arena) {
+  if (arena->begin && arena->begin->next) {
+    arena_region_t *to_free = arena->begin->next;
+    arena->begin->next = NULL;
+
+    while (to_free) {
+      arena_region_t *next = to_free->next;
+      free(to_free);
+      to_free = next;
+    }
+  }
+
+  if (arena->begin) {
+    arena->begin->count = 0;
+    arena->end = arena->begin;
+  }
+}
+
+// Frees a chain of magazines together with the arenas they hold.
+// Called outside the depot lock.
+static void magazine_chain_free(arena_magazine_t *mag) {
+  while (mag) {
+    arena_magazine_t *next = mag->next;
+    for (uint32_t i = 0; i < mag->count; i++)
+      arena_delete(mag->rounds[i]);
+    free(mag);
+    mag = next;
+  }
+}
+
+static uint32_t magazine_fill(arena_magazine_t *mag, uint32_t want) {
   uint32_t allocated = 0;
-#endif
 
-  for (uint32_t i = 0; i < to_allocate; i++) {
-    ecewo_arena_t *arena = malloc(sizeof(ecewo_arena_t));
+  while (allocated < want && mag->count < ARENA_MAGAZINE_SIZE) {
+    ecewo_arena_t *arena = arena_new();
     if (!arena)
       break;
 
-    if (!new_region_to(&arena->begin, &arena->end, ARENA_REGION_SIZE)) {
-      free(arena);
-      break;
-    }
+    mag->rounds[mag->count++] = arena;
+    allocated++;
+  }
 
-    arena_pool.arenas[arena_pool.head++] = arena;
-    arena_pool.total_allocated++;
+  atomic_fetch_add_explicit(&arena_pool.total_allocated, allocated, memory_order_relaxed);
+  return allocated;
+}
 
 #ifdef ECEWO_DEBUG
-    allocated++;
+// Outstanding = borrowed or sitting in a thread cache; the depot can't tell
+// the two apart. Caller holds arena_pool.lock.
+static void depot_track_peak_locked(void) {
+  uint32_t total = atomic_load_explicit(&arena_pool.total_allocated, memory_order_relaxed);
+  uint32_t outstanding = total > arena_pool.cached ? total - arena_pool.cached : 0;
+  if (outstanding > arena_pool.peak_usage)
+    arena_pool.peak_usage = outstanding;
+}
+#endif
+
+// Caller holds arena_pool.lock
+static arena_magazine_t *depot_take_empty_locked(void) {
+  arena_magazine_t *mag = arena_pool.empty;
+  if (mag) {
+    arena_pool.empty = mag->next;
+    mag->next = NULL;
   }
+  return mag;
+}
 
-  if (allocated > 0) {
-    arena_pool.grow_count++;
-    LOG_DEBUG("Arena pool grew: +%u arenas (now %u/%u cached)",
-              allocated,
-              arena_pool.head,
-              arena_pool.pool_capacity);
-#endif
+// Parks a magazine in the depot. Magazines that would push the depot past
+// its cap are moved to *to_free instead. Caller holds arena_pool.lock.
+static void depot_put_locked(arena_magazine_t *mag, arena_magazine_t **to_free) {
+  if (mag->count == 0) {
+    mag->next = arena_pool.empty;
+    arena_pool.empty = mag;
+    return;
+  }
+
+  if (arena_pool.cached + mag->count > arena_pool.capacity) {
+    mag->next = *to_free;
+    *to_free = mag;
+    return;
   }
+
+  mag->next = arena_pool.full;
+  arena_pool.full = mag;
+  arena_pool.cached += mag->count;
 }
 
-// Called when releasing
-static void arena_pool_try_shrink(void) {
-  if (arena_pool.head < ARENA_POOL_HIGH_WATERMARK)
+// Called when magazines come back. Caller holds arena_pool.lock.
+static void depot_try_shrink_locked(arena_magazine_t **to_free) {
+  if (arena_pool.cached < ARENA_POOL_HIGH_WATERMARK)
     return;
 
   // Keep some reserve, don't shrink below initial size
   uint32_t target = PREALLOCATED_ARENA + ARENA_POOL_GROW_BATCH;
-  if (arena_pool.head <= target)
+  if (arena_pool.cached <= target)
     return;
 
   // Shrink by half of excess
-  uint32_t excess = arena_pool.head - target;
-  uint32_t to_free = excess / 2;
-  if (to_free < ARENA_POOL_GROW_BATCH)
-    to_free = ARENA_POOL_GROW_BATCH;
-
-#ifdef ECEWO_DEBUG
-  uint32_t freed = 0;
-#endif
-
-  while (to_free > 0 && arena_pool.head > target) {
-    ecewo_arena_t *arena = arena_pool.arenas[--arena_pool.head];
-    arena_pool.arenas[arena_pool.head] = NULL;
-
-    if (arena) {
-      arena_free(arena);
-      free(arena);
-      if (arena_pool.total_allocated > 0)
-        arena_pool.total_allocated--;
-
-#ifdef ECEWO_DEBUG
-      freed++;
-#endif
-    }
-
-    to_free--;
+  uint32_t excess = arena_pool.cached - target;
+  uint32_t to_drop = excess / 2;
+  if (to_drop < ARENA_POOL_GROW_BATCH)
+    to_drop = ARENA_POOL_GROW_BATCH;
+
+  uint32_t dropped = 0;
+  while (dropped < to_drop && arena_pool.full && arena_pool.cached > target) {
+    arena_magazine_t *mag = arena_pool.full;
+    arena_pool.full = mag->next;
+    arena_pool.cached -= mag->count;
+    dropped += mag->count;
+
+    mag->next = *to_free;
+    *to_free = mag;
   }
 
 #ifdef ECEWO_DEBUG
-  if (freed > 0) {
+  if (dropped > 0) {
     arena_pool.shrink_count++;
-    LOG_DEBUG("Arena pool shrunk: -%u arenas (now %u/%u cached)",
-              freed, arena_pool.head, arena_pool.pool_capacity);
+    LOG_DEBUG("Arena pool shrunk: -%u arenas (now %u/%u in depot)",
+              dropped, arena_pool.cached, arena_pool.capacity);
   }
 #endif
 }
@@ -192,53 +292,55 @@ void arena_pool_init(void) {
   if (arena_pool.initialized)
     return;
 
-  arena_pool.pool_capacity = ARENA_POOL_CAP;
-  arena_pool.arenas = calloc(arena_pool.pool_capacity, sizeof(ecewo_arena_t *));
-  if (!arena_pool.arenas) {
-    LOG_ERROR("Failed to allocate arena pool LIFO (%u slots)",
-              arena_pool.pool_capacity);
-    arena_pool.pool_capacity = 0;
+  if (uv_mutex_init(&arena_pool.lock) != 0) {
+    LOG_ERROR("Failed to initialize arena pool lock");
     return;
   }
 
-  arena_pool.head = 0;
-  arena_pool.total_allocated = 0;
+  arena_pool.full = NULL;
+  arena_pool.empty = NULL;
+  arena_pool.capacity = ARENA_POOL_CAP;
+  arena_pool.cached = 0;
+  atomic_store(&arena_pool.total_allocated, 0);
+  atomic_store(&arena_pool.caches, NULL);
 
 #ifdef ECEWO_DEBUG
   arena_pool.peak_usage = 0;
-  arena_pool.grow_count = 0;
+  atomic_store(&arena_pool.grow_count, 0);
   arena_pool.shrink_count = 0;
 #endif
 
-  const uint32_t preallocate = get_arena_preallocation(arena_pool.pool_capacity);
+  const uint32_t preallocate = get_arena_preallocation(arena_pool.capacity);
 
-// Pre-allocate arenas
-#ifdef ECEWO_DEBUG
+  // Pre-allocate arenas, packed into full magazines
   uint32_t allocated = 0;
-#endif
-
-  for (uint32_t i = 0; i < preallocate; i++) {
-    ecewo_arena_t *arena = malloc(sizeof(ecewo_arena_t));
-    if (!arena) {
-      LOG_DEBUG("Failed to allocate arena %u/%u, stopping pre-allocation",
-                i + 1, preallocate);
+  while (allocated < preallocate) {
+    arena_magazine_t *mag = calloc(1, sizeof(arena_magazine_t));
+    if (!mag) {
+      LOG_DEBUG("Failed to allocate arena magazine, stopping pre-allocation");
       break;
     }
 
-    // Pre-allocate first region
-    if (!new_region_to(&arena->begin, &arena->end, ARENA_REGION_SIZE)) {
-      free(arena);
-      LOG_DEBUG("Failed to allocate region for arena %u/%u, stopping",
-                i + 1, preallocate);
+    uint32_t want = preallocate - allocated;
+    uint32_t got = magazine_fill(mag, want);
+    allocated += got;
+
+    if (got == 0) {
+      free(mag);
+      LOG_DEBUG("Failed to allocate arena %u/%u, stopping pre-allocation",
+                allocated + 1, preallocate);
       break;
     }
 
-    arena_pool.arenas[arena_pool.head++] = arena;
-    arena_pool.total_allocated++;
+    mag->next = arena_pool.full;
+    arena_pool.full = mag;
+    arena_pool.cached += got;
 
-#ifdef ECEWO_DEBUG
-    allocated++;
-#endif
+    if (got < want && mag->count < ARENA_MAGAZINE_SIZE) {
+      LOG_DEBUG("Failed to allocate arena %u/%u, stopping pre-allocation",
+                allocated + 1, preallocate);
+      break;
+    }
   }
 
   arena_pool.initialized = true;
@@ -247,86 +349,199 @@ void arena_pool_init(void) {
   double allocated_mb = (allocated * ARENA_REGION_SIZE) / (1024.0 * 1024.0);
   LOG_DEBUG("Arena pool initialized: %u/%u arenas (%.2f MB)",
             allocated,
-            arena_pool.pool_capacity,
+            arena_pool.capacity,
             allocated_mb);
 #endif
 }
 
+// Every thread must be done borrowing and returning by the time this runs.
+// Caches of threads that never detached (e.g. libuv threadpool threads) are
+// reclaimed here as well.
 void arena_pool_destroy(void) {
   if (!arena_pool.initialized)
     return;
 
 #ifdef ECEWO_DEBUG
   // Statistics before destruction
-  if (arena_pool.grow_count > 0 || arena_pool.shrink_count > 0) {
+  if (atomic_load(&arena_pool.grow_count) > 0 || arena_pool.shrink_count > 0) {
     LOG_DEBUG("Arena pool statistics:");
-    LOG_DEBUG("  Total allocated: %u arenas", arena_pool.total_allocated);
-    LOG_DEBUG("  Peak usage: %u arenas", arena_pool.peak_usage);
-    LOG_DEBUG("  Grow operations: %u", arena_pool.grow_count);
+    LOG_DEBUG("  Total allocated: %u arenas", atomic_load(&arena_pool.total_allocated));
+    LOG_DEBUG("  Peak outstanding: %u arenas", arena_pool.peak_usage);
+    LOG_DEBUG("  Grow operations: %u", atomic_load(&arena_pool.grow_count));
     LOG_DEBUG("  Shrink operations: %u", arena_pool.shrink_count);
   }
 #endif
 
-  if (arena_pool.arenas) {
-    for (uint32_t i = 0; i < arena_pool.head; i++) {
-      if (arena_pool.arenas[i]) {
-        arena_free(arena_pool.arenas[i]);
-        free(arena_pool.arenas[i]);
-        arena_pool.arenas[i] = NULL;
-      }
+  arena_pool.initialized = false;
+  atomic_fetch_add_explicit(&arena_pool.generation, 1, memory_order_release);
+  thread_cache = NULL;
+
+  arena_thread_cache_t *cache = atomic_exchange(&arena_pool.caches, NULL);
+  while (cache) {
+    arena_thread_cache_t *next = cache->next;
+    if (cache->loaded) {
+      cache->loaded->next = NULL;
+      magazine_chain_free(cache->loaded);
+    }
+    if (cache->previous) {
+      cache->previous->next = NULL;
+      magazine_chain_free(cache->previous);
     }
-    free(arena_pool.arenas);
-    arena_pool.arenas = NULL;
+    free(cache);
+    cache = next;
   }
 
-  arena_pool.head = 0;
-  arena_pool.pool_capacity = 0;
-  arena_pool.initialized = false;
+  magazine_chain_free(arena_pool.full);
+  magazine_chain_free(arena_pool.empty);
+  arena_pool.full = NULL;
+  arena_pool.empty = NULL;
+  arena_pool.cached = 0;
+  arena_pool.capacity = 0;
+  uv_mutex_destroy(&arena_pool.lock);
 
   LOG_DEBUG("Arena pool destroyed");
 }
 
-ecewo_arena_t *ecewo_arena_borrow(void) {
-  ecewo_arena_t *arena;
+// Returns the calling thread's cache, claiming a released record or
+// registering a new one on first use. NULL only on allocation failure.
+static arena_thread_cache_t *arena_thread_cache(void) {
+  unsigned generation = atomic_load_explicit(&arena_pool.generation, memory_order_acquire);
+  if (thread_cache && thread_cache_generation == generation)
+    return thread_cache;
+
+  arena_thread_cache_t *cache = atomic_load_explicit(&arena_pool.caches, memory_order_acquire);
+  for (; cache; cache = cache->next) {
+    if (!atomic_load_explicit(&cache->owned, memory_order_relaxed)
+        && !atomic_exchange_explicit(&cache->owned, true, memory_order_acquire))
+      break;
+  }
 
-  if (arena_pool.head > 0) {
-    // Take from pool
-    arena = arena_pool.arenas[--arena_pool.head];
-    arena_pool.arenas[arena_pool.head] = NULL;
+  if (!cache) {
+    cache = calloc(1, sizeof(arena_thread_cache_t));
+    if (!cache)
+      return NULL;
+
+    atomic_init(&cache->owned, true);
+    cache->next = atomic_load_explicit(&arena_pool.caches, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&arena_pool.caches,
+                                                  &cache->next, cache,
+                                                  memory_order_release,
+                                                  memory_order_relaxed))
+      ;
+  }
+
+  thread_cache = cache;
+  thread_cache_generation = generation;
+  return cache;
+}
+
+static void cache_count(atomic_uint_fast64_t *counter) {
+  atomic_store_explicit(counter,
+                        atomic_load_explicit(counter, memory_order_relaxed) + 1,
+                        memory_order_relaxed);
+}
+
+// Both magazines are empty: trade for a full one from the depot, or grow by
+// a batch straight into our own magazine when the depot has run dry.
+// *grew tells the two apart.
+static bool thread_cache_refill(arena_thread_cache_t *cache, bool *grew) {
+  uv_mutex_lock(&arena_pool.lock);
+
+  arena_magazine_t *full = arena_pool.full;
+  if (full) {
+    arena_pool.full = full->next;
+    arena_pool.cached -= full->count;
+    full->next = NULL;
+
+    if (cache->loaded && cache->previous) {
+      cache->previous->next = arena_pool.empty;
+      arena_pool.empty = cache->previous;
+    }
+    if (cache->loaded)
+      cache->previous = cache->loaded;
+    cache->loaded = full;
 
 #ifdef ECEWO_DEBUG
-    uint32_t in_use = arena_pool.total_allocated - arena_pool.head;
-    if (in_use > arena_pool.peak_usage)
-      arena_pool.peak_usage = in_use;
+    depot_track_peak_locked();
 #endif
-
-    arena_pool_try_grow();
-    arena_reset(arena);
-    return arena;
+    uv_mutex_unlock(&arena_pool.lock);
+    return true;
   }
 
-  // Pool's recycle cache is empty. Always try to allocate a fresh arena.
-  // Live arena count is bounded only by app->max_connections (and OS memory).
-  arena = malloc(sizeof(ecewo_arena_t));
-  if (!arena)
-    return NULL;
+  if (!cache->loaded)
+    cache->loaded = depot_take_empty_locked();
+  uv_mutex_unlock(&arena_pool.lock);
 
-  if (!new_region_to(&arena->begin, &arena->end, ARENA_REGION_SIZE)) {
-    free(arena);
-    return NULL;
-  }
+  if (!cache->loaded)
+    cache->loaded = calloc(1, sizeof(arena_magazine_t));
+  if (!cache->loaded)
+    return false;
 
-  arena_pool.total_allocated++;
+  // Depot's recycle cache is empty. Always try to allocate fresh arenas.
+  // Live arena count is bounded only by app->max_connections (and OS memory).
+  uint32_t allocated = magazine_fill(cache->loaded, ARENA_POOL_GROW_BATCH);
+  if (allocated == 0)
+    return false;
 
-#ifdef ECEWO_DEBUG
-  uint32_t in_use = arena_pool.total_allocated - arena_pool.head;
-  if (in_use > arena_pool.peak_usage)
-    arena_pool.peak_usage = in_use;
+  *grew = true;
 
-  LOG_DEBUG("Arena pool: allocated new arena (live=%u, cached=%u/%u)",
-            arena_pool.total_allocated, arena_pool.head, arena_pool.pool_capacity);
+#ifdef ECEWO_DEBUG
+  atomic_fetch_add_explicit(&arena_pool.grow_count, 1, memory_order_relaxed);
+  LOG_DEBUG("Arena pool grew: +%u arenas (live=%u)",
+            allocated, atomic_load(&arena_pool.total_allocated));
 #endif
 
+  return true;
+}
+
+// Both magazines are full: hand one to the depot and take an empty shell
+static bool thread_cache_spill(arena_thread_cache_t *cache) {
+  arena_magazine_t *to_free = NULL;
+
+  uv_mutex_lock(&arena_pool.lock);
+  if (cache->previous)
+    depot_put_locked(cache->previous, &to_free);
+  cache->previous = cache->loaded;
+  cache->loaded = depot_take_empty_locked();
+  depot_try_shrink_locked(&to_free);
+  uv_mutex_unlock(&arena_pool.lock);
+
+  magazine_chain_free(to_free);
+
+  if (!cache->loaded)
+    cache->loaded = calloc(1, sizeof(arena_magazine_t));
+  return cache->loaded != NULL;
+}
+
+ecewo_arena_t *ecewo_arena_borrow(void) {
+  if (!arena_pool.initialized)
+    return arena_new();
+
+  arena_thread_cache_t *cache = arena_thread_cache();
+  if (!cache) {
+    ecewo_arena_t *arena = arena_new();
+    if (arena)
+      atomic_fetch_add_explicit(&arena_pool.total_allocated, 1, memory_order_relaxed);
+    return arena;
+  }
+
+  bool grew = false;
+  arena_magazine_t *mag = cache->loaded;
+  if (!mag || mag->count == 0) {
+    if (cache->previous && cache->previous->count > 0) {
+      cache->loaded = cache->previous;
+      cache->previous = mag;
+    } else if (!thread_cache_refill(cache, &grew)) {
+      return NULL;
+    }
+    mag = cache->loaded;
+  }
+
+  cache_count(grew ? &cache->misses : &cache->hits);
+
+  ecewo_arena_t *arena = mag->rounds[--mag->count];
+  mag->rounds[mag->count] = NULL;
+  arena_reset(arena);
   return arena;
 }
 
@@ -340,35 +555,64 @@ void ecewo_arena_return(ecewo_arena_t *arena) {
     return;
   }
 
-  // Keep only the first region, free the rest
-  if (arena->begin && arena->begin->next) {
-    arena_region_t *to_free = arena->begin->next;
-    arena->begin->next = NULL;
+  arena_trim(arena);
 
-    while (to_free) {
-      arena_region_t *next = to_free->next;
-      free(to_free);
-      to_free = next;
-    }
+  arena_thread_cache_t *cache = arena_thread_cache();
+  if (!cache) {
+    arena_delete(arena);
+    return;
   }
 
-  // Reset the first region
-  if (arena->begin) {
-    arena->begin->count = 0;
-    arena->end = arena->begin;
+  arena_magazine_t *mag = cache->loaded;
+  if (!mag || mag->count == ARENA_MAGAZINE_SIZE) {
+    if (cache->previous && cache->previous->count == 0) {
+      cache->loaded = cache->previous;
+      cache->previous = mag;
+    } else if (!thread_cache_spill(cache)) {
+      // No magazine to hold it; free directly so live count stays honest
+      arena_delete(arena);
+      return;
+    }
+    mag = cache->loaded;
   }
 
-  if (arena_pool.arenas && arena_pool.head < arena_pool.pool_capacity) {
-    arena_pool.arenas[arena_pool.head++] = arena;
-    arena_pool_try_shrink();
-  } else {
-    // Recycle cache is full or unallocated; free directly so live count
-    // does not climb without bound.
-    arena_free(arena);
-    free(arena);
-    if (arena_pool.total_allocated > 0)
-      arena_pool.total_allocated--;
+  mag->rounds[mag->count++] = arena;
+}
+
+void arena_pool_thread_detach(void) {
+  arena_thread_cache_t *cache = thread_cache;
+  unsigned generation = atomic_load_explicit(&arena_pool.generation, memory_order_acquire);
+
+  thread_cache = NULL;
+  if (!cache || thread_cache_generation != generation || !arena_pool.initialized)
+    return;
+
+  arena_magazine_t *to_free = NULL;
+
+  uv_mutex_lock(&arena_pool.lock);
+  if (cache->loaded)
+    depot_put_locked(cache->loaded, &to_free);
+  if (cache->previous)
+    depot_put_locked(cache->previous, &to_free);
+  cache->loaded = NULL;
+  cache->previous = NULL;
+  depot_try_shrink_locked(&to_free);
+  uv_mutex_unlock(&arena_pool.lock);
+
+  magazine_chain_free(to_free);
+  atomic_store_explicit(&cache->owned, false, memory_order_release);
+}
+
+void arena_pool_counters(uint64_t *hits, uint64_t *misses, uint64_t *live) {
+  uint64_t h = 0, m = 0;
+  for (arena_thread_cache_t *c = atomic_load_explicit(&arena_pool.caches, memory_order_acquire); c; c = c->next) {
+    h += atomic_load_explicit(&c->hits, memory_order_relaxed);
+    m += atomic_load_explicit(&c->misses, memory_order_relaxed);
   }
+
+  *hits = h;
+  *misses = m;
+  *live = atomic_load_explicit(&arena_pool.total_allocated, memory_order_relaxed);
 }
 
 #ifdef ECEWO_DEBUG
@@ -378,19 +622,29 @@ void ecewo_arena_pool_stats(void) {
     return;
   }
 
-  uint32_t available = arena_pool.head;
-  uint32_t in_use = arena_pool.total_allocated - available;
-  double available_mb = (available * ARENA_REGION_SIZE) / (1024.0 * 1024.0);
-  double total_mb = (arena_pool.total_allocated * ARENA_REGION_SIZE) / (1024.0 * 1024.0);
+  uint32_t threads = 0;
+  for (arena_thread_cache_t *c = atomic_load(&arena_pool.caches); c; c = c->next) {
+    if (atomic_load(&c->owned))
+      threads++;
+  }
+
+  uv_mutex_lock(&arena_pool.lock);
+  uint32_t cached = arena_pool.cached;
+  uint32_t total = atomic_load(&arena_pool.total_allocated);
+  uint32_t outstanding = total > cached ? total - cached : 0;
+  double cached_mb = (cached * ARENA_REGION_SIZE) / (1024.0 * 1024.0);
+  double total_mb = (total * ARENA_REGION_SIZE) / (1024.0 * 1024.0);
 
   LOG_DEBUG("Arena Pool Statistics:");
-  LOG_DEBUG("  Cached: %u/%u arenas (%.2f MB)",
-            available, arena_pool.pool_capacity, available_mb);
-  LOG_DEBUG("  In use: %u arenas", in_use);
-  LOG_DEBUG("  Peak usage: %u arenas", arena_pool.peak_usage);
+  LOG_DEBUG("  Depot: %u/%u arenas (%.2f MB)",
+            cached, arena_pool.capacity, cached_mb);
+  LOG_DEBUG("  Outstanding (in use or thread-cached): %u arenas", outstanding);
+  LOG_DEBUG("  Thread caches: %u", threads);
+  LOG_DEBUG("  Peak outstanding: %u arenas", arena_pool.peak_usage);
   LOG_DEBUG("  Total allocated: %.2f MB", total_mb);
-  LOG_DEBUG("  Grow operations: %u", arena_pool.grow_count);
+  LOG_DEBUG("  Grow operations: %u", atomic_load(&arena_pool.grow_count));
   LOG_DEBUG("  Shrink operations: %u", arena_pool.shrink_count);
+  uv_mutex_unlock(&arena_pool.lock);
 }
 
 #endif
@@ -97,16 +97,24 @@ void *ecewo_realloc(ecewo_arena_t *arena, void *oldptr, size_t oldsz, size_t new
   if (newsz <= oldsz)
     return oldptr;
 
+  // The last allocation grows in place while its region has room
+  arena_region_t *r = arena->end;
+  size_t old_words = (oldsz + sizeof(uintptr_t) - 1) / sizeof(uintptr_t);
+  size_t new_words = (newsz + sizeof(uintptr_t) - 1) / sizeof(uintptr_t);
+  if (oldptr && r && old_words <= r->count
+      && (uintptr_t *)oldptr == &r->data[r->count - old_words]
+      && r->count - old_words + new_words <= r->capacity) {
+    r->count = r->count - old_words + new_words;
+    return oldptr;
+  }
+
   void *newptr = ecewo_alloc(arena, newsz);
 
   if (!newptr)
     return NULL;
 
-  char *newptr_char = (char *)newptr;
-  char *oldptr_char = (char *)oldptr;
-  for (size_t i = 0; i < oldsz; ++i) {
-    newptr_char[i] = oldptr_char[i];
-  }
+  if (oldptr && oldsz > 0)
+    memcpy(newptr, oldptr, oldsz);
   return newptr;
 }
 
@@ -0,0 +1,479 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "file-cache.h"
+#include "logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#ifdef _WIN32
+#define strcasecmp _stricmp
+#else
+#include <strings.h>
+#endif
+
+// Open files and their stat results, shared by every loop. A hit costs a
+// hash lookup under the lock; the open() and stat() of a miss or of a stale
+// entry run outside it, and on the threadpool when they go through
+// file_cache_lookup() and file_cache_open(). Entries are refcounted so an
+// eviction never closes a file that a transfer is still reading; the last
+// release closes it.
+
+#define FILE_CACHE_BUCKETS (FILE_CACHE_SIZE * 2)
+
+static struct {
+  uv_mutex_t lock;
+  file_cache_entry_t *buckets[FILE_CACHE_BUCKETS];
+  file_cache_entry_t *lru_head; // most recently used
+  file_cache_entry_t *lru_tail;
+  size_t count;
+} file_cache;
+
+static uv_once_t file_cache_once = UV_ONCE_INIT;
+
+static void file_cache_init(void) {
+  if (uv_mutex_init(&file_cache.lock) != 0)
+    abort();
+}
+
+static uint64_t now_ms(void) {
+  return uv_hrtime() / 1000000ULL;
+}
+
+static uint32_t path_hash(const char *path) {
+  // FNV-1a
+  uint32_t h = 2166136261u;
+  for (const unsigned char *p = (const unsigned char *)path; *p; p++) {
+    h ^= *p;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static const struct {
+  const char *ext;
+  const char *type;
+} mime_types[] = {
+  { "html", "text/html; charset=utf-8" },
+  { "htm", "text/html; charset=utf-8" },
+  { "css", "text/css; charset=utf-8" },
+  { "js", "text/javascript; charset=utf-8" },
+  { "mjs", "text/javascript; charset=utf-8" },
+  { "json", "application/json" },
+  { "map", "application/json" },
+  { "txt", "text/plain; charset=utf-8" },
+  { "xml", "application/xml" },
+  { "svg", "image/svg+xml" },
+  { "png", "image/png" },
+  { "jpg", "image/jpeg" },
+  { "jpeg", "image/jpeg" },
+  { "gif", "image/gif" },
+  { "webp", "image/webp" },
+  { "avif", "image/avif" },
+  { "ico", "image/x-icon" },
+  { "woff", "font/woff" },
+  { "woff2", "font/woff2" },
+  { "ttf", "font/ttf" },
+  { "wasm", "application/wasm" },
+  { "pdf", "application/pdf" },
+  { "mp4", "video/mp4" },
+  { "webm", "video/webm" },
+  { "mp3", "audio/mpeg" },
+  { "zip", "application/zip" },
+  { "gz", "application/gzip" },
+};
+
+static const char *content_type_for(const char *path) {
+  const char *slash = strrchr(path, '/');
+  const char *dot = strrchr(slash ? slash : path, '.');
+  if (dot) {
+    for (size_t i = 0; i < sizeof(mime_types) / sizeof(mime_types[0]); i++) {
+      if (strcasecmp(dot + 1, mime_types[i].ext) == 0)
+        return mime_types[i].type;
+    }
+  }
+  return "application/octet-stream";
+}
+
+static bool same_file(const file_cache_entry_t *entry, const uv_stat_t *st) {
+  return entry->dev == st->st_dev
+      && entry->ino == st->st_ino
+      && entry->size == st->st_size
+      && entry->mtime.tv_sec == st->st_mtim.tv_sec
+      && entry->mtime.tv_nsec == st->st_mtim.tv_nsec;
+}
+
+static void close_entry(file_cache_entry_t *entry) {
+  uv_fs_t req;
+  uv_fs_close(NULL, &req, entry->fd, NULL);
+  uv_fs_req_cleanup(&req);
+  free(entry->path);
+  free(entry);
+}
+
+// Opens path and fills a new entry, refcount 1 for the caller.
+static file_cache_entry_t *open_entry(const char *path, uint32_t hash) {
+  uv_fs_t req;
+  int fd = uv_fs_open(NULL, &req, path, UV_FS_O_RDONLY, 0, NULL);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0)
+    return NULL;
+
+  int r = uv_fs_fstat(NULL, &req, fd, NULL);
+  uv_stat_t st = req.statbuf;
+  uv_fs_req_cleanup(&req);
+
+  // Directories, devices and pipes are never served
+  if (r < 0 || (st.st_mode & S_IFMT) != S_IFREG) {
+    uv_fs_close(NULL, &req, fd, NULL);
+    uv_fs_req_cleanup(&req);
+    return NULL;
+  }
+
+  file_cache_entry_t *entry = calloc(1, sizeof(file_cache_entry_t));
+  char *copy = entry ? strdup(path) : NULL;
+  if (!copy) {
+    free(entry);
+    uv_fs_close(NULL, &req, fd, NULL);
+    uv_fs_req_cleanup(&req);
+    return NULL;
+  }
+
+  entry->path = copy;
+  entry->fd = fd;
+  entry->size = st.st_size;
+  entry->dev = st.st_dev;
+  entry->ino = st.st_ino;
+  entry->mtime = st.st_mtim;
+  entry->content_type = content_type_for(path);
+  entry->validated_at = now_ms();
+  entry->hash = hash;
+  entry->refcount = 1;
+
+  snprintf(entry->etag, sizeof(entry->etag), "\"%" PRIx64 "-%" PRIx64 "\"",
+           (uint64_t)st.st_mtim.tv_sec, st.st_size);
+
+  time_t mtime = (time_t)st.st_mtim.tv_sec;
+  struct tm gmt;
+#ifdef _WIN32
+  gmtime_s(&gmt, &mtime);
+#else
+  gmtime_r(&mtime, &gmt);
+#endif
+  strftime(entry->last_modified, sizeof(entry->last_modified),
+           "%a, %d %b %Y %H:%M:%S GMT", &gmt);
+
+  return entry;
+}
+
+// ----- list helpers; all called with the lock held -----
+
+static file_cache_entry_t *lookup_locked(const char *path, uint32_t hash) {
+  file_cache_entry_t *entry = file_cache.buckets[hash % FILE_CACHE_BUCKETS];
+  while (entry && (entry->hash != hash || strcmp(entry->path, path) != 0))
+    entry = entry->hash_next;
+  return entry;
+}
+
+static void lru_unlink_locked(file_cache_entry_t *entry) {
+  if (entry->lru_prev)
+    entry->lru_prev->lru_next = entry->lru_next;
+  else
+    file_cache.lru_head = entry->lru_next;
+
+  if (entry->lru_next)
+    entry->lru_next->lru_prev = entry->lru_prev;
+  else
+    file_cache.lru_tail = entry->lru_prev;
+
+  entry->lru_prev = NULL;
+  entry->lru_next = NULL;
+}
+
+static void lru_push_front_locked(file_cache_entry_t *entry) {
+  entry->lru_prev = NULL;
+  entry->lru_next = file_cache.lru_head;
+  if (file_cache.lru_head)
+    file_cache.lru_head->lru_prev = entry;
+  file_cache.lru_head = entry;
+  if (!file_cache.lru_tail)
+    file_cache.lru_tail = entry;
+}
+
+// Drops the cache's reference. Returns the entry if that was the last one,
+// so the caller can close it after unlocking.
+static file_cache_entry_t *remove_locked(file_cache_entry_t *entry) {
+  file_cache_entry_t **link = &file_cache.buckets[entry->hash % FILE_CACHE_BUCKETS];
+  while (*link != entry)
+    link = &(*link)->hash_next;
+  *link = entry->hash_next;
+  entry->hash_next = NULL;
+
+  lru_unlink_locked(entry);
+  file_cache.count--;
+
+  return --entry->refcount == 0 ? entry : NULL;
+}
+
+static file_cache_entry_t *insert_locked(file_cache_entry_t *entry) {
+  size_t bucket = entry->hash % FILE_CACHE_BUCKETS;
+  entry->hash_next = file_cache.buckets[bucket];
+  file_cache.buckets[bucket] = entry;
+  entry->refcount++;
+  lru_push_front_locked(entry);
+  file_cache.count++;
+
+  if (file_cache.count > FILE_CACHE_SIZE)
+    return remove_locked(file_cache.lru_tail);
+  return NULL;
+}
+
+// ----- public -----
+
+file_cache_entry_t *file_cache_acquire(const char *path) {
+  if (!path || !*path)
+    return NULL;
+
+  uv_once(&file_cache_once, file_cache_init);
+
+  uint32_t hash = path_hash(path);
+  uint64_t now = now_ms();
+
+  bool fresh = false;
+  uv_mutex_lock(&file_cache.lock);
+  file_cache_entry_t *entry = lookup_locked(path, hash);
+  if (entry) {
+    entry->refcount++;
+    lru_unlink_locked(entry);
+    lru_push_front_locked(entry);
+    fresh = now - entry->validated_at < FILE_CACHE_VALID_MS;
+  }
+  uv_mutex_unlock(&file_cache.lock);
+
+  if (fresh)
+    return entry;
+
+  if (entry) {
+    // Stale: still the same file on disk?
+    uv_fs_t req;
+    int r = uv_fs_stat(NULL, &req, path, NULL);
+    bool unchanged = (r == 0 && same_file(entry, &req.statbuf));
+    uv_fs_req_cleanup(&req);
+
+    if (unchanged) {
+      uv_mutex_lock(&file_cache.lock);
+      entry->validated_at = now;
+      uv_mutex_unlock(&file_cache.lock);
+      return entry;
+    }
+
+    file_cache_entry_t *dead = NULL;
+    uv_mutex_lock(&file_cache.lock);
+    if (lookup_locked(path, hash) == entry)
+      dead = remove_locked(entry);
+    uv_mutex_unlock(&file_cache.lock);
+    if (dead)
+      close_entry(dead);
+    file_cache_release(entry);
+  }
+
+  entry = open_entry(path, hash);
+  if (!entry)
+    return NULL;
+
+  file_cache_entry_t *evicted = NULL;
+  uv_mutex_lock(&file_cache.lock);
+  file_cache_entry_t *raced = lookup_locked(path, hash);
+  if (raced)
+    raced->refcount++; // another thread opened it meanwhile; use theirs
+  else
+    evicted = insert_locked(entry);
+  uv_mutex_unlock(&file_cache.lock);
+
+  if (evicted)
+    close_entry(evicted);
+  if (raced) {
+    close_entry(entry);
+    return raced;
+  }
+
+  return entry;
+}
+
+typedef struct {
+  uv_fs_t req;
+  file_cache_entry_t *entry;
+} revalidate_t;
+
+static void on_revalidated(uv_fs_t *req) {
+  revalidate_t *rv = (revalidate_t *)req;
+  file_cache_entry_t *entry = rv->entry;
+  bool unchanged = req->result == 0 && same_file(entry, &req->statbuf);
+  uv_fs_req_cleanup(req);
+
+  file_cache_entry_t *dead = NULL;
+  uv_mutex_lock(&file_cache.lock);
+  entry->revalidating = false;
+  if (unchanged)
+    entry->validated_at = now_ms();
+  else if (lookup_locked(entry->path, entry->hash) == entry)
+    dead = remove_locked(entry);
+  uv_mutex_unlock(&file_cache.lock);
+
+  if (dead)
+    close_entry(dead);
+  file_cache_release(entry);
+  free(rv);
+}
+
+file_cache_entry_t *file_cache_lookup(uv_loop_t *loop, const char *path) {
+  if (!path || !*path)
+    return NULL;
+
+  uv_once(&file_cache_once, file_cache_init);
+
+  uint32_t hash = path_hash(path);
+  bool revalidate = false;
+
+  uv_mutex_lock(&file_cache.lock);
+  file_cache_entry_t *entry = lookup_locked(path, hash);
+  if (entry) {
+    // One for the caller, and one for the stat if it is queued
+    entry->refcount++;
+    lru_unlink_locked(entry);
+    lru_push_front_locked(entry);
+    if (!entry->revalidating && now_ms() - entry->validated_at >= FILE_CACHE_VALID_MS) {
+      entry->revalidating = true;
+      entry->refcount++;
+      revalidate = true;
+    }
+  }
+  uv_mutex_unlock(&file_cache.lock);
+
+  if (!revalidate)
+    return entry;
+
+  // Freed in on_revalidated
+  revalidate_t *rv = malloc(sizeof(revalidate_t));
+  if (rv) {
+    rv->entry = entry;
+    if (uv_fs_stat(loop, &rv->req, entry->path, on_revalidated) == 0)
+      return entry;
+    free(rv);
+  }
+
+  // Tried again by the next lookup
+  uv_mutex_lock(&file_cache.lock);
+  entry->revalidating = false;
+  entry->refcount--;
+  uv_mutex_unlock(&file_cache.lock);
+  return entry;
+}
+
+typedef struct {
+  uv_work_t req;
+  char *path;
+  file_cache_entry_t *entry;
+  file_cache_open_cb cb;
+  void *data;
+} open_work_t;
+
+static void open_work(uv_work_t *req) {
+  open_work_t *work = (open_work_t *)req;
+  work->entry = file_cache_acquire(work->path);
+}
+
+static void open_done(uv_work_t *req, int status) {
+  open_work_t *work = (open_work_t *)req;
+
+  // Cancelled only while the loop is being torn down
+  if (status < 0) {
+    file_cache_release(work->entry);
+    work->entry = NULL;
+  }
+
+  work->cb(work->entry, work->data);
+  free(work->path);
+  free(work);
+}
+
+int file_cache_open(uv_loop_t *loop, const char *path, file_cache_open_cb cb, void *data) {
+  if (!loop || !path || !cb)
+    return -1;
+
+  // Freed in open_done
+  open_work_t *work = calloc(1, sizeof(open_work_t));
+  char *copy = work ? strdup(path) : NULL;
+  if (!copy) {
+    free(work);
+    return -1;
+  }
+
+  work->path = copy;
+  work->cb = cb;
+  work->data = data;
+
+  if (uv_queue_work(loop, &work->req, open_work, open_done) != 0) {
+    free(copy);
+    free(work);
+    return -1;
+  }
+  return 0;
+}
+
+void file_cache_release(file_cache_entry_t *entry) {
+  if (!entry)
+    return;
+
+  uv_mutex_lock(&file_cache.lock);
+  bool last = (--entry->refcount == 0);
+  uv_mutex_unlock(&file_cache.lock);
+
+  if (last)
+    close_entry(entry);
+}
+
+void file_cache_destroy(void) {
+  uv_once(&file_cache_once, file_cache_init);
+
+  uv_mutex_lock(&file_cache.lock);
+  file_cache_entry_t *dead = NULL;
+  while (file_cache.lru_head) {
+    file_cache_entry_t *entry = remove_locked(file_cache.lru_head);
+    if (entry) {
+      entry->hash_next = dead;
+      dead = entry;
+    }
+  }
+  uv_mutex_unlock(&file_cache.lock);
+
+  while (dead) {
+    file_cache_entry_t *next = dead->hash_next;
+    close_entry(dead);
+    dead = next;
+  }
+
+  LOG_DEBUG("File cache destroyed");
+}
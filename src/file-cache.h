@@ -0,0 +1,85 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ECEWO_FILE_CACHE_H
+#define ECEWO_FILE_CACHE_H
+
+#include "uv.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Open files kept around for ecewo_send_file(), least recently used first out
+#ifndef FILE_CACHE_SIZE
+#define FILE_CACHE_SIZE 256
+#endif
+
+// How long a cached stat is trusted before the path is looked at again (ms)
+#ifndef FILE_CACHE_VALID_MS
+#define FILE_CACHE_VALID_MS 2000
+#endif
+
+typedef struct file_cache_entry_s file_cache_entry_t;
+
+struct file_cache_entry_s {
+  char *path;
+  uv_file fd;
+  uint64_t size;
+  uint64_t dev;
+  uint64_t ino;
+  uv_timespec_t mtime;
+  const char *content_type;
+  char etag[48]; // "<mtime hex>-<size hex>", quoted
+  char last_modified[32];
+
+  uint64_t validated_at; // uv_hrtime() in ms of the last stat
+  bool revalidating; // a stat queued by file_cache_lookup() hasn't finished
+  uint32_t hash;
+  int refcount; // one for the cache itself while linked, one per user
+  file_cache_entry_t *hash_next;
+  file_cache_entry_t *lru_prev;
+  file_cache_entry_t *lru_next;
+};
+
+// Returns an open regular file for path, or NULL if it is missing, not a
+// regular file or can't be opened. Release it with file_cache_release().
+// Safe to call from any thread. A miss or a stale entry blocks on open()
+// and stat().
+file_cache_entry_t *file_cache_acquire(const char *path);
+void file_cache_release(file_cache_entry_t *entry);
+
+// The cached entry for path without touching the disk, or NULL if there is
+// none. A stale entry is still returned while its stat is redone on loop's
+// threadpool; a file that changed is dropped then, and the next lookup
+// misses.
+file_cache_entry_t *file_cache_lookup(uv_loop_t *loop, const char *path);
+
+typedef void (*file_cache_open_cb)(file_cache_entry_t *entry, void *data);
+
+// file_cache_acquire() on loop's threadpool. cb runs on the loop's thread
+// with the entry, or NULL if path can't be served. Returns -1 if the work
+// can't be queued; cb is not called then.
+int file_cache_open(uv_loop_t *loop, const char *path, file_cache_open_cb cb, void *data);
+
+// Closes every file the cache holds. Entries still acquired are closed on
+// their last release.
+void file_cache_destroy(void);
+
+#endif
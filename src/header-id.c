@@ -0,0 +1,95 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "header-id.h"
+
+#define HEADER_ID_SLOTS 64
+
+typedef struct {
+  const char *name; // lowercase
+  size_t len;
+  ecewo_header_id_t id;
+} header_id_entry_t;
+
+// Perfect hash of the names below. Adding a name means picking new
+// multipliers if it collides.
+static inline unsigned header_id_hash(unsigned char first, unsigned char last, size_t len) {
+  return ((unsigned)len + first * 31u + last * 37u) & (HEADER_ID_SLOTS - 1);
+}
+
+static const header_id_entry_t header_id_table[HEADER_ID_SLOTS] = {
+  [0] = { "transfer-encoding", 17, ECEWO_HDR_TRANSFER_ENCODING },
+  [1] = { "x-real-ip", 9, ECEWO_HDR_X_REAL_IP },
+  [5] = { "expect", 6, ECEWO_HDR_EXPECT },
+  [7] = { "if-match", 8, ECEWO_HDR_IF_MATCH },
+  [8] = { "x-request-id", 12, ECEWO_HDR_X_REQUEST_ID },
+  [9] = { "accept", 6, ECEWO_HDR_ACCEPT },
+  [11] = { "upgrade", 7, ECEWO_HDR_UPGRADE },
+  [12] = { "if-none-match", 13, ECEWO_HDR_IF_NONE_MATCH },
+  [15] = { "referer", 7, ECEWO_HDR_REFERER },
+  [16] = { "access-control-request-method", 29, ECEWO_HDR_ACCESS_CONTROL_REQUEST_METHOD },
+  [17] = { "x-forwarded-for", 15, ECEWO_HDR_X_FORWARDED_FOR },
+  [19] = { "content-length", 14, ECEWO_HDR_CONTENT_LENGTH },
+  [23] = { "forwarded", 9, ECEWO_HDR_FORWARDED },
+  [24] = { "if-range", 8, ECEWO_HDR_IF_RANGE },
+  [28] = { "cookie", 6, ECEWO_HDR_COOKIE },
+  [29] = { "origin", 6, ECEWO_HDR_ORIGIN },
+  [31] = { "sec-websocket-protocol", 22, ECEWO_HDR_SEC_WEBSOCKET_PROTOCOL },
+  [32] = { "host", 4, ECEWO_HDR_HOST },
+  [33] = { "if-modified-since", 17, ECEWO_HDR_IF_MODIFIED_SINCE },
+  [34] = { "content-type", 12, ECEWO_HDR_CONTENT_TYPE },
+  [35] = { "if-unmodified-since", 19, ECEWO_HDR_IF_UNMODIFIED_SINCE },
+  [36] = { "x-forwarded-proto", 17, ECEWO_HDR_X_FORWARDED_PROTO },
+  [38] = { "cache-control", 13, ECEWO_HDR_CACHE_CONTROL },
+  [39] = { "accept-language", 15, ECEWO_HDR_ACCEPT_LANGUAGE },
+  [40] = { "sec-websocket-version", 21, ECEWO_HDR_SEC_WEBSOCKET_VERSION },
+  [44] = { "range", 5, ECEWO_HDR_RANGE },
+  [45] = { "connection", 10, ECEWO_HDR_CONNECTION },
+  [48] = { "content-encoding", 16, ECEWO_HDR_CONTENT_ENCODING },
+  [49] = { "accept-encoding", 15, ECEWO_HDR_ACCEPT_ENCODING },
+  [50] = { "authorization", 13, ECEWO_HDR_AUTHORIZATION },
+  [57] = { "user-agent", 10, ECEWO_HDR_USER_AGENT },
+  [59] = { "sec-websocket-key", 17, ECEWO_HDR_SEC_WEBSOCKET_KEY },
+  [60] = { "access-control-request-headers", 30, ECEWO_HDR_ACCESS_CONTROL_REQUEST_HEADERS },
+};
+
+static inline unsigned char ascii_lower(unsigned char c) {
+  return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + ('a' - 'A')) : c;
+}
+
+int header_id_lookup(const char *name, size_t len) {
+  if (!name || len == 0)
+    return -1;
+
+  unsigned char first = ascii_lower((unsigned char)name[0]);
+  unsigned char last = ascii_lower((unsigned char)name[len - 1]);
+  const header_id_entry_t *entry = &header_id_table[header_id_hash(first, last, len)];
+
+  if (!entry->name || entry->len != len)
+    return -1;
+
+  for (size_t i = 0; i < len; i++) {
+    if (ascii_lower((unsigned char)name[i]) != (unsigned char)entry->name[i])
+      return -1;
+  }
+
+  return (int)entry->id;
+}
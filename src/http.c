@@ -23,6 +23,8 @@
 #include <limits.h>
 #include <ctype.h>
 #include "http.h"
+#include "header-id.h"
+#include "scan.h"
 #include "request.h"
 #include "utils.h"
 #include "logger.h"
@@ -100,34 +102,37 @@ static int ensure_buffer_capacity(ecewo_arena_t *arena, char **buffer, size_t *c
   return 0;
 }
 
-static void parse_query(ecewo_arena_t *arena, const char *query_start, size_t query_len, ecewo__req_t *query) {
-  if (!arena || !query)
-    return;
+ecewo__req_t *http_parse_query(ecewo_arena_t *arena, const char *query_start, size_t query_len) {
+  if (!arena)
+    return NULL;
+
+  ecewo__req_t *query = ecewo_alloc(arena, sizeof(ecewo__req_t));
+  if (!query)
+    return NULL;
 
   memset(query, 0, sizeof(ecewo__req_t));
 
   if (!query_start || query_len == 0)
-    return;
+    return query;
+
+  const char *end = query_start + query_len;
 
   int param_count = 1;
-  for (size_t i = 0; i < query_len; i++) {
-    if (query_start[i] == '&') {
-      if (++param_count > MAX_QUERY_PARAMS) {
-        param_count = MAX_QUERY_PARAMS;
-        break;
-      }
+  for (const char *amp = memchr(query_start, '&', query_len); amp;
+       amp = memchr(amp + 1, '&', (size_t)(end - amp - 1))) {
+    if (++param_count > MAX_QUERY_PARAMS) {
+      param_count = MAX_QUERY_PARAMS;
+      break;
     }
   }
 
   query->capacity = param_count;
   query->items = ecewo_alloc(arena, query->capacity * sizeof(ecewo__req_item_t));
-  if (!query->items) {
-    query->capacity = 0;
-    return;
-  }
+  if (!query->items)
+    return NULL;
+  memset(query->items, 0, query->capacity * sizeof(ecewo__req_item_t));
 
   const char *p = query_start;
-  const char *end = query_start + query_len;
 
   while (p < end && query->count < query->capacity) {
     const char *key_start = p;
@@ -135,13 +140,12 @@ static void parse_query(ecewo_arena_t *arena, const char *query_start, size_t qu
     const char *amp = NULL;
 
     // Find = and &
-    for (const char *s = p; s < end; s++) {
-      if (*s == '=' && !eq)
-        eq = s;
-      if (*s == '&') {
-        amp = s;
-        break;
-      }
+    const char *delim = scan_find2(p, end, '=', '&');
+    if (delim < end && *delim == '=') {
+      eq = delim;
+      amp = memchr(eq + 1, '&', (size_t)(end - eq - 1));
+    } else if (delim < end) {
+      amp = delim;
     }
 
     const char *pair_end = amp ? amp : end;
@@ -176,6 +180,8 @@ static void parse_query(ecewo_arena_t *arena, const char *query_start, size_t qu
 
     p = amp ? amp + 1 : end;
   }
+
+  return query;
 }
 
 int on_url_cb(llhttp_t *parser, const char *at, size_t length) {
@@ -211,26 +217,68 @@ int on_url_cb(llhttp_t *parser, const char *at, size_t length) {
   return HPE_OK;
 }
 
+// Writes the NUL after the last header's value. A borrowed value is followed
+// by its CR, which the parser has already passed over.
+static void finish_header_value(http_context_t *context) {
+  if (!context->header_value_open)
+    return;
+
+  ecewo__req_item_t *item = &context->headers.items[context->headers.count - 1];
+  ((char *)item->value)[item->value_len] = '\0';
+  context->header_value_open = false;
+}
+
+// Appends to an arena-owned string of length len, keeping it NUL-terminated
+static char *append_copy(ecewo_arena_t *arena, const char *str, size_t len, const char *at, size_t length) {
+  char *grown = ecewo_alloc(arena, len + length + 1);
+  if (!grown)
+    return NULL;
+
+  memcpy(grown, str, len);
+  memcpy(grown + len, at, length);
+  grown[len + length] = '\0';
+  return grown;
+}
+
 int on_header_field_cb(llhttp_t *parser, const char *at, size_t length) {
   if (!parser || !parser->data || !at || length == 0)
     return HPE_INTERNAL;
 
   http_context_t *context = (http_context_t *)parser->data;
 
-  if (context->headers.count >= MAX_HEADERS_COUNT) {
-    llhttp_set_error_reason(parser, ERROR_REASON_TOO_MANY_HEADERS);
-    return HPE_USER;
+  // A new name, unless this continues one cut off at the end of a read
+  if (context->header_value_open || context->header_field_length == 0) {
+    finish_header_value(context);
+
+    if (context->headers.count >= MAX_HEADERS_COUNT) {
+      llhttp_set_error_reason(parser, ERROR_REASON_TOO_MANY_HEADERS);
+      return HPE_USER;
+    }
+
+    if (length > MAX_HEADER_SIZE) {
+      llhttp_set_error_reason(parser, ERROR_REASON_HEADER_TOO_LARGE);
+      return HPE_USER;
+    }
+
+    context->header_field = at;
+    context->header_field_length = length;
+    return HPE_OK;
   }
 
-  if (length > MAX_HEADER_SIZE) {
+  size_t total = context->header_field_length + length;
+  if (total > MAX_HEADER_SIZE) {
     llhttp_set_error_reason(parser, ERROR_REASON_HEADER_TOO_LARGE);
     return HPE_USER;
   }
 
-  context->header_field_length = 0;
+  bool borrowed = context->header_field != context->current_header_field;
+  if (borrowed && at == context->header_field + context->header_field_length) {
+    context->header_field_length = total;
+    return HPE_OK;
+  }
 
   int result = ensure_buffer_capacity(context->arena, &context->current_header_field,
-                                      &context->header_field_capacity, 0, length);
+                                      &context->header_field_capacity, 0, total);
   if (result == -2) {
     llhttp_set_error_reason(parser, ERROR_REASON_HEADER_TOO_LARGE);
     return HPE_USER;
@@ -241,9 +289,12 @@ int on_header_field_cb(llhttp_t *parser, const char *at, size_t length) {
     return HPE_INTERNAL;
   }
 
-  memmove(context->current_header_field, at, length);
-  context->header_field_length = length;
-  context->current_header_field[length] = '\0';
+  if (borrowed)
+    memcpy(context->current_header_field, context->header_field, context->header_field_length);
+  memcpy(context->current_header_field + context->header_field_length, at, length);
+  context->current_header_field[total] = '\0';
+  context->header_field = context->current_header_field;
+  context->header_field_length = total;
 
   return HPE_OK;
 }
@@ -273,10 +324,7 @@ int ensure_array_capacity(ecewo_arena_t *arena, ecewo__req_t *array) {
   if (!new_items)
     return -1;
 
-  for (int i = array->capacity; i < new_capacity; i++) {
-    new_items[i].key = NULL;
-    new_items[i].value = NULL;
-  }
+  memset(&new_items[array->capacity], 0, (size_t)(new_capacity - array->capacity) * sizeof(ecewo__req_item_t));
 
   array->items = new_items;
   array->capacity = new_capacity;
@@ -289,6 +337,27 @@ int on_header_value_cb(llhttp_t *parser, const char *at, size_t length) {
 
   http_context_t *context = (http_context_t *)parser->data;
 
+  // The rest of a value cut off at the end of a read
+  if (context->header_value_open) {
+    uint16_t last = context->headers.count - 1;
+    ecewo__req_item_t *item = &context->headers.items[last];
+
+    if (last >= context->header_views && at == item->value + item->value_len) {
+      item->value_len += length;
+      return HPE_OK;
+    }
+
+    char *val = append_copy(context->arena, item->value, item->value_len, at, length);
+    if (!val) {
+      llhttp_set_error_reason(parser, ERROR_REASON_MEMORY_ALLOCATION);
+      return HPE_INTERNAL;
+    }
+
+    item->value = val;
+    item->value_len += length;
+    return HPE_OK;
+  }
+
   if (context->header_field_length == 0) {
     llhttp_set_error_reason(parser, ERROR_REASON_INVALID_HEADER_FIELD);
     return HPE_USER;
@@ -299,37 +368,124 @@ int on_header_value_cb(llhttp_t *parser, const char *at, size_t length) {
     return HPE_INTERNAL;
   }
 
-  char *key = ecewo_alloc(context->arena, context->header_field_length + 1);
-  if (!key) {
-    llhttp_set_error_reason(parser, ERROR_REASON_MEMORY_ALLOCATION);
-    return HPE_INTERNAL;
+  const char *key = context->header_field;
+  size_t key_len = context->header_field_length;
+
+  if (key == context->current_header_field) {
+    // The name spanned two reads; current_header_field is reused for the next one
+    key = append_copy(context->arena, "", 0, key, key_len);
+    if (!key) {
+      llhttp_set_error_reason(parser, ERROR_REASON_MEMORY_ALLOCATION);
+      return HPE_INTERNAL;
+    }
+  } else {
+    // Overwrites the ':' the parser has already passed over
+    ((char *)key)[key_len] = '\0';
   }
 
-  memcpy(key, context->current_header_field, context->header_field_length);
-  key[context->header_field_length] = '\0';
+  ecewo__req_item_t *item = &context->headers.items[context->headers.count];
+  item->key = key;
+  item->key_len = (uint32_t)key_len;
+  item->value = at;
+  item->value_len = (uint32_t)length;
+  context->headers.count++;
+
+  int id = header_id_lookup(key, key_len);
+  if (id >= 0 && context->header_index[id] == 0)
+    context->header_index[id] = (uint8_t)context->headers.count;
 
-  // Header field names are case-insensitive.
-  // Normalize once here so lookups can use strcmp instead of strcasecmp.
-  for (size_t i = 0; i < context->header_field_length; i++) {
-    unsigned char c = (unsigned char)key[i];
-    if (c >= 'A' && c <= 'Z')
-      key[i] = (char)(c + ('a' - 'A'));
+  context->header_field_length = 0;
+  context->header_value_open = true;
+
+  return HPE_OK;
+}
+
+bool http_headers_borrowed(const http_context_t *context) {
+  if (!context)
+    return false;
+
+  bool field_borrowed = context->header_field_length > 0
+      && context->header_field != context->current_header_field;
+
+  return context->header_views < context->headers.count || field_borrowed
+      || context->body_borrowed;
+}
+
+int http_headers_copy(http_context_t *context) {
+  if (!context || context->body_borrowed)
+    return -1;
+
+  for (uint16_t i = context->header_views; i < context->headers.count; i++) {
+    ecewo__req_item_t *item = &context->headers.items[i];
+
+    char *key = append_copy(context->arena, "", 0, item->key, item->key_len);
+    char *val = append_copy(context->arena, "", 0, item->value, item->value_len);
+    if (!key || !val)
+      return -1;
+
+    item->key = key;
+    item->value = val;
+  }
+  context->header_views = context->headers.count;
+
+  if (context->header_field_length > 0 && context->header_field != context->current_header_field) {
+    int result = ensure_buffer_capacity(context->arena, &context->current_header_field,
+                                        &context->header_field_capacity, 0,
+                                        context->header_field_length);
+    if (result != 0)
+      return -1;
+
+    memcpy(context->current_header_field, context->header_field, context->header_field_length);
+    context->current_header_field[context->header_field_length] = '\0';
+    context->header_field = context->current_header_field;
   }
 
-  char *val = ecewo_alloc(context->arena, length + 1);
-  if (!val) {
-    llhttp_set_error_reason(parser, ERROR_REASON_MEMORY_ALLOCATION);
-    return HPE_INTERNAL;
+  return 0;
+}
+
+void http_headers_adopt(http_context_t *context) {
+  if (!context)
+    return;
+  context->header_views = context->headers.count;
+  context->body_borrowed = false;
+}
+
+static inline unsigned char ascii_lower(unsigned char c) {
+  return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + ('a' - 'A')) : c;
+}
+
+const char *http_header_by_id(const ecewo__req_t *headers, ecewo_header_id_t id) {
+  if (!headers || !headers->index || (unsigned)id >= ECEWO_HDR_COUNT)
+    return NULL;
+
+  uint8_t slot = headers->index[id];
+  return slot ? headers->items[slot - 1].value : NULL;
+}
+
+const char *http_header_find(const ecewo__req_t *headers, const char *name, size_t name_len) {
+  if (!headers || !headers->items || !name)
+    return NULL;
+
+  if (headers->index) {
+    int id = header_id_lookup(name, name_len);
+    if (id >= 0)
+      return http_header_by_id(headers, (ecewo_header_id_t)id);
   }
 
-  memcpy(val, at, length);
-  val[length] = '\0';
+  for (uint16_t i = 0; i < headers->count; i++) {
+    const ecewo__req_item_t *item = &headers->items[i];
+    if (!item->key || item->key_len != name_len)
+      continue;
 
-  context->headers.items[context->headers.count].key = key;
-  context->headers.items[context->headers.count].value = val;
-  context->headers.count++;
+    size_t j = 0;
+    while (j < name_len && ascii_lower((unsigned char)item->key[j]) == ascii_lower((unsigned char)name[j]))
+      j++;
 
-  return HPE_OK;
+    if (j == name_len)
+      return item->value;
+  }
+
+  return NULL;
 }
 
 int on_method_cb(llhttp_t *parser, const char *at, size_t length) {
@@ -385,6 +541,19 @@ int on_body_cb(llhttp_t *parser, const char *at, size_t length) {
     return HPE_OK;
   }
 
+  // The whole body is in the data http_parse_body() was given: leave it
+  // there. Its end is the end of that data, so the NUL goes into the spare
+  // byte past it rather than over a pipelined request.
+  if (context->body_length == 0 && !context->chunked && context->body_view_end
+      && length == context->content_length && at + length == context->body_view_end) {
+    context->body = (uint8_t *)at;
+    context->body_length = length;
+    context->body_capacity = length + 1;
+    context->body_borrowed = true;
+    context->body[length] = '\0';
+    return HPE_OK;
+  }
+
   if (context->body_length + length > BUFFERED_BODY_MAX_SIZE) {
     LOG_ERROR("Buffered body size limit exceeded: received %zu, limit %zu. Set BUFFERED_BODY_MAX_SIZE to increase the limit.",
               context->body_length + length, (size_t)BUFFERED_BODY_MAX_SIZE);
@@ -392,7 +561,16 @@ int on_body_cb(llhttp_t *parser, const char *at, size_t length) {
     return HPE_USER;
   }
 
-  // Default behavior: buffer in memory
+  // Default behavior: buffer in memory, sized once when the length is known
+  if (context->body_capacity == 0 && !context->body_too_large && context->content_length >= length) {
+    context->body = ecewo_alloc(context->arena, context->content_length + 1);
+    if (!context->body) {
+      llhttp_set_error_reason(parser, ERROR_REASON_MEMORY_ALLOCATION);
+      return HPE_INTERNAL;
+    }
+    context->body_capacity = context->content_length + 1;
+  }
+
   char *body_tmp = (char *)context->body;
   int result = ensure_buffer_capacity(context->arena,
                                       &body_tmp,
@@ -427,14 +605,21 @@ int on_headers_complete_cb(llhttp_t *parser) {
   context->http_minor = llhttp_get_http_minor(parser);
   context->keep_alive = llhttp_should_keep_alive(parser);
   context->headers_complete = 1;
+  finish_header_value(context);
+
+  // llhttp has already validated the framing headers; only a request whose
+  // Transfer-Encoding ends in chunked gets this far
+  context->chunked = (parser->flags & (F_CHUNKED | F_TRANSFER_ENCODING)) != 0;
+  context->content_length = (parser->flags & F_CONTENT_LENGTH) ? parser->content_length : 0;
+  context->body_too_large = context->chunked || context->content_length >= BUFFERED_BODY_MAX_SIZE;
 
-  // Parse path and query string
+  // Split off the query string; it is parsed on the first ecewo_query()
   if (context->url && context->url_length > 0) {
     const char *qmark = memchr(context->url, '?', context->url_length);
     if (qmark) {
       context->path_length = qmark - context->url;
-      size_t qlen = context->url_length - context->path_length - 1;
-      parse_query(context->arena, qmark + 1, qlen, &context->query_params);
+      context->query_string = qmark + 1;
+      context->query_length = context->url_length - context->path_length - 1;
       context->url[context->path_length] = '\0';
     } else {
       context->path_length = context->url_length;
@@ -454,7 +639,11 @@ int on_message_complete_cb(llhttp_t *parser) {
 
   http_context_t *context = (http_context_t *)parser->data;
   context->message_complete = 1;
-  return HPE_OK;
+  finish_header_value(context); // trailers
+
+  // Stop at the end of every message, so llhttp_get_error_pos() tells the
+  // router where a pipelined request behind this one starts.
+  return HPE_PAUSED;
 }
 
 void http_context_init(http_context_t *context,
@@ -484,12 +673,9 @@ void http_context_init(http_context_t *context,
   context->current_header_field = ecewo_alloc(arena, context->header_field_capacity);
   if (context->current_header_field)
     context->current_header_field[0] = '\0';
+  context->header_field = context->current_header_field;
 
-  context->body_capacity = 1024;
-  context->body = ecewo_alloc(arena, context->body_capacity);
-  if (context->body)
-    context->body[0] = '\0';
-
+  context->headers.index = context->header_index;
   context->headers.capacity = 32;
   context->headers.items = ecewo_alloc(arena, context->headers.capacity * sizeof(ecewo__req_item_t));
   if (context->headers.items)
@@ -517,6 +703,8 @@ parse_result_t http_parse_request(http_context_t *context, const char *data, siz
     return context->message_complete ? PARSE_SUCCESS : PARSE_INCOMPLETE;
 
   case HPE_PAUSED:
+    return context->message_complete ? PARSE_SUCCESS : PARSE_PAUSED;
+
   case HPE_PAUSED_UPGRADE:
     return PARSE_PAUSED;
 
@@ -529,6 +717,16 @@ parse_result_t http_parse_request(http_context_t *context, const char *data, siz
   }
 }
 
+parse_result_t http_parse_body(http_context_t *context, const char *data, size_t len) {
+  if (!context)
+    return PARSE_ERROR;
+
+  context->body_view_end = data + len;
+  parse_result_t result = http_parse_request(context, data, len);
+  context->body_view_end = NULL;
+  return result;
+}
+
 bool http_message_needs_eof(const http_context_t *context) {
   return context ? llhttp_message_needs_eof(context->parser) != 0 : false;
 }
@@ -31,7 +31,7 @@
 #endif
 
 typedef enum {
-  PARSE_SUCCESS = 0, // Fully parsed
+  PARSE_SUCCESS = 0, // Message complete; parser paused right after it
   PARSE_INCOMPLETE = 1, // Need more data
   PARSE_PAUSED = 2, // Paused at headers-complete
   PARSE_ERROR = -1, // Parse error occurred
@@ -58,6 +58,8 @@ typedef struct {
   size_t url_length;
   size_t url_capacity;
   size_t path_length;
+  const char *query_string; // after the '?' in url, NUL-terminated; not decoded
+  size_t query_length;
 
   char *method;
   size_t method_length;
@@ -65,13 +67,16 @@ typedef struct {
 
   // Headers
   ecewo__req_t headers;
-  ecewo__req_t query_params;
+  uint8_t header_index[ECEWO_HDR_COUNT]; // headers.index; MAX_HEADERS_COUNT fits in a byte
   ecewo__req_t url_params;
 
-  // Body (buffered)
+  // Body (buffered). Allocated at its Content-Length on the first chunk,
+  // or left in the caller's data by http_parse_body()
   uint8_t *body;
   size_t body_length;
   size_t body_capacity;
+  bool body_borrowed; // body points into the data passed to http_parse_body()
+  const char *body_view_end; // end of that data while http_parse_body() runs
 
   // HTTP version / state
   uint8_t http_major;
@@ -82,9 +87,19 @@ typedef struct {
   bool keep_alive;
   bool headers_complete;
 
-  char *current_header_field;
+  // Body framing, taken from the parser at headers-complete
+  uint64_t content_length; // 0 without a Content-Length header
+  bool chunked; // Transfer-Encoding; the length is unknown until the end
+  bool body_too_large; // can't be buffered; 413 unless the route streams it
+
+  // Name of the header being parsed: a view into the data passed to
+  // http_parse_request, or current_header_field once it spans two reads
+  const char *header_field;
   size_t header_field_length;
+  char *current_header_field;
   size_t header_field_capacity;
+  bool header_value_open; // the last header's value may still continue
+  uint16_t header_views; // headers.items[header_views..count) point into the caller's data
 
   llhttp_errno_t last_error;
   const char *error_reason;
@@ -97,7 +112,15 @@ typedef struct {
 } http_context_t;
 
 // Used in router.c
+// Header names and values are left pointing into data and NUL-terminated in
+// place, so it must be writable and outlive the request; see
+// http_headers_borrowed()
 parse_result_t http_parse_request(http_context_t *context, const char *data, size_t len);
+// The same for the rest of the read whose headers were just parsed. A
+// Content-Length body that runs to the end of data is left there, NUL-
+// terminated in the byte past len, which must be writable; it shares the
+// headers' lifetime, so http_headers_adopt() keeps it alive as well.
+parse_result_t http_parse_body(http_context_t *context, const char *data, size_t len);
 bool http_message_needs_eof(const http_context_t *context);
 parse_result_t http_finish_parsing(http_context_t *context);
 
@@ -117,6 +140,23 @@ int on_message_complete_cb(llhttp_t *parser);
 
 int ensure_array_capacity(ecewo_arena_t *arena, ecewo__req_t *array);
 
+// Splits and URL-decodes a query string (without the '?'); used in request.c
+ecewo__req_t *http_parse_query(ecewo_arena_t *arena, const char *query_start, size_t query_len);
+
+// Whether some header, or the body, still points into the data it was
+// parsed from
+bool http_headers_borrowed(const http_context_t *context);
+// Copies every borrowed header into the arena. Fails for a borrowed body,
+// which a request may already be holding; that data has to be adopted.
+int http_headers_copy(http_context_t *context);
+// Marks the borrowed headers and body as owned once the caller keeps their
+// data alive
+void http_headers_adopt(http_context_t *context);
+
+// Case-insensitive lookup; name need not be NUL-terminated
+const char *http_header_find(const ecewo__req_t *headers, const char *name, size_t name_len);
+const char *http_header_by_id(const ecewo__req_t *headers, ecewo_header_id_t id);
+
 // Utility function for debugging
 const char *parse_result_to_string(parse_result_t result);
 
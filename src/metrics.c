@@ -0,0 +1,257 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "metrics.h"
+#include "arena-internal.h"
+#include "server.h"
+#include "logger.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+metric_gauge_t metrics_spawn_queue_depth;
+
+static const uint64_t histogram_bounds[METRIC_HISTOGRAM_BUCKETS - 1] = METRIC_HISTOGRAM_BOUNDS;
+
+// Same bounds in seconds, as they appear in the "le" label
+static const char *const histogram_labels[METRIC_HISTOGRAM_BUCKETS] = {
+  "0.0005", "0.001", "0.0025", "0.005", "0.01", "0.025", "0.05",
+  "0.1", "0.25", "0.5", "1", "2.5", "5", "10", "+Inf"
+};
+
+static const char *const status_labels[METRIC_STATUS_CLASSES] = {
+  "other", "1xx", "2xx", "3xx", "4xx", "5xx"
+};
+
+void metric_histogram_observe(metric_histogram_t *h, uint64_t value_us) {
+  int i = 0;
+  while (i < METRIC_HISTOGRAM_BUCKETS - 1 && value_us > histogram_bounds[i])
+    i++;
+
+  atomic_fetch_add_explicit(&h->buckets[i], 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&h->sum_us, value_us, memory_order_relaxed);
+}
+
+static ecewo__metrics_t *client_metrics(ecewo_client_t *client) {
+  return client && client->worker ? &client->worker->metrics : NULL;
+}
+
+void metrics_response(ecewo_client_t *client, int status, size_t bytes) {
+  ecewo__metrics_t *m = client_metrics(client);
+  if (!m)
+    return;
+
+  int class = (status >= 100 && status < 600) ? status / 100 : 0;
+  metric_counter_add(&m->responses[class], 1);
+  metric_counter_add(&m->bytes_out, bytes);
+
+  // Informational replies come before the real one
+  if (client->request_start && class != 1) {
+    uint64_t elapsed_ns = uv_hrtime() - client->request_start;
+    metric_histogram_observe(&m->request_duration, elapsed_ns / 1000);
+    client->request_start = 0;
+  }
+}
+
+void metrics_bytes_out(ecewo_client_t *client, size_t bytes) {
+  ecewo__metrics_t *m = client_metrics(client);
+  if (m)
+    metric_counter_add(&m->bytes_out, bytes);
+}
+
+void metrics_parse_error(ecewo_client_t *client, int result) {
+  ecewo__metrics_t *m = client_metrics(client);
+  int index = -result - 1;
+  if (m && index >= 0 && index < METRIC_PARSE_ERRORS)
+    metric_counter_add(&m->parse_errors[index], 1);
+}
+
+// Everything below reads the registries while the workers keep updating
+// them, so a scrape is a close snapshot rather than an exact one.
+
+typedef struct {
+  char *data;
+  size_t cap;
+  size_t len; // keeps counting past cap so the caller learns the full size
+} metrics_buf_t;
+
+static void emit(metrics_buf_t *b, const char *fmt, ...) {
+  char *dst = b->len < b->cap ? b->data + b->len : NULL;
+  size_t room = b->len < b->cap ? b->cap - b->len : 0;
+
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(dst, room, fmt, args);
+  va_end(args);
+
+  if (n > 0)
+    b->len += (size_t)n;
+}
+
+static void emit_header(metrics_buf_t *b, const char *name, const char *type, const char *help) {
+  emit(b, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static void emit_value(metrics_buf_t *b, const char *name, const char *type,
+                       const char *help, uint64_t value) {
+  emit_header(b, name, type, help);
+  emit(b, "%s %" PRIu64 "\n", name, value);
+}
+
+static uint64_t load(const atomic_uint_fast64_t *v) {
+  return (uint64_t)atomic_load_explicit(v, memory_order_relaxed);
+}
+
+typedef struct {
+  uint64_t accepted;
+  uint64_t closed;
+  uint64_t responses[METRIC_STATUS_CLASSES];
+  uint64_t bytes_in;
+  uint64_t bytes_out;
+  uint64_t parse_errors[METRIC_PARSE_ERRORS];
+  uint64_t route_cache_hits;
+  uint64_t route_cache_misses;
+  uint64_t write_pool_hits;
+  uint64_t write_pool_misses;
+  uint64_t read_pool_hits;
+  uint64_t read_pool_misses;
+  uint64_t buckets[METRIC_HISTOGRAM_BUCKETS];
+  uint64_t sum_us;
+} metrics_snapshot_t;
+
+static void snapshot_add(metrics_snapshot_t *s, const ecewo__metrics_t *m) {
+  s->accepted += load(&m->connections_accepted.value);
+  s->closed += load(&m->connections_closed.value);
+  s->bytes_in += load(&m->bytes_in.value);
+  s->bytes_out += load(&m->bytes_out.value);
+  for (int i = 0; i < METRIC_STATUS_CLASSES; i++)
+    s->responses[i] += load(&m->responses[i].value);
+  for (int i = 0; i < METRIC_PARSE_ERRORS; i++)
+    s->parse_errors[i] += load(&m->parse_errors[i].value);
+  s->route_cache_hits += load(&m->route_cache_hits.value);
+  s->route_cache_misses += load(&m->route_cache_misses.value);
+  s->write_pool_hits += load(&m->write_pool_hits.value);
+  s->write_pool_misses += load(&m->write_pool_misses.value);
+  s->read_pool_hits += load(&m->read_pool_hits.value);
+  s->read_pool_misses += load(&m->read_pool_misses.value);
+  for (int i = 0; i < METRIC_HISTOGRAM_BUCKETS; i++)
+    s->buckets[i] += load(&m->request_duration.buckets[i]);
+  s->sum_us += load(&m->request_duration.sum_us);
+}
+
+size_t ecewo_metrics_render(ecewo_app_t *app, char *buf, size_t size) {
+  metrics_buf_t b = { buf, size, 0 };
+  if (buf && size > 0)
+    buf[0] = '\0';
+
+  metrics_snapshot_t sum = { 0 };
+  int active = 0;
+  uint64_t timeouts = 0;
+
+  ecewo__server_t *srv = app ? app->server : NULL;
+  if (srv) {
+    for (int i = 0; srv->workers && i < srv->worker_count; i++)
+      snapshot_add(&sum, &srv->workers[i].metrics);
+
+    active = atomic_load(&srv->active_connections);
+    timeouts = atomic_load(&srv->timeout_expirations);
+  }
+
+  emit_value(&b, "ecewo_connections_accepted_total", "counter",
+             "Connections accepted.", sum.accepted);
+  emit_value(&b, "ecewo_connections_closed_total", "counter",
+             "Connections closed.", sum.closed);
+  emit_value(&b, "ecewo_connections_active", "gauge",
+             "Connections currently open.", (uint64_t)(active > 0 ? active : 0));
+  emit_value(&b, "ecewo_timeouts_total", "counter",
+             "Connections closed by the idle or request timeout.", timeouts);
+
+  emit_header(&b, "ecewo_responses_total", "counter", "Responses sent, by status class.");
+  for (int c = 0; c < METRIC_STATUS_CLASSES; c++)
+    emit(&b, "ecewo_responses_total{class=\"%s\"} %" PRIu64 "\n",
+         status_labels[c], sum.responses[c]);
+
+  emit_value(&b, "ecewo_received_bytes_total", "counter",
+             "Bytes read from clients.", sum.bytes_in);
+  emit_value(&b, "ecewo_sent_bytes_total", "counter",
+             "Bytes of responses handed to the socket.", sum.bytes_out);
+
+  emit_header(&b, "ecewo_parse_errors_total", "counter", "Requests rejected by the HTTP parser.");
+  for (int e = 0; e < METRIC_PARSE_ERRORS; e++)
+    emit(&b, "ecewo_parse_errors_total{result=\"%s\"} %" PRIu64 "\n",
+         parse_result_to_string((parse_result_t)(-e - 1)), sum.parse_errors[e]);
+
+  emit_value(&b, "ecewo_route_cache_hits_total", "counter",
+             "Route lookups answered by the route cache.", sum.route_cache_hits);
+  emit_value(&b, "ecewo_route_cache_misses_total", "counter",
+             "Route lookups that had to walk the route table.", sum.route_cache_misses);
+  emit_value(&b, "ecewo_write_pool_hits_total", "counter",
+             "Write requests and output buffers reused from a worker's pool.", sum.write_pool_hits);
+  emit_value(&b, "ecewo_write_pool_misses_total", "counter",
+             "Write requests and output buffers that had to be allocated.", sum.write_pool_misses);
+  emit_value(&b, "ecewo_read_pool_hits_total", "counter",
+             "Read buffers reused from a worker's pool.", sum.read_pool_hits);
+  emit_value(&b, "ecewo_read_pool_misses_total", "counter",
+             "Read buffers that had to be allocated.", sum.read_pool_misses);
+
+  emit_header(&b, "ecewo_request_duration_seconds", "histogram",
+              "Time from the first byte of a request to its reply.");
+  uint64_t cumulative = 0;
+  for (int k = 0; k < METRIC_HISTOGRAM_BUCKETS; k++) {
+    cumulative += sum.buckets[k];
+    emit(&b, "ecewo_request_duration_seconds_bucket{le=\"%s\"} %" PRIu64 "\n",
+         histogram_labels[k], cumulative);
+  }
+  emit(&b, "ecewo_request_duration_seconds_sum %" PRIu64 ".%06" PRIu64 "\n",
+       sum.sum_us / 1000000, sum.sum_us % 1000000);
+  emit(&b, "ecewo_request_duration_seconds_count %" PRIu64 "\n", cumulative);
+
+  uint64_t hits = 0, misses = 0, live = 0;
+  arena_pool_counters(&hits, &misses, &live);
+  emit_value(&b, "ecewo_arena_pool_hits_total", "counter",
+             "Arena borrows served from a cache.", hits);
+  emit_value(&b, "ecewo_arena_pool_misses_total", "counter",
+             "Arena borrows that had to allocate.", misses);
+  emit_value(&b, "ecewo_arena_pool_arenas", "gauge",
+             "Arenas currently allocated.", live);
+
+  int_fast64_t queued = atomic_load_explicit(&metrics_spawn_queue_depth.value, memory_order_relaxed);
+  emit_value(&b, "ecewo_spawn_queue_depth", "gauge",
+             "ecewo_spawn() jobs queued or running.", (uint64_t)(queued > 0 ? queued : 0));
+
+  return b.len;
+}
+
+void ecewo_metrics_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  // Rendered on the stack; ecewo_send() copies it only if the socket
+  // can't take the whole reply right away
+  char buf[METRICS_BUFFER_SIZE];
+  size_t len = ecewo_metrics_render(ecewo_req_app(req), buf, sizeof(buf));
+
+  if (len >= sizeof(buf)) {
+    LOG_ERROR("Metrics exceed METRICS_BUFFER_SIZE (%zu bytes needed)", len + 1);
+    ecewo_send_text(res, 500, "Internal Server Error");
+    return;
+  }
+
+  ecewo_header_set(res, "Content-Type", "text/plain; version=0.0.4; charset=utf-8");
+  ecewo_send(res, 200, buf, len);
+}
@@ -0,0 +1,99 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ECEWO_METRICS_H
+#define ECEWO_METRICS_H
+
+#include "ecewo.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Size of the stack buffer ecewo_metrics_handler() renders into
+#ifndef METRICS_BUFFER_SIZE
+#define METRICS_BUFFER_SIZE 8192
+#endif
+
+// Every metric is a set of relaxed atomics. Each worker only updates its
+// own registry, so the cache lines stay local to one thread; readers sum
+// the workers while they keep running.
+
+typedef struct {
+  atomic_uint_fast64_t value;
+} metric_counter_t;
+
+typedef struct {
+  atomic_int_fast64_t value;
+} metric_gauge_t;
+
+// Upper bounds of the request duration buckets in microseconds; a final
+// +Inf bucket catches the rest
+#define METRIC_HISTOGRAM_BOUNDS \
+  { 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000 }
+#define METRIC_HISTOGRAM_BUCKETS 15
+
+typedef struct {
+  atomic_uint_fast64_t buckets[METRIC_HISTOGRAM_BUCKETS]; // not cumulative
+  atomic_uint_fast64_t sum_us;
+} metric_histogram_t;
+
+// Response status classes: [1] = 1xx ... [5] = 5xx, [0] = anything else
+#define METRIC_STATUS_CLASSES 6
+
+// Failing parse_result_t values, indexed by -result - 1
+#define METRIC_PARSE_ERRORS 2
+
+typedef struct {
+  metric_counter_t connections_accepted;
+  metric_counter_t connections_closed;
+  metric_counter_t responses[METRIC_STATUS_CLASSES];
+  metric_counter_t bytes_in;
+  metric_counter_t bytes_out;
+  metric_counter_t parse_errors[METRIC_PARSE_ERRORS];
+  metric_counter_t route_cache_hits;
+  metric_counter_t route_cache_misses;
+  metric_counter_t write_pool_hits;
+  metric_counter_t write_pool_misses;
+  metric_counter_t read_pool_hits;
+  metric_counter_t read_pool_misses;
+  metric_histogram_t request_duration;
+} ecewo__metrics_t;
+
+static inline void metric_counter_add(metric_counter_t *c, uint64_t n) {
+  atomic_fetch_add_explicit(&c->value, n, memory_order_relaxed);
+}
+
+static inline void metric_gauge_add(metric_gauge_t *g, int64_t n) {
+  atomic_fetch_add_explicit(&g->value, n, memory_order_relaxed);
+}
+
+void metric_histogram_observe(metric_histogram_t *h, uint64_t value_us);
+
+// Recorders used by the core; each one is a no-op for a client without a
+// worker. metrics_response() also closes the request duration started by
+// client->request_start.
+void metrics_response(ecewo_client_t *client, int status, size_t bytes);
+void metrics_bytes_out(ecewo_client_t *client, size_t bytes);
+void metrics_parse_error(ecewo_client_t *client, int result);
+
+// Number of ecewo_spawn() jobs queued on or running in the thread pool
+extern metric_gauge_t metrics_spawn_queue_depth;
+
+#endif
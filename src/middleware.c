@@ -21,6 +21,7 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include "middleware.h"
 #include "route-table.h"
 #include "server.h"
@@ -46,6 +47,33 @@ static bool path_matches_prefix(const char *prefix, const char *req_path) {
   return next == '\0' || next == '/' || prefix[prefix_len - 1] == '/';
 }
 
+// path with each run of '/' cut to one and no '/' at the end, the form
+// the router matches it in and prefix_matches_pattern() assumes. Returns
+// path itself when it is already in that form, NULL if out of memory.
+static const char *canonical_path(ecewo_arena_t *arena, const char *path) {
+  size_t len = strlen(path);
+  bool canonical = len > 0 && path[0] == '/' && (len == 1 || path[len - 1] != '/');
+  for (size_t i = 1; canonical && i < len; i++)
+    canonical = !(path[i] == '/' && path[i - 1] == '/');
+  if (canonical)
+    return path;
+
+  char *out = ecewo_alloc(arena, len + 2);
+  if (!out)
+    return NULL;
+
+  size_t n = 0;
+  out[n++] = '/';
+  for (size_t i = 0; i < len; i++) {
+    if (path[i] != '/' || out[n - 1] != '/')
+      out[n++] = path[i];
+  }
+  if (n > 1 && out[n - 1] == '/')
+    n--;
+  out[n] = '\0';
+  return out;
+}
+
 static void execute_next(ecewo_request_t *req, ecewo_response_t *res) {
   if (!req || !res) {
     LOG_ERROR("NULL request or response");
@@ -68,15 +96,55 @@ static void execute_next(ecewo_request_t *req, ecewo_response_t *res) {
   }
 }
 
+static bool chain_is_current(const MiddlewareInfo *info, const ecewo__server_t *srv) {
+  return info->chain_ready && srv && info->chain_generation == srv->middleware_generation;
+}
+
 void chain_start(ecewo_request_t *req, ecewo_response_t *res, MiddlewareInfo *middleware_info, ecewo__server_t *srv) {
   if (!req || !res || !middleware_info || !middleware_info->handler)
     return;
 
+  // Resolved at freeze time; only the cursor is per request
+  if (chain_is_current(middleware_info, srv)) {
+    if (middleware_info->chain_count == 0) {
+      middleware_info->handler(req, res);
+      return;
+    }
+
+    Chain *chain = ecewo_alloc(req->arena, sizeof(Chain));
+    if (!chain) {
+      LOG_ERROR("Arena allocation failed for middleware chain.");
+      middleware_info->handler(req, res);
+      return;
+    }
+
+    chain->handlers = middleware_info->chain;
+    chain->count = middleware_info->chain_count;
+    chain->current = 0;
+    chain->route_handler = middleware_info->handler;
+
+    req->chain = chain;
+
+    execute_next(req, res);
+    return;
+  }
+
+  // Prefixes are checked against the path the route was matched with, the
+  // same as for prebuilt chains, so "//api//users" can't skip middleware
+  // mounted on "/api"
+  const char *path = NULL;
   uint16_t matching_global = 0;
 
-  if (srv) {
+  if (srv && srv->global_middleware_count > 0) {
+    path = canonical_path(req->arena, req->path ? req->path : "/");
+    if (!path) {
+      LOG_ERROR("Arena allocation failed for middleware path.");
+      ecewo_send_text(res, 500, "Internal Server Error");
+      return;
+    }
+
     for (uint16_t i = 0; i < srv->global_middleware_count; i++) {
-      if (path_matches_prefix(srv->global_middleware[i].path_prefix, req->path))
+      if (path_matches_prefix(srv->global_middleware[i].path_prefix, path))
         matching_global++;
     }
   }
@@ -98,9 +166,9 @@ void chain_start(ecewo_request_t *req, ecewo_response_t *res, MiddlewareInfo *mi
 
   int idx = 0;
 
-  if (srv) {
+  if (path) {
     for (uint16_t i = 0; i < srv->global_middleware_count; i++) {
-      if (path_matches_prefix(srv->global_middleware[i].path_prefix, req->path))
+      if (path_matches_prefix(srv->global_middleware[i].path_prefix, path))
         combined_handlers[idx++] = srv->global_middleware[i].handler;
     }
   }
@@ -160,9 +228,166 @@ int ecewo_use(ecewo_app_t *app, const char *path, ecewo_middleware_t middleware_
   srv->global_middleware[srv->global_middleware_count].path_prefix = path;
   srv->global_middleware[srv->global_middleware_count].handler = middleware_handler;
   srv->global_middleware_count++;
+  srv->middleware_generation++;
+  return 0;
+}
+
+// -------------------------------------------------------------------------
+// Prebuilt chains
+// -------------------------------------------------------------------------
+
+typedef enum {
+  PREFIX_NEVER,
+  PREFIX_ALWAYS,
+  PREFIX_DEPENDS, // on what a param or wildcard segment captures
+} prefix_match_t;
+
+typedef enum {
+  PATTERN_LITERAL, // no params or wildcards
+  PATTERN_PARAM,
+  PATTERN_WILDCARD,
+} pattern_kind_t;
+
+// Whether path_matches_prefix(prefix, path) holds for the paths the route
+// pattern matches. Paths are taken in the canonical form the router
+// matches them in: one '/' between segments, none at the end.
+static prefix_match_t prefix_matches_pattern(const char *prefix, const char *pattern) {
+  if (!prefix)
+    return PREFIX_ALWAYS;
+
+  // The part every matching path starts with. For a param it ends with the
+  // '/' before it; for a wildcard it stops before the '/' (which may not
+  // come, as "/a/*" matches "/a").
+  char fixed[512];
+  size_t f = 0;
+  pattern_kind_t kind = PATTERN_LITERAL;
+
+  const char *p = pattern;
+  while (*p && kind == PATTERN_LITERAL) {
+    while (*p == '/')
+      p++;
+    if (!*p)
+      break;
+
+    const char *seg = p;
+    while (*p && *p != '/')
+      p++;
+    size_t len = (size_t)(p - seg);
+
+    if (*seg == '*') {
+      kind = PATTERN_WILDCARD;
+      break;
+    }
+    if (f + len + 2 > sizeof(fixed))
+      return PREFIX_DEPENDS;
+    fixed[f++] = '/';
+    if (*seg == ':') {
+      kind = PATTERN_PARAM;
+      break;
+    }
+    memcpy(fixed + f, seg, len);
+    f += len;
+  }
+
+  if (kind == PATTERN_LITERAL && f == 0)
+    fixed[f++] = '/';
+  fixed[f] = '\0';
+
+  if (kind == PATTERN_LITERAL)
+    return path_matches_prefix(prefix, fixed) ? PREFIX_ALWAYS : PREFIX_NEVER;
+
+  size_t m = strlen(prefix);
+
+  if (m > f)
+    return strncmp(fixed, prefix, f) == 0 ? PREFIX_DEPENDS : PREFIX_NEVER;
+
+  if (strncmp(fixed, prefix, m) != 0)
+    return PREFIX_NEVER;
+
+  if (m < f)
+    return (fixed[m] == '/' || prefix[m - 1] == '/') ? PREFIX_ALWAYS : PREFIX_NEVER;
+
+  // The path goes on with param text, or for a wildcard with '/' or nothing
+  return (kind == PATTERN_WILDCARD || prefix[m - 1] == '/') ? PREFIX_ALWAYS : PREFIX_NEVER;
+}
+
+static int resolve_chain(ecewo__server_t *srv, ecewo_arena_t *arena, MiddlewareInfo *info) {
+  info->chain_ready = false;
+
+  bool body_stream = false;
+  uint16_t count = info->middleware_count;
+
+  for (uint16_t i = 0; i < srv->global_middleware_count; i++) {
+    GlobalMiddlewareEntry *g = &srv->global_middleware[i];
+    if ((void *)g->handler == (void *)ecewo_body_stream)
+      body_stream = true;
+
+    prefix_match_t applies = prefix_matches_pattern(g->path_prefix, info->pattern);
+    if (applies == PREFIX_DEPENDS)
+      return 0; // chain_start() keeps choosing per request
+    if (applies == PREFIX_ALWAYS)
+      count++;
+  }
+
+  ecewo_middleware_t *chain = NULL;
+  if (count > 0) {
+    chain = ecewo_alloc(arena, sizeof(ecewo_middleware_t) * count);
+    if (!chain)
+      return -1;
+
+    uint16_t idx = 0;
+    for (uint16_t i = 0; i < srv->global_middleware_count; i++) {
+      GlobalMiddlewareEntry *g = &srv->global_middleware[i];
+      if (prefix_matches_pattern(g->path_prefix, info->pattern) == PREFIX_ALWAYS)
+        chain[idx++] = g->handler;
+    }
+    for (uint16_t i = 0; i < info->middleware_count; i++) {
+      if ((void *)info->middleware[i] == (void *)ecewo_body_stream)
+        body_stream = true;
+      chain[idx++] = info->middleware[i];
+    }
+  }
+
+  info->chain = chain;
+  info->chain_count = count;
+  info->body_stream = body_stream;
+  info->chain_generation = srv->middleware_generation;
+  info->chain_ready = true;
   return 0;
 }
 
+int middleware_freeze(ecewo__server_t *srv) {
+  if (!srv || !srv->app)
+    return -1;
+
+  for (MiddlewareInfo *info = srv->route_middleware; info; info = info->next) {
+    if (chain_is_current(info, srv))
+      continue;
+    if (resolve_chain(srv, srv->app->arena, info) != 0)
+      return -1;
+  }
+  return 0;
+}
+
+bool middleware_has_body_stream(const MiddlewareInfo *mw, const ecewo__server_t *srv) {
+  if (mw && chain_is_current(mw, srv))
+    return mw->body_stream;
+
+  if (mw) {
+    for (uint16_t i = 0; i < mw->middleware_count; i++) {
+      if ((void *)mw->middleware[i] == (void *)ecewo_body_stream)
+        return true;
+    }
+  }
+  if (srv) {
+    for (uint16_t i = 0; i < srv->global_middleware_count; i++) {
+      if ((void *)srv->global_middleware[i].handler == (void *)ecewo_body_stream)
+        return true;
+    }
+  }
+  return false;
+}
+
 void reset_middleware(ecewo__server_t *srv) {
   if (!srv)
     return;
@@ -170,4 +395,5 @@ void reset_middleware(ecewo__server_t *srv) {
   srv->global_middleware = NULL;
   srv->global_middleware_count = 0;
   srv->global_middleware_capacity = 0;
+  srv->middleware_generation++;
 }
@@ -35,6 +35,18 @@ typedef struct MiddlewareInfo {
   ecewo_middleware_t *middleware;
   uint16_t middleware_count;
   ecewo_handler_t handler;
+
+  const char *pattern; // route path as registered; NULL for internal chains
+  struct MiddlewareInfo *next; // every route's info, from ecewo__server_t.route_middleware
+
+  // Filled by middleware_freeze(): the global middleware that applies to
+  // every path the route matches, followed by the route's own. Only used
+  // while chain_generation equals the server's middleware_generation.
+  ecewo_middleware_t *chain;
+  uint16_t chain_count;
+  bool chain_ready;
+  bool body_stream; // ecewo_body_stream is in the chain or global
+  uint32_t chain_generation;
 } MiddlewareInfo;
 
 typedef struct {
@@ -45,4 +57,11 @@ typedef struct {
 void chain_start(ecewo_request_t *req, ecewo_response_t *res, MiddlewareInfo *middleware_info, ecewo__server_t *srv);
 void reset_middleware(ecewo__server_t *srv);
 
+// Resolves the middleware chain of every registered route whose global
+// middleware doesn't depend on the concrete request path
+int middleware_freeze(ecewo__server_t *srv);
+
+// Whether a request for this route runs ecewo_body_stream (mw may be NULL)
+bool middleware_has_body_stream(const MiddlewareInfo *mw, const ecewo__server_t *srv);
+
 #endif
@@ -0,0 +1,78 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "read-pool.h"
+
+static void count(read_pool_t *pool, bool hit) {
+  if (!pool->metrics)
+    return;
+  metric_counter_add(hit ? &pool->metrics->read_pool_hits : &pool->metrics->read_pool_misses, 1);
+}
+
+void read_pool_init(read_pool_t *pool, size_t size, ecewo__metrics_t *metrics) {
+  memset(pool, 0, sizeof(*pool));
+  pool->size = size;
+  pool->metrics = metrics;
+}
+
+void read_pool_destroy(read_pool_t *pool) {
+  if (!pool)
+    return;
+
+  void *buf = pool->free_list;
+  while (buf) {
+    void *next = *(void **)buf;
+    free(buf);
+    buf = next;
+  }
+  pool->free_list = NULL;
+  pool->free_count = 0;
+}
+
+char *read_pool_get(read_pool_t *pool) {
+  void *buf = pool->free_list;
+  if (buf) {
+    pool->free_list = *(void **)buf;
+    pool->free_count--;
+    count(pool, true);
+    return buf;
+  }
+
+  count(pool, false);
+  return malloc(pool->size);
+}
+
+void read_pool_put(read_pool_t *pool, char *buf) {
+  if (!buf)
+    return;
+
+  if (pool->free_count >= READ_POOL_MAX_FREE) {
+    free(buf);
+    return;
+  }
+
+  *(void **)buf = pool->free_list;
+  pool->free_list = buf;
+  pool->free_count++;
+}
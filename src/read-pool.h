@@ -0,0 +1,60 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ECEWO_READ_POOL_H
+#define ECEWO_READ_POOL_H
+
+#include "metrics.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Buffers kept on a worker's free list. A buffer returned to a full list
+// goes back to free().
+#ifndef READ_POOL_MAX_FREE
+#define READ_POOL_MAX_FREE 16
+#endif
+
+// Lends read buffers to the connections of one worker. A connection holds
+// one only from the read callback's allocation until the read is handled,
+// or for as long as a request's headers point into it, so an idle
+// connection holds none. Buffers are plain malloc() blocks: one that
+// outlives the worker's loop can be released with free().
+typedef struct {
+  void *free_list; // each free buffer starts with the link to the next
+  uint32_t free_count;
+  size_t size;
+  ecewo__metrics_t *metrics; // counts hits and misses; may be NULL
+} read_pool_t;
+
+// size is the length of every buffer, at least sizeof(void *)
+void read_pool_init(read_pool_t *pool, size_t size, ecewo__metrics_t *metrics);
+
+// Frees the buffers on the free list
+void read_pool_destroy(read_pool_t *pool);
+
+// A buffer of pool->size bytes, reused when one is free. NULL when out of
+// memory.
+char *read_pool_get(read_pool_t *pool);
+
+// Returns a buffer from read_pool_get(). NULL is ignored.
+void read_pool_put(read_pool_t *pool, char *buf);
+
+#endif
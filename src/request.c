@@ -21,25 +21,12 @@
 
 #include "server.h"
 
-#ifdef _WIN32
-#define strcasecmp _stricmp
-#else
-#include <strings.h>
-#endif
-
-static const char *get_req(const ecewo__req_t *request, const char *key, bool case_insensitive) {
+static const char *get_req(const ecewo__req_t *request, const char *key) {
   if (!request || !request->items || !key || request->count == 0)
     return NULL;
 
-  int (*cmp)(const char *, const char *) = case_insensitive ? strcasecmp : strcmp;
-
   for (uint16_t i = 0; i < request->count; i++) {
-    if (!request->items[i].key)
-      continue;
-
-    bool match = (cmp(request->items[i].key, key) == 0);
-
-    if (match)
+    if (request->items[i].key && strcmp(request->items[i].key, key) == 0)
       return request->items[i].value;
   }
 
@@ -50,36 +37,62 @@ const char *ecewo_param(const ecewo_request_t *req, const char *key) {
   if (!req)
     return NULL;
 
-  return get_req(req->params, key, false);
+  return get_req(req->params, key);
 }
 
 const char *ecewo_query(const ecewo_request_t *req, const char *key) {
   if (!req)
     return NULL;
 
-  return get_req(req->query, key, false);
+  // Most handlers never look at the query string, so it is only split and
+  // decoded here, once. The request is const to callers only.
+  if (!req->query && req->query_len > 0)
+    ((ecewo_request_t *)req)->query = http_parse_query(req->arena, req->query_string, req->query_len);
+
+  return get_req(req->query, key);
+}
+
+size_t ecewo_query_each(const ecewo_request_t *req, ecewo_query_cb_t cb, void *user_data) {
+  if (!req || !cb || !req->query_string)
+    return 0;
+
+  const char *p = req->query_string;
+  const char *end = p + req->query_len;
+  size_t visited = 0;
+
+  while (p < end) {
+    const char *amp = memchr(p, '&', (size_t)(end - p));
+    const char *pair_end = amp ? amp : end;
+
+    if (pair_end > p) {
+      const char *eq = memchr(p, '=', (size_t)(pair_end - p));
+      const char *value = eq ? eq + 1 : NULL;
+      size_t key_len = (size_t)((eq ? eq : pair_end) - p);
+      size_t value_len = eq ? (size_t)(pair_end - value) : 0;
+
+      visited++;
+      if (!cb(p, key_len, value, value_len, user_data))
+        break;
+    }
+
+    p = pair_end + 1;
+  }
+
+  return visited;
 }
 
 const char *ecewo_header_get(const ecewo_request_t *req, const char *key) {
   if (!req || !key)
     return NULL;
 
-  // Header names are stored lowercased at parse time (see on_header_value_cb).
-  // Lowercase the lookup key into a stack buffer and do a plain strcmp.
-  // RFC 7230 §3.2.6 limits field-name to ~256 reasonable chars; bound at 128.
-  char lower[128];
-  size_t len = 0;
-  while (key[len] && len < sizeof(lower) - 1) {
-    unsigned char c = (unsigned char)key[len];
-    lower[len] = (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : (char)c;
-    len++;
-  }
-  if (key[len] != '\0') {
-    // Pathologically long key; fall back to case-insensitive scan.
-    return get_req(req->headers, key, true);
-  }
-  lower[len] = '\0';
-  return get_req(req->headers, lower, false);
+  return http_header_find(req->headers, key, strlen(key));
+}
+
+const char *ecewo_header_get_id(const ecewo_request_t *req, ecewo_header_id_t id) {
+  if (!req)
+    return NULL;
+
+  return http_header_by_id(req->headers, id);
 }
 
 void ecewo_context_set(ecewo_request_t *req, const char *key, void *data) {
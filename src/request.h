@@ -26,13 +26,15 @@
 #include <stdint.h>
 
 // Generic key/value pair used for headers, query string, and URL params.
-// For HEADERS, keys are lowercased at parse time (see on_header_value_cb in
-// http.c). Lookups must lowercase the query key before strcmp, or call
-// ecewo_header_get which does so automatically.
-// Query/URL param keys keep their original case.
+// For HEADERS, key and value usually point straight into the connection's
+// read buffer and keep the case the client sent; compare names with
+// http_header_find or ecewo_header_get, which ignore case. The lengths are
+// only set for headers.
 struct ecewo__req_item_s {
   const char *key;
   const char *value;
+  uint32_t key_len;
+  uint32_t value_len;
 };
 
 typedef struct ecewo__req_item_s ecewo__req_item_t;
@@ -41,6 +43,9 @@ struct ecewo__req_s {
   struct ecewo__req_item_s *items;
   uint16_t count;
   uint16_t capacity;
+  // Headers only: 1 + position in items of the first header with each
+  // ECEWO_HDR_* id, 0 if absent. NULL for the query string and URL params.
+  uint8_t *index;
 };
 
 typedef struct ecewo__req_s ecewo__req_t;
@@ -48,6 +53,8 @@ typedef struct ecewo__req_s ecewo__req_t;
 struct ecewo__res_header_s {
   const char *name;
   const char *value;
+  size_t name_len; // measured by ecewo_header_set() so replies never strlen
+  size_t value_len;
 };
 
 typedef struct ecewo__res_header_s ecewo__res_header_t;
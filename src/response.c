@@ -24,35 +24,75 @@
 #include "utils.h"
 #include "logger.h"
 #include "server.h"
+#include "file-cache.h"
 #include <stdlib.h>
 #include <ctype.h>
+#include <inttypes.h>
 
 #ifdef _WIN32
 #include <string.h>
 #define strcasecmp _stricmp
 #else
 #include <strings.h>
+#include <unistd.h>
 #endif
 
+// write_req_t, stream_write_t and the buffers they carry come from the
+// worker's write pool and are returned to it with write_pool_free()
 typedef struct {
   uv_write_t req;
   uv_buf_t buf;
-  char *data;
+  char *data; // pooled
+  void *body; // caller-owned body, released with body_free after the write
+  ecewo_free_cb_t body_free;
   ecewo_client_t *client;
+  uint32_t request_seq; // client->request_seq of the request replied to
+  bool ends_request; // false for a 1xx, which the final reply follows
 } write_req_t;
 
+// How a response body is kept alive while its write is in flight
+typedef enum {
+  BODY_TRANSIENT, // valid only during the send call; copied if not flushed inline
+  BODY_STATIC, // outlives every write; referenced in place
+  BODY_OWNED, // handed over by the caller; released via free_cb once written
+} body_mode_t;
+
+static void release_body(void *body, ecewo_free_cb_t free_cb) {
+  if (body && free_cb)
+    free_cb(body);
+}
+
+static write_pool_t *client_write_pool(const ecewo_client_t *client) {
+  return client && client->worker ? &client->worker->write_pool : NULL;
+}
+
 static void end_request(ecewo_client_t *client) {
   if (!client)
     return;
 
   client->request_in_progress = false;
 
-  if (client->request_timeout_timer) {
-    uv_timer_stop(client->request_timeout_timer);
-    uv_close((uv_handle_t *)client->request_timeout_timer, (uv_close_cb)free);
-    client->request_timeout_timer = NULL;
-    ecewo_client_unref(client);
-  }
+  if (client->worker)
+    timer_wheel_disarm(&client->worker->timeouts, &client->request_timer);
+}
+
+// For a reply whose write finishes later: pipelined requests may have been
+// started in the meantime, and those are left alone
+static void end_request_seq(ecewo_client_t *client, uint32_t request_seq) {
+  if (client && client->request_seq == request_seq)
+    end_request(client);
+}
+
+// Counts a reply that is about to be written and records its route latency.
+// 1xx replies precede the real one and are not timed.
+static void reply_started(ecewo_client_t *client, ecewo_response_t *res, int status, size_t bytes) {
+  metrics_response(client, status, bytes);
+
+  if (status >= 100 && status < 200)
+    return;
+
+  route_stats_record(res->route_stats, res->dispatched_at);
+  res->route_stats = NULL;
 }
 
 static void write_completion_cb(uv_write_t *req, int status) {
@@ -64,16 +104,14 @@ static void write_completion_cb(uv_write_t *req, int status) {
     return;
 
   if (write_req->client) {
-    end_request(write_req->client);
+    if (write_req->ends_request)
+      end_request_seq(write_req->client, write_req->request_seq);
     ecewo_client_unref(write_req->client);
   }
 
-  if (write_req->data) {
-    free(write_req->data);
-    write_req->data = NULL;
-  }
-
-  free(write_req);
+  write_pool_free(write_req->data);
+  release_body(write_req->body, write_req->body_free);
+  write_pool_free(write_req);
 }
 
 static bool validate_client_for_response(ecewo_response_t *res) {
@@ -99,7 +137,369 @@ static bool validate_client_for_response(ecewo_response_t *res) {
   return true;
 }
 
-// Sends 400 or 500
+// Writes out the replies corked for a batch of pipelined requests, or the
+// stream writes of one loop iteration. Called at the end of the batch, from
+// the worker's check handle and before anything is written to the socket
+// some other way, so bytes stay in order.
+void response_flush_corked(ecewo_client_t *client) {
+  if (!client || client->cork_len == 0)
+    return;
+
+  uv_stream_t *sock = (uv_stream_t *)&client->handle;
+  size_t len = client->cork_len;
+  client->cork_len = 0;
+
+  if (client->closing || uv_is_closing((uv_handle_t *)sock) || !uv_is_writable(sock))
+    return;
+
+  uv_buf_t buf = uv_buf_init(client->cork_buf, (unsigned int)len);
+  // From here on, bytes that don't reach the socket would leave a reply
+  // cut off with the next one right behind it, so any failure closes the
+  // connection
+  int sent = uv_try_write(sock, &buf, 1);
+  if (sent < 0 && sent != UV_EAGAIN) {
+    LOG_DEBUG("Write error: %s", uv_strerror(sent));
+    server_close_client(client);
+    return;
+  }
+
+  // Flushed inline; the buffer is kept for the next batch
+  size_t written = sent > 0 ? (size_t)sent : 0;
+  if (written == len)
+    return;
+
+  // The requests were ended when their replies were corked, so this write
+  // carries no client and write_completion_cb only frees the buffer, which
+  // is handed over as a body since it isn't from the pool
+  write_req_t *write_req = write_pool_calloc(client_write_pool(client), sizeof(write_req_t));
+  if (!write_req) {
+    LOG_ERROR("Failed to allocate write request for corked replies");
+    server_close_client(client);
+    return;
+  }
+
+  write_req->body = client->cork_buf;
+  write_req->body_free = free;
+  client->cork_buf = NULL;
+  client->cork_cap = 0;
+
+  buf = uv_buf_init((char *)write_req->body + written, (unsigned int)(len - written));
+  int result = uv_write(&write_req->req, sock, &buf, 1, write_completion_cb);
+  if (result < 0) {
+    LOG_DEBUG("Write error: %s", uv_strerror(result));
+    free(write_req->body);
+    write_pool_free(write_req);
+    server_close_client(client);
+  }
+}
+
+// Makes room for len more bytes of corked replies and returns where they
+// go; the caller fills all of them. NULL on allocation failure.
+static char *cork_reserve(ecewo_client_t *client, size_t len) {
+  size_t needed = client->cork_len + len;
+
+  if (needed > client->cork_cap) {
+    size_t cap = client->cork_cap ? client->cork_cap : 4096;
+    while (cap < needed)
+      cap *= 2;
+
+    // Freed in client_free_server, or handed to the write in response_flush_corked
+    char *grown = realloc(client->cork_buf, cap);
+    if (!grown)
+      return NULL;
+    client->cork_buf = grown;
+    client->cork_cap = cap;
+  }
+
+  char *dst = client->cork_buf + client->cork_len;
+  client->cork_len = needed;
+  return dst;
+}
+
+// Whether a write joins the corked bytes instead of going out on its own:
+// inside a batch of pipelined requests, or when earlier writes of this loop
+// iteration are already waiting for the worker's flush
+static bool cork_active(const ecewo_client_t *client) {
+  return client->corked || client->flush_scheduled;
+}
+
+// Makes sure bytes just corked outside a batch are written by the end of
+// the loop iteration
+static void cork_commit(ecewo_client_t *client) {
+  if (!client->corked && !server_schedule_flush(client))
+    response_flush_corked(client);
+}
+
+// Everything in a response head besides the headers set via
+// ecewo_header_set(). Lines are written in field order, each one only when
+// its field is set; the Date is fetched once so sizing and writing agree.
+typedef struct {
+  int status;
+  const char *reason; // appended to the status line; only error replies have one
+  const char *date; // NULL for 1xx
+  size_t date_len;
+  const char *etag; // file responses
+  const char *last_modified;
+  bool chunked; // Transfer-Encoding: chunked
+  bool has_length;
+  uint64_t length; // Content-Length
+  const char *connection; // "keep-alive" or "close"; NULL for 1xx
+  bool open; // no blank line; a template's wire data completes the head
+} head_t;
+
+// Appends to out, or only counts when out is NULL, so one function both
+// sizes a head and writes it
+typedef struct {
+  char *out;
+  size_t len;
+} head_writer_t;
+
+static inline void head_put(head_writer_t *w, const char *s, size_t n) {
+  if (w->out && n > 0)
+    memcpy(w->out + w->len, s, n);
+  w->len += n;
+}
+
+#define HEAD_PUT_LITERAL(w, lit) head_put((w), (lit), sizeof(lit) - 1)
+
+// Writes v in decimal so that it ends at buf + 20 and returns its first digit
+static char *u64_to_dec(char buf[20], uint64_t v) {
+  char *p = buf + 20;
+  do {
+    *--p = (char)('0' + v % 10);
+    v /= 10;
+  } while (v);
+  return p;
+}
+
+static void head_put_status(head_writer_t *w, int status, const char *reason) {
+  char line[32] = "HTTP/1.1 ";
+
+  if (status >= 100 && status <= 999) {
+    line[9] = (char)('0' + status / 100);
+    line[10] = (char)('0' + status / 10 % 10);
+    line[11] = (char)('0' + status % 10);
+    head_put(w, line, 12);
+  } else {
+    // Not a real status code; written as given
+    int n = snprintf(line, sizeof(line), "HTTP/1.1 %d", status);
+    head_put(w, line, (size_t)n);
+  }
+
+  if (reason) {
+    HEAD_PUT_LITERAL(w, " ");
+    head_put(w, reason, strlen(reason));
+  }
+  HEAD_PUT_LITERAL(w, "\r\n");
+}
+
+static void head_put_line(head_writer_t *w, const char *name, size_t name_len, const char *value, size_t value_len) {
+  head_put(w, name, name_len);
+  HEAD_PUT_LITERAL(w, ": ");
+  head_put(w, value, value_len);
+  HEAD_PUT_LITERAL(w, "\r\n");
+}
+
+// Without a response, as for send_error(), the connection is closed
+static void head_init(head_t *h, const ecewo_response_t *res, int status) {
+  memset(h, 0, sizeof(*h));
+  h->status = status;
+  h->date = get_cached_date(&h->date_len);
+  h->connection = res && res->keep_alive ? "keep-alive" : "close";
+}
+
+// Writes the head to out and returns its length; with out NULL only the
+// length is returned. out must hold that many bytes; nothing is terminated.
+// res may be NULL when no headers were set.
+static size_t head_render(char *out, const ecewo_response_t *res, const head_t *h) {
+  head_writer_t w = { out, 0 };
+
+  head_put_status(&w, h->status, h->reason);
+
+  if (h->date)
+    head_put_line(&w, "Date", 4, h->date, h->date_len);
+
+  for (uint16_t i = 0; res && i < res->header_count; i++) {
+    const ecewo__res_header_t *hdr = &res->headers[i];
+    head_put_line(&w, hdr->name, hdr->name_len, hdr->value, hdr->value_len);
+  }
+
+  if (h->etag)
+    head_put_line(&w, "ETag", 4, h->etag, strlen(h->etag));
+  if (h->last_modified)
+    head_put_line(&w, "Last-Modified", 13, h->last_modified, strlen(h->last_modified));
+
+  if (h->chunked)
+    HEAD_PUT_LITERAL(&w, "Transfer-Encoding: chunked\r\n");
+
+  if (h->has_length) {
+    char digits[20];
+    char *start = u64_to_dec(digits, h->length);
+    head_put_line(&w, "Content-Length", 14, start, (size_t)(digits + 20 - start));
+  }
+
+  if (h->connection)
+    head_put_line(&w, "Connection", 10, h->connection, strlen(h->connection));
+
+  if (!h->open)
+    HEAD_PUT_LITERAL(&w, "\r\n");
+  return w.len;
+}
+
+// A reply serialized once. Per send only the status line, Date, the
+// headers set on the response and Connection are written in front of it;
+// the wire data is shared by every reply and never copied unless corked.
+struct ecewo_response_template_s {
+  int status;
+  const char *reason; // built-in error replies only
+  char *wire; // template headers, Content-Length, blank line, body
+  size_t headers_len; // template header lines at the start of wire
+  size_t head_len; // everything before the body
+  size_t len;
+  bool builtin; // wire is a literal; never built or freed
+};
+
+#define BUILTIN_HEAD(length) "Content-Type: text/plain\r\nContent-Length: " length "\r\n\r\n"
+
+// length must be the decimal length of body
+#define BUILTIN_TEMPLATE(code, reason_text, length, body)       \
+  {                                                             \
+    .status = (code),                                           \
+    .reason = (reason_text),                                    \
+    .wire = (char *)(BUILTIN_HEAD(length) body),                \
+    .headers_len = sizeof("Content-Type: text/plain\r\n") - 1, \
+    .head_len = sizeof(BUILTIN_HEAD(length)) - 1,               \
+    .len = sizeof(BUILTIN_HEAD(length) body) - 1,               \
+    .builtin = true,                                            \
+  }
+
+static const ecewo_response_template_t not_found_template =
+    BUILTIN_TEMPLATE(404, NULL, "13", "404 Not Found");
+static const ecewo_response_template_t method_not_allowed_template =
+    BUILTIN_TEMPLATE(405, NULL, "22", "405 Method Not Allowed");
+static const ecewo_response_template_t bad_request_template =
+    BUILTIN_TEMPLATE(400, "Bad Request", "11", "Bad Request");
+static const ecewo_response_template_t payload_too_large_template =
+    BUILTIN_TEMPLATE(413, "Payload Too Large", "17", "Payload Too Large");
+static const ecewo_response_template_t server_error_template =
+    BUILTIN_TEMPLATE(500, "Internal Server Error", "21", "Internal Server Error");
+
+// Writes a rendered head and its body, flushing as much as the socket
+// takes right away; uv_try_write() refuses while earlier writes are still
+// queued, so ordering holds. Headers and body go out as two buffers, so
+// the body is never copied next to the headers. The body is released and
+// the request ended once everything is written. Returns -1, with the body
+// released, only when what is left could not be queued for lack of memory.
+static int reply_write(ecewo_client_t *client,
+                       const char *headers,
+                       size_t headers_len,
+                       const void *body,
+                       size_t body_len,
+                       body_mode_t mode,
+                       ecewo_free_cb_t free_cb,
+                       bool final) {
+  void *owned = (mode == BODY_OWNED) ? (void *)body : NULL;
+  uv_stream_t *sock = (uv_stream_t *)&client->handle;
+  size_t total_len = headers_len + body_len;
+
+  uv_buf_t bufs[2];
+  unsigned int nbufs = 0;
+  bufs[nbufs++] = uv_buf_init((char *)headers, (unsigned int)headers_len);
+  if (body_len > 0)
+    bufs[nbufs++] = uv_buf_init((char *)body, (unsigned int)body_len);
+
+  int sent = uv_try_write(sock, bufs, nbufs);
+  if (sent < 0 && sent != UV_EAGAIN) {
+    LOG_DEBUG("Write error: %s", uv_strerror(sent));
+    release_body(owned, free_cb);
+    if (final)
+      end_request(client);
+    return 0;
+  }
+
+  size_t written = sent > 0 ? (size_t)sent : 0;
+  if (written == total_len) {
+    release_body(owned, free_cb);
+    if (final)
+      end_request(client);
+    return 0;
+  }
+
+  // uv_write() is an async operation, so when ecewo_send() returns
+  // client can send another request and reset the arena,
+  // but uv_write() might not be completed yet.
+  // Therefore write_req and whatever is left of the headers must live
+  // outside the arena, in the worker's write pool. Otherwise, it causes
+  // segfault under a high load. A transient body is copied along with
+  // them; static and owned bodies are referenced in place. Both freed in
+  // write_completion_cb
+
+  size_t headers_rest = written < headers_len ? headers_len - written : 0;
+  size_t body_offset = written > headers_len ? written - headers_len : 0;
+  size_t body_rest = body_len - body_offset;
+  size_t copy_len = headers_rest + (mode == BODY_TRANSIENT ? body_rest : 0);
+
+  write_pool_t *pool = client_write_pool(client);
+  char *response = NULL;
+  if (copy_len > 0) {
+    response = write_pool_alloc(pool, copy_len);
+    if (!response) {
+      release_body(owned, free_cb);
+      return -1;
+    }
+
+    memcpy(response, headers + (headers_len - headers_rest), headers_rest);
+    if (mode == BODY_TRANSIENT && body_rest > 0)
+      memcpy(response + headers_rest, (const char *)body + body_offset, body_rest);
+  }
+
+  write_req_t *write_req = write_pool_calloc(pool, sizeof(write_req_t));
+  if (!write_req) {
+    write_pool_free(response);
+    release_body(owned, free_cb);
+    return -1;
+  }
+
+  nbufs = 0;
+  if (copy_len > 0)
+    bufs[nbufs++] = uv_buf_init(response, (unsigned int)copy_len);
+  if (mode != BODY_TRANSIENT && body_rest > 0)
+    bufs[nbufs++] = uv_buf_init((char *)body + body_offset, (unsigned int)body_rest);
+
+  write_req->data = response;
+  write_req->body = owned;
+  write_req->body_free = free_cb;
+  write_req->client = client;
+  write_req->request_seq = client->request_seq;
+  write_req->ends_request = final;
+  ecewo_client_ref(client);
+
+  if (uv_is_closing((uv_handle_t *)sock)) {
+    write_pool_free(response);
+    release_body(owned, free_cb);
+    ecewo_client_unref(client);
+    write_pool_free(write_req);
+    return 0;
+  }
+
+  // uv_write() copies the uv_buf_t array itself, so bufs may live on the stack
+  int result = uv_write(&write_req->req, sock, bufs, nbufs, write_completion_cb);
+
+  if (result < 0) {
+    LOG_DEBUG("Write error: %s", uv_strerror(result));
+    write_pool_free(response);
+    release_body(owned, free_cb);
+    if (final)
+      end_request(client);
+    ecewo_client_unref(client);
+    write_pool_free(write_req);
+  }
+
+  return 0;
+}
+
+// Sends 400, 413 or 500 and closes the connection afterwards. Used where
+// there may be no response to reply through.
 void send_error(ecewo_arena_t *arena, uv_tcp_t *ecewo__client_socket, int error_code) {
   if (!ecewo__client_socket) {
     if (arena)
@@ -119,85 +519,139 @@ void send_error(ecewo_arena_t *arena, uv_tcp_t *ecewo__client_socket, int error_
     return;
   }
 
-  const char *date_str = get_cached_date();
-  const char *status_text = (error_code == 500) ? "Internal Server Error" : "Bad Request";
-  const char *body = status_text;
-  size_t body_len = strlen(body);
-
-  size_t response_size = 512;
-  // Freed in write_completion_cb after the async write finishes
-  char *response = malloc(response_size);
-
-  if (!response) {
+  ecewo_client_t *client = (ecewo_client_t *)ecewo__client_socket->data;
+  if (!client) {
     if (arena)
       arena_reset(arena);
     return;
   }
 
-  int written = snprintf(response, response_size,
-                         "HTTP/1.1 %d %s\r\n"
-                         "Date: %s\r\n"
-                         "Content-Type: text/plain\r\n"
-                         "Content-Length: %zu\r\n"
-                         "Connection: close\r\n"
-                         "\r\n"
-                         "%s",
-                         error_code,
-                         status_text,
-                         date_str,
-                         body_len,
-                         body);
+  response_flush_corked(client);
 
-  if (written < 0 || (size_t)written >= response_size) {
-    free(response);
-    if (arena)
-      arena_reset(arena);
-    return;
-  }
+  const ecewo_response_template_t *tpl;
+  if (error_code == 500)
+    tpl = &server_error_template;
+  else if (error_code == 413)
+    tpl = &payload_too_large_template;
+  else
+    tpl = &bad_request_template;
 
-  // Freed in write_completion_cb after the async write finishes
-  write_req_t *write_req = malloc(sizeof(write_req_t));
-  if (!write_req) {
-    free(response);
-    if (arena)
-      arena_reset(arena);
-    return;
-  }
+  head_t head;
+  head_init(&head, NULL, tpl->status);
+  head.reason = tpl->reason;
+  head.open = true;
 
-  memset(write_req, 0, sizeof(write_req_t));
-  write_req->data = response;
-  write_req->client = (ecewo_client_t *)ecewo__client_socket->data;
-  if (write_req->client)
-    ecewo_client_ref(write_req->client);
-  write_req->buf = uv_buf_init(response, (unsigned int)written);
+  // Status line, Date and Connection; well under the buffer size
+  char prefix[128];
+  size_t prefix_len = head_render(prefix, NULL, &head);
 
-  int res = uv_write(&write_req->req, (uv_stream_t *)ecewo__client_socket,
-                     &write_req->buf, 1, write_completion_cb);
+  metrics_response(client, tpl->status, prefix_len + tpl->len);
+  reply_write(client, prefix, prefix_len, tpl->wire, tpl->len, BODY_STATIC, NULL, true);
 
-  if (res < 0) {
-    LOG_ERROR("Write error: %s", uv_strerror(res));
-    free(response);
+  if (arena)
+    arena_reset(arena);
+}
 
-    if (write_req->client) {
-      end_request(write_req->client);
-      ecewo_client_unref(write_req->client);
+// Sends the head described by h, followed by the headers set on res, and
+// the body. Replies to pipelined requests, and replies following stream
+// writes that wait for the end of the loop iteration, are collected in the
+// cork buffer; anything else is written right away. Resets the response arena
+// unless the reply is a 1xx.
+static void reply_send(ecewo_response_t *res,
+                       const head_t *h,
+                       const void *body,
+                       size_t body_len,
+                       body_mode_t mode,
+                       ecewo_free_cb_t free_cb) {
+  size_t headers_len = head_render(NULL, res, h);
+  size_t total_len = headers_len + body_len;
+  uv_tcp_t *sock = (uv_tcp_t *)res->ecewo__client_socket;
+  ecewo_client_t *client = (ecewo_client_t *)sock->data;
+
+  // A 1xx only precedes the final reply; the request goes on after it
+  bool final = h->status < 100 || h->status >= 200;
+
+  // Anything written after this point queues behind the reply, so requests
+  // pipelined behind this one may go ahead
+  if (final)
+    server_response_done(client);
+  reply_started(client, res, h->status, total_len);
+
+  if (cork_active(client) && total_len <= PIPELINE_CORK_SIZE) {
+    if (client->cork_len + total_len > PIPELINE_CORK_SIZE)
+      response_flush_corked(client);
+
+    // Written straight into the cork buffer, next to the body
+    char *dst = cork_reserve(client, total_len);
+    if (dst) {
+      head_render(dst, res, h);
+      if (body_len > 0)
+        memcpy(dst + headers_len, body, body_len);
+      release_body(mode == BODY_OWNED ? (void *)body : NULL, free_cb);
+      cork_commit(client);
+      if (final) {
+        end_request(client);
+        server_reply_finished(client);
+        if (res->arena)
+          arena_reset(res->arena);
+      }
+      return;
     }
+  }
+
+  response_flush_corked(client);
 
-    free(write_req);
+  char *headers = ecewo_alloc(res->arena, headers_len);
+  if (!headers) {
+    release_body(mode == BODY_OWNED ? (void *)body : NULL, free_cb);
+    send_error(res->arena, sock, 500);
+    return;
   }
+  head_render(headers, res, h);
 
-  if (arena)
-    arena_reset(arena);
+  if (reply_write(client, headers, headers_len, body, body_len, mode, free_cb, final) != 0) {
+    send_error(res->arena, sock, 500);
+    return;
+  }
+
+  // A transient body, which may point into the request's header block,
+  // has been written or copied by now
+  if (final) {
+    server_reply_finished(client);
+    if (res->arena)
+      arena_reset(res->arena);
+  }
 }
 
-void ecewo_send(ecewo_response_t *res, int status, const void *body, size_t body_len) {
-  if (!res)
+// free_cb is only set for BODY_OWNED, and every path below either hands the
+// body to a write request or releases it before returning.
+static void send_response(ecewo_response_t *res,
+                          int status,
+                          const void *body,
+                          size_t body_len,
+                          body_mode_t mode,
+                          ecewo_free_cb_t free_cb) {
+  void *owned = (mode == BODY_OWNED) ? (void *)body : NULL;
+
+  if (!res) {
+    release_body(owned, free_cb);
     return;
+  }
 
-  res->replied = true;
+  if (res->stream_mode != STREAM_NONE) {
+    LOG_ERROR("Response is being streamed; finish it with ecewo_stream_end()");
+    release_body(owned, free_cb);
+    return;
+  }
+
+  // After a 1xx the handler still owes the final reply
+  bool interim = status >= 100 && status < 200;
+  if (!interim)
+    res->replied = true;
 
   if (!validate_client_for_response(res)) {
-    if (res->arena)
+    release_body(owned, free_cb);
+    if (res->arena && !interim)
       arena_reset(res->arena);
     return;
   }
@@ -206,154 +660,786 @@ void ecewo_send(ecewo_response_t *res, int status, const void *body, size_t body
     body_len = 0;
 
   size_t original_body_len = body_len;
-  if (res->is_head_request || (status >= 100 && status < 200) || status == 204) {
+  if (res->is_head_request || interim || status == 204) {
+    // None of it goes out, so an owned body is done with already
+    release_body(owned, free_cb);
     body = NULL;
     body_len = 0;
+    mode = BODY_STATIC;
   }
 
-  const char *date_str = get_cached_date();
-  const char *connection = res->keep_alive ? "keep-alive" : "close";
+  head_t head;
+  head_init(&head, res, status);
+  if (interim) {
+    head.date = NULL;
+    head.connection = NULL;
+  } else if (status != 204) {
+    head.has_length = true;
+    head.length = original_body_len;
+  }
 
-  size_t headers_size = 0;
-  for (uint16_t i = 0; i < res->header_count; i++) {
-    if (res->headers[i].name && res->headers[i].value) {
-      headers_size += strlen(res->headers[i].name) + 2 + // "name: "
-          strlen(res->headers[i].value) + 2; // "value\r\n"
+  reply_send(res, &head, body, body_len, mode, free_cb);
+}
+
+void ecewo_send(ecewo_response_t *res, int status, const void *body, size_t body_len) {
+  send_response(res, status, body, body_len, BODY_TRANSIENT, NULL);
+}
+
+void ecewo_send_owned(ecewo_response_t *res, int status, void *body, size_t body_len, ecewo_free_cb_t free_cb) {
+  send_response(res, status, body, body_len, free_cb ? BODY_OWNED : BODY_STATIC, free_cb);
+}
+
+void ecewo_send_static(ecewo_response_t *res, int status, const void *body, size_t body_len) {
+  send_response(res, status, body, body_len, BODY_STATIC, NULL);
+}
+
+// A streamed response is written as it is produced: the head goes out in
+// ecewo_stream_begin*(), every chunk is queued as soon as it is handed over,
+// and ecewo_stream_end() finishes the body. Small copied chunks are corked
+// and written together at the end of the loop iteration. Nothing of the
+// body is kept in the arena, so memory stays bounded by what the socket has
+// not accepted yet (see ecewo_stream_queue_size()).
+
+typedef struct {
+  uv_write_t req;
+  ecewo_client_t *client;
+  void *chunk; // caller's buffer, handed back to done_cb
+  ecewo_stream_write_cb_t done_cb;
+  char *copy; // pooled; response head, or a chunk copied because done_cb was NULL
+  char size_line[24]; // "<hex length>\r\n" in chunked mode
+} stream_write_t;
+
+static const char chunk_crlf[] = "\r\n";
+static const char last_chunk[] = "0\r\n\r\n";
+
+static void stream_write_cb(uv_write_t *req, int status) {
+  stream_write_t *w = (stream_write_t *)req;
+
+  if (status < 0)
+    LOG_DEBUG("Stream write error: %s", uv_strerror(status));
+
+  if (w->done_cb)
+    w->done_cb(w->chunk, status);
+
+  write_pool_free(w->copy);
+  if (w->client)
+    ecewo_client_unref(w->client);
+  write_pool_free(w);
+}
+
+// Queues one write. copy (may be NULL, else from the write pool) is owned by
+// the write from here on; when set it is sent instead of data. On failure
+// nothing is queued, copy is freed and done_cb is not called.
+static int stream_queue(ecewo_response_t *res,
+                        char *copy,
+                        const void *data,
+                        size_t len,
+                        ecewo_stream_write_cb_t done_cb,
+                        bool chunk_framing) {
+  uv_tcp_t *sock = (uv_tcp_t *)res->ecewo__client_socket;
+
+  ecewo_client_t *client = (ecewo_client_t *)sock->data;
+
+  // Bytes the caller let go of are corked, so the head and the small chunks
+  // of one loop iteration share a write. A done_cb asks for the buffer
+  // itself to be written; calling it from here could also recurse.
+  if (!done_cb && len <= WRITE_COALESCE_SIZE) {
+    char size_line[24];
+    size_t framing = 0;
+    if (chunk_framing)
+      framing = (size_t)snprintf(size_line, sizeof(size_line), "%zx\r\n", len);
+
+    size_t total = framing + len + (chunk_framing ? 2 : 0);
+    if (client->cork_len + total > PIPELINE_CORK_SIZE)
+      response_flush_corked(client);
+
+    char *dst = cork_reserve(client, total);
+    if (!dst) {
+      write_pool_free(copy);
+      return -1;
     }
+
+    memcpy(dst, size_line, framing);
+    memcpy(dst + framing, copy ? copy : data, len);
+    if (chunk_framing)
+      memcpy(dst + framing + len, chunk_crlf, 2);
+    write_pool_free(copy);
+
+    metrics_bytes_out(client, total);
+    cork_commit(client);
+    return 0;
   }
 
-  char *all_headers = NULL;
-  if (headers_size > 0) {
-    all_headers = ecewo_alloc(res->arena, headers_size + 1);
-    if (!all_headers) {
-      send_error(res->arena, (uv_tcp_t *)res->ecewo__client_socket, 500);
-      return;
-    }
+  // Corked bytes were handed over first
+  response_flush_corked(client);
 
-    size_t pos = 0;
-    for (uint16_t i = 0; i < res->header_count; i++) {
-      if (res->headers[i].name && res->headers[i].value) {
-        size_t name_len = strlen(res->headers[i].name);
-        size_t value_len = strlen(res->headers[i].value);
-
-        memcpy(all_headers + pos, res->headers[i].name, name_len);
-        pos += name_len;
-        all_headers[pos++] = ':';
-        all_headers[pos++] = ' ';
-        memcpy(all_headers + pos, res->headers[i].value, value_len);
-        pos += value_len;
-        all_headers[pos++] = '\r';
-        all_headers[pos++] = '\n';
-      }
-    }
-    all_headers[pos] = '\0';
+  // Freed in stream_write_cb after the async write finishes
+  stream_write_t *w = write_pool_calloc(client_write_pool(client), sizeof(stream_write_t));
+  if (!w) {
+    write_pool_free(copy);
+    return -1;
+  }
+
+  w->client = client;
+  w->chunk = (void *)data;
+  w->done_cb = done_cb;
+  w->copy = copy;
+
+  uv_buf_t bufs[3];
+  unsigned int nbufs = 0;
+
+  if (chunk_framing) {
+    int n = snprintf(w->size_line, sizeof(w->size_line), "%zx\r\n", len);
+    bufs[nbufs++] = uv_buf_init(w->size_line, (unsigned int)n);
+  }
+
+  bufs[nbufs++] = uv_buf_init(copy ? copy : (char *)data, (unsigned int)len);
+
+  if (chunk_framing)
+    bufs[nbufs++] = uv_buf_init((char *)chunk_crlf, 2);
+
+  if (w->client)
+    ecewo_client_ref(w->client);
+
+  int result = uv_write(&w->req, (uv_stream_t *)sock, bufs, nbufs, stream_write_cb);
+  if (result < 0) {
+    LOG_DEBUG("Stream write error: %s", uv_strerror(result));
+    if (w->client)
+      ecewo_client_unref(w->client);
+    write_pool_free(w->copy);
+    write_pool_free(w);
+    return -1;
+  }
+
+  for (unsigned int i = 0; i < nbufs; i++)
+    metrics_bytes_out(w->client, bufs[i].len);
+  return 0;
+}
+
+static int stream_begin(ecewo_response_t *res, int status, bool has_length, uint64_t length) {
+  if (!res)
+    return -1;
+
+  if (res->replied || res->stream_mode != STREAM_NONE) {
+    LOG_ERROR("ecewo_stream_begin(): response already started");
+    return -1;
+  }
+
+  if (status >= 100 && status < 200) {
+    LOG_ERROR("ecewo_stream_begin(): informational responses have no body");
+    return -1;
+  }
+
+  if (!validate_client_for_response(res))
+    return -1;
+
+  ecewo__stream_mode_t mode;
+  if (has_length)
+    mode = STREAM_LENGTH;
+  else if (res->http10)
+    mode = STREAM_UNTIL_CLOSE;
+  else
+    mode = STREAM_CHUNKED;
+
+  bool keep_alive = res->keep_alive && mode != STREAM_UNTIL_CLOSE;
+  bool no_body = res->is_head_request || status == 204 || status == 304;
+
+  // 204/304 carry no framing; an HTTP/1.0 body is delimited by the close
+  bool framed = status != 204 && status != 304 && mode != STREAM_UNTIL_CLOSE;
+
+  head_t head;
+  head_init(&head, res, status);
+  head.connection = keep_alive ? "keep-alive" : "close";
+  head.chunked = framed && mode == STREAM_CHUNKED;
+  head.has_length = framed && mode == STREAM_LENGTH;
+  head.length = length;
+
+  size_t head_len = head_render(NULL, res, &head);
+  ecewo_client_t *client = (ecewo_client_t *)((uv_tcp_t *)res->ecewo__client_socket)->data;
+
+  if (head_len <= WRITE_COALESCE_SIZE) {
+    // Rendered straight into the cork buffer, like the head of a reply
+    if (client->cork_len + head_len > PIPELINE_CORK_SIZE)
+      response_flush_corked(client);
+
+    char *dst = cork_reserve(client, head_len);
+    if (!dst)
+      return -1;
+    head_render(dst, res, &head);
+
+    metrics_bytes_out(client, head_len);
+    cork_commit(client);
   } else {
-    all_headers = ecewo_strdup(res->arena, "");
-    if (!all_headers) {
-      send_error(res->arena, (uv_tcp_t *)res->ecewo__client_socket, 500);
-      return;
+    // The arena may be reset before the head is written; it goes in the pool
+    char *copy = write_pool_alloc(client_write_pool(client), head_len);
+    if (!copy)
+      return -1;
+    head_render(copy, res, &head);
+
+    if (stream_queue(res, copy, NULL, head_len, NULL, false) != 0)
+      return -1;
+  }
+
+  // The head's bytes are already counted
+  reply_started(client, res, status, 0);
+
+  res->status = (uint16_t)status;
+  res->keep_alive = keep_alive;
+  res->stream_mode = mode;
+  res->stream_no_body = no_body;
+  res->stream_remaining = has_length ? length : 0;
+  return 0;
+}
+
+int ecewo_stream_begin(ecewo_response_t *res, int status) {
+  return stream_begin(res, status, false, 0);
+}
+
+int ecewo_stream_begin_length(ecewo_response_t *res, int status, uint64_t content_length) {
+  return stream_begin(res, status, true, content_length);
+}
+
+int ecewo_stream_write(ecewo_response_t *res, const void *buf, size_t len, ecewo_stream_write_cb_t done_cb) {
+  if (!res || res->stream_mode == STREAM_NONE || res->replied)
+    return -1;
+
+  if (len > 0 && !buf)
+    return -1;
+
+  if (res->stream_mode == STREAM_LENGTH && len > res->stream_remaining) {
+    LOG_ERROR("ecewo_stream_write(): %zu bytes exceed the declared Content-Length", len);
+    return -1;
+  }
+
+  if (!validate_client_for_response(res))
+    return -1;
+
+  if (res->stream_mode == STREAM_LENGTH)
+    res->stream_remaining -= len;
+
+  // Nothing goes on the wire; still hand the buffer back exactly once
+  if (len == 0 || res->stream_no_body) {
+    if (done_cb)
+      done_cb((void *)buf, 0);
+    return 0;
+  }
+
+  // A small chunk is copied into the cork buffer by stream_queue() instead
+  char *copy = NULL;
+  if (!done_cb && len > WRITE_COALESCE_SIZE) {
+    ecewo_client_t *client = (ecewo_client_t *)((uv_tcp_t *)res->ecewo__client_socket)->data;
+    copy = write_pool_alloc(client_write_pool(client), len);
+    if (!copy)
+      return -1;
+    memcpy(copy, buf, len);
+  }
+
+  return stream_queue(res, copy, buf, len, done_cb, res->stream_mode == STREAM_CHUNKED);
+}
+
+int ecewo_stream_end(ecewo_response_t *res) {
+  if (!res || res->stream_mode == STREAM_NONE || res->replied)
+    return -1;
+
+  res->replied = true;
+
+  uv_tcp_t *sock = (uv_tcp_t *)res->ecewo__client_socket;
+  ecewo_client_t *client = sock ? (ecewo_client_t *)sock->data : NULL;
+
+  if (!validate_client_for_response(res)) {
+    if (res->arena)
+      arena_reset(res->arena);
+    return -1;
+  }
+
+  int result = 0;
+
+  if (res->stream_mode == STREAM_CHUNKED && !res->stream_no_body) {
+    if (stream_queue(res, NULL, last_chunk, sizeof(last_chunk) - 1, NULL, false) != 0) {
+      res->keep_alive = false;
+      result = -1;
     }
   }
 
-  bool informational = (status >= 100 && status < 200);
-  char *headers;
-  if (informational) {
-    headers = ecewo_sprintf(res->arena,
-                            "HTTP/1.1 %d\r\n"
-                            "%s"
-                            "\r\n",
-                            status,
-                            all_headers);
-  } else if (status == 204) {
-    headers = ecewo_sprintf(res->arena,
-                            "HTTP/1.1 %d\r\n"
-                            "Date: %s\r\n"
-                            "%s"
-                            "Connection: %s\r\n"
-                            "\r\n",
-                            status,
-                            date_str,
-                            all_headers,
-                            connection);
-  } else {
-    headers = ecewo_sprintf(res->arena,
-                            "HTTP/1.1 %d\r\n"
-                            "Date: %s\r\n"
-                            "%s"
-                            "Content-Length: %zu\r\n"
-                            "Connection: %s\r\n"
-                            "\r\n",
-                            status,
-                            date_str,
-                            all_headers,
-                            original_body_len,
-                            connection);
+  if (res->stream_mode == STREAM_LENGTH && res->stream_remaining > 0 && !res->stream_no_body) {
+    // The peer is still waiting for bytes that will never come
+    LOG_ERROR("ecewo_stream_end(): body ended %" PRIu64 " bytes short of Content-Length",
+              res->stream_remaining);
+    res->keep_alive = false;
+    result = -1;
   }
 
-  if (!headers) {
-    send_error(res->arena, res->ecewo__client_socket, 500);
+  end_request(client);
+  server_response_done(client);
+  server_reply_finished(client);
+
+  // Inside a handler the router closes the connection on its own; after an
+  // async end nothing else would. server_close_client() is a no-op on a
+  // connection that is already closing.
+  if (!res->keep_alive || res->stream_mode == STREAM_UNTIL_CLOSE)
+    server_close_client(client);
+
+  if (res->arena)
+    arena_reset(res->arena);
+
+  return result;
+}
+
+size_t ecewo_stream_queue_size(const ecewo_response_t *res) {
+  if (!res || !res->ecewo__client_socket)
+    return 0;
+
+  const uv_stream_t *sock = (const uv_stream_t *)res->ecewo__client_socket;
+  const ecewo_client_t *client = (const ecewo_client_t *)sock->data;
+
+  // Corked bytes are as good as queued; they go out at the end of the iteration
+  size_t corked = client ? client->cork_len : 0;
+  return uv_stream_get_write_queue_size(sock) + corked;
+}
+
+// ecewo_send_file() writes the head with uv_write() and then lets the kernel
+// copy the file straight into the socket with uv_fs_sendfile(), so the body
+// never passes through user space. sendfile runs on the threadpool against a
+// dup() of the socket: if the connection is closed meanwhile, the descriptor
+// number can't be reused under the transfer. Pipelined requests are held back
+// until the body is out, so a reply to one can't land in the middle of it.
+// Windows has no sendfile for sockets; there the file is read in blocks and
+// written with uv_write().
+
+// Upper bound for one sendfile call, or one read on Windows
+#ifndef FILE_SEND_CHUNK_SIZE
+#define FILE_SEND_CHUNK_SIZE (64 * 1024)
+#endif
+
+// Delay before retrying a sendfile that found the socket buffer full (ms)
+#define FILE_SEND_RETRY_MS 1
+
+typedef struct {
+  uv_write_t write_req;
+  uv_fs_t fs_req;
+  ecewo_client_t *client;
+  uint32_t request_seq; // client->request_seq of the request replied to
+  file_cache_entry_t *file;
+  char *head;
+  int64_t offset;
+  uint64_t remaining;
+  bool keep_alive;
+#ifdef _WIN32
+  char *chunk;
+#else
+  uv_file out_fd;
+#endif
+} file_send_t;
+
+static void file_send_pump(file_send_t *fs);
+
+static void file_send_finish(file_send_t *fs, int status) {
+  ecewo_client_t *client = fs->client;
+
+  if (status < 0)
+    LOG_DEBUG("File send error: %s", uv_strerror(status));
+
+  file_cache_release(fs->file);
+#ifdef _WIN32
+  free(fs->chunk);
+#else
+  if (fs->out_fd >= 0)
+    close(fs->out_fd);
+#endif
+  free(fs->head);
+
+  end_request_seq(client, fs->request_seq);
+  if (client->request_seq == fs->request_seq)
+    server_reply_finished(client);
+
+  // A body cut short leaves the peer waiting for the rest; hang up instead
+  if (status < 0 || !fs->keep_alive)
+    server_close_client(client);
+  else
+    server_response_done(client);
+
+  ecewo_client_unref(client);
+  free(fs);
+}
+
+static bool file_send_client_gone(file_send_t *fs) {
+  return !fs->client->valid || fs->client->closing;
+}
+
+#ifdef _WIN32
+
+static void on_file_chunk_written(uv_write_t *req, int status) {
+  file_send_t *fs = (file_send_t *)req->data;
+  if (status < 0) {
+    file_send_finish(fs, status);
     return;
   }
+  file_send_pump(fs);
+}
 
-  size_t headers_len = strlen(headers);
-  size_t total_len = headers_len + body_len;
+static void on_file_chunk_read(uv_fs_t *req) {
+  file_send_t *fs = (file_send_t *)req->data;
+  ssize_t n = req->result;
+  uv_fs_req_cleanup(req);
 
-  // uv_write() is an async operation, so when ecewo_send() returns
-  // client can send another request and reset the arena,
-  // but uv_write() might not be completed yet.
-  // Therefore write_req and response must be allocated via malloc.
-  // Otherwise, it causes segfault under a high load.
-  // Both freed in write_completion_cb
+  if (file_send_client_gone(fs)) {
+    file_send_finish(fs, UV_ECANCELED);
+    return;
+  }
 
-  char *response = malloc(total_len);
-  if (!response) {
-    send_error(res->arena, res->ecewo__client_socket, 500);
+  // 0 means the file shrank since it was stat'ed
+  if (n <= 0) {
+    file_send_finish(fs, n < 0 ? (int)n : UV_EOF);
     return;
   }
 
-  memcpy(response, headers, headers_len);
-  if (body_len > 0 && body)
-    memcpy(response + headers_len, body, body_len);
+  fs->offset += n;
+  fs->remaining -= (uint64_t)n;
+  metrics_bytes_out(fs->client, (size_t)n);
 
-  write_req_t *write_req = malloc(sizeof(write_req_t));
-  if (!write_req) {
-    free(response);
-    send_error(res->arena, res->ecewo__client_socket, 500);
+  uv_buf_t buf = uv_buf_init(fs->chunk, (unsigned int)n);
+  fs->write_req.data = fs;
+  int r = uv_write(&fs->write_req, (uv_stream_t *)&fs->client->handle, &buf, 1, on_file_chunk_written);
+  if (r < 0)
+    file_send_finish(fs, r);
+}
+
+static void file_send_pump(file_send_t *fs) {
+  if (fs->remaining == 0) {
+    file_send_finish(fs, 0);
     return;
   }
 
-  uv_tcp_t *sock = (uv_tcp_t *)res->ecewo__client_socket;
-  write_req->data = response;
-  write_req->client = (ecewo_client_t *)sock->data;
-  if (write_req->client)
-    ecewo_client_ref(write_req->client);
-  write_req->buf = uv_buf_init(response, (unsigned int)total_len);
+  if (file_send_client_gone(fs)) {
+    file_send_finish(fs, UV_ECANCELED);
+    return;
+  }
 
-  if (uv_is_closing((uv_handle_t *)sock)) {
-    free(response);
-    if (write_req->client)
-      ecewo_client_unref(write_req->client);
-    free(write_req);
+  size_t len = fs->remaining < FILE_SEND_CHUNK_SIZE ? (size_t)fs->remaining : FILE_SEND_CHUNK_SIZE;
+  uv_buf_t buf = uv_buf_init(fs->chunk, (unsigned int)len);
+  fs->fs_req.data = fs;
+  int r = uv_fs_read(fs->client->handle.loop, &fs->fs_req, fs->file->fd, &buf, 1, fs->offset, on_file_chunk_read);
+  if (r < 0)
+    file_send_finish(fs, r);
+}
+
+#else
+
+static void on_file_send_retry(void *user_data) {
+  file_send_pump((file_send_t *)user_data);
+}
+
+static void on_file_sent(uv_fs_t *req) {
+  file_send_t *fs = (file_send_t *)req->data;
+  ssize_t n = req->result;
+  uv_fs_req_cleanup(req);
+
+  if (file_send_client_gone(fs)) {
+    file_send_finish(fs, UV_ECANCELED);
     return;
   }
 
-  int result = uv_write(&write_req->req, (uv_stream_t *)sock,
-                        &write_req->buf, 1, write_completion_cb);
+  // The socket is non-blocking: a full send buffer shows up as EAGAIN.
+  // libuv can't watch the socket for writability while it owns it, so
+  // come back shortly instead.
+  if (n == UV_EAGAIN) {
+    if (!ecewo_timeout(on_file_send_retry, FILE_SEND_RETRY_MS, fs))
+      file_send_finish(fs, UV_ENOMEM);
+    return;
+  }
 
-  if (result < 0) {
-    LOG_DEBUG("Write error: %s", uv_strerror(result));
-    free(response);
+  // 0 means the file shrank since it was stat'ed
+  if (n <= 0) {
+    file_send_finish(fs, n < 0 ? (int)n : UV_EOF);
+    return;
+  }
 
-    if (write_req->client) {
-      end_request(write_req->client);
-      ecewo_client_unref(write_req->client);
-    }
+  fs->offset += n;
+  fs->remaining -= (uint64_t)n;
+  metrics_bytes_out(fs->client, (size_t)n);
+  file_send_pump(fs);
+}
 
-    free(write_req);
+static void file_send_pump(file_send_t *fs) {
+  if (fs->remaining == 0) {
+    file_send_finish(fs, 0);
+    return;
+  }
+
+  if (file_send_client_gone(fs)) {
+    file_send_finish(fs, UV_ECANCELED);
+    return;
+  }
+
+  // Where libuv has to emulate sendfile it blocks a threadpool thread until
+  // the whole length is written, so a slow client must not get it all at once
+  size_t len = fs->remaining < FILE_SEND_CHUNK_SIZE ? (size_t)fs->remaining : FILE_SEND_CHUNK_SIZE;
+  fs->fs_req.data = fs;
+  int r = uv_fs_sendfile(fs->client->handle.loop, &fs->fs_req, fs->out_fd, fs->file->fd, fs->offset, len, on_file_sent);
+  if (r < 0)
+    file_send_finish(fs, r);
+}
+
+#endif
+
+static void on_file_head_written(uv_write_t *req, int status) {
+  file_send_t *fs = (file_send_t *)req->data;
+  if (status < 0) {
+    file_send_finish(fs, status);
+    return;
   }
+  file_send_pump(fs);
+}
+
+// Finds a request header of the connection's current request
+static const char *current_request_header(ecewo_client_t *client, ecewo_header_id_t id) {
+  return http_header_by_id(&client->persistent_context.headers, id);
+}
+
+// If-None-Match uses the weak comparison (RFC 9110 §13.1.2): W/ prefixes are
+// ignored and any listed tag may match.
+static bool etag_list_matches(const char *list, const char *etag) {
+  size_t etag_len = strlen(etag);
+  const char *p = list;
+
+  while (*p) {
+    while (*p == ' ' || *p == '\t' || *p == ',')
+      p++;
+    if (*p == '*')
+      return true;
+    if (p[0] == 'W' && p[1] == '/')
+      p += 2;
+
+    const char *end = strchr(p, ',');
+    size_t len = end ? (size_t)(end - p) : strlen(p);
+    while (len > 0 && (p[len - 1] == ' ' || p[len - 1] == '\t'))
+      len--;
+
+    if (len == etag_len && memcmp(p, etag, len) == 0)
+      return true;
+    if (!end)
+      break;
+    p = end;
+  }
+
+  return false;
+}
+
+static bool has_response_header(const ecewo_response_t *res, const char *name) {
+  size_t name_len = strlen(name);
+  for (uint16_t i = 0; i < res->header_count; i++) {
+    if (res->headers[i].name_len == name_len && strcasecmp(res->headers[i].name, name) == 0)
+      return true;
+  }
+  return false;
+}
+
+// Replies to res with file, which the caller acquired; the transfer
+// releases it
+static int send_file_entry(ecewo_response_t *res, file_cache_entry_t *file) {
+  if (!validate_client_for_response(res)) {
+    // Nothing to answer; the request is handled as far as the caller is concerned
+    file_cache_release(file);
+    res->replied = true;
+    if (res->arena)
+      arena_reset(res->arena);
+    return 0;
+  }
+
+  uv_tcp_t *sock = (uv_tcp_t *)res->ecewo__client_socket;
+  ecewo_client_t *client = (ecewo_client_t *)sock->data;
+
+  // If-Modified-Since only counts when If-None-Match is absent, and is
+  // compared as the exact string previously sent in Last-Modified
+  bool not_modified;
+  const char *inm = current_request_header(client, ECEWO_HDR_IF_NONE_MATCH);
+  if (inm) {
+    not_modified = etag_list_matches(inm, file->etag);
+  } else {
+    const char *ims = current_request_header(client, ECEWO_HDR_IF_MODIFIED_SINCE);
+    not_modified = ims && strcmp(ims, file->last_modified) == 0;
+  }
+
+  int status = not_modified ? 304 : 200;
+
+  if (!not_modified && !has_response_header(res, "Content-Type"))
+    ecewo_header_set(res, "Content-Type", file->content_type);
+
+  // A 304 carries no body and no Content-Length
+  head_t head;
+  head_init(&head, res, status);
+  head.etag = file->etag;
+  head.last_modified = file->last_modified;
+  head.has_length = !not_modified;
+  head.length = file->size;
+
+  // Freed in file_send_finish once the transfer is over
+  file_send_t *fs = calloc(1, sizeof(file_send_t));
+  size_t head_len = head_render(NULL, res, &head);
+  char *head_copy = fs ? malloc(head_len) : NULL;
+#ifdef _WIN32
+  char *chunk = head_copy ? malloc(FILE_SEND_CHUNK_SIZE) : NULL;
+  bool ready = chunk != NULL;
+#else
+  uv_os_fd_t sock_fd;
+  int out_fd = -1;
+  if (head_copy && uv_fileno((uv_handle_t *)sock, &sock_fd) == 0)
+    out_fd = dup(sock_fd);
+  bool ready = out_fd >= 0;
+#endif
+
+  if (!ready) {
+#ifdef _WIN32
+    free(chunk);
+#endif
+    free(head_copy);
+    free(fs);
+    file_cache_release(file);
+    send_error(res->arena, sock, 500);
+    return 0;
+  }
+
+  head_render(head_copy, res, &head);
+  fs->client = client;
+  fs->request_seq = client->request_seq;
+  fs->file = file;
+  fs->head = head_copy;
+  fs->offset = 0;
+  fs->remaining = (not_modified || res->is_head_request) ? 0 : file->size;
+  fs->keep_alive = res->keep_alive;
+#ifdef _WIN32
+  fs->chunk = chunk;
+#else
+  fs->out_fd = out_fd;
+#endif
+  ecewo_client_ref(client);
+
+  // The transfer ends the request and closes the connection if needed on
+  // its own; keep the router from shutting the socket down under it.
+  res->replied = true;
+  res->keep_alive = true;
+
+  if (fs->remaining > 0)
+    client->pipeline_blocked = true;
+
+  response_flush_corked(client);
+
+  reply_started(client, res, status, head_len);
+
+  uv_buf_t buf = uv_buf_init(fs->head, (unsigned int)head_len);
+  fs->write_req.data = fs;
+  int r = uv_write(&fs->write_req, (uv_stream_t *)sock, &buf, 1, on_file_head_written);
+  if (r < 0)
+    file_send_finish(fs, r);
 
   if (res->arena)
     arena_reset(res->arena);
+
+  return 0;
+}
+
+static file_cache_entry_t *cached_file(ecewo_response_t *res, const char *path) {
+  uv_tcp_t *sock = (uv_tcp_t *)res->ecewo__client_socket;
+  return sock ? file_cache_lookup(sock->loop, path) : NULL;
+}
+
+int ecewo_send_file(ecewo_response_t *res, const char *path) {
+  if (!res || !path)
+    return -1;
+
+  if (res->replied || res->stream_mode != STREAM_NONE) {
+    LOG_ERROR("ecewo_send_file(): response already started");
+    return -1;
+  }
+
+  // A file that isn't cached yet is opened right here, since the caller is
+  // told whether it can be served; ecewo_static() goes through
+  // response_send_file_async() instead
+  file_cache_entry_t *file = cached_file(res, path);
+  if (!file)
+    file = file_cache_acquire(path);
+  if (!file)
+    return -1;
+
+  return send_file_entry(res, file);
+}
+
+typedef struct {
+  ecewo_response_t *res;
+  ecewo_client_t *client;
+  uint32_t request_seq;
+  void (*missing)(ecewo_response_t *res);
+} file_open_t;
+
+static void on_file_opened(file_cache_entry_t *file, void *data) {
+  file_open_t *op = (file_open_t *)data;
+  ecewo_client_t *client = op->client;
+  ecewo_response_t *res = op->res;
+
+  // The connection may have been closed and its requests given up meanwhile
+  if (client->request_seq != op->request_seq || res->replied)
+    file_cache_release(file);
+  else if (file)
+    send_file_entry(res, file);
+  else
+    op->missing(res);
+
+  ecewo_client_unref(client);
+  free(op);
+}
+
+// ecewo_send_file() that keeps the open() and stat() of a file not cached
+// yet off the loop: they run on the threadpool, and the reply goes out from
+// there, or missing(res) answers if the file can't be served. Used by
+// ecewo_static(). Returns -1 only if the response was already started.
+int response_send_file_async(ecewo_response_t *res,
+                             const char *path,
+                             void (*missing)(ecewo_response_t *res)) {
+  if (!res || !path || !missing)
+    return -1;
+
+  if (res->replied || res->stream_mode != STREAM_NONE) {
+    LOG_ERROR("ecewo_send_file(): response already started");
+    return -1;
+  }
+
+  file_cache_entry_t *file = cached_file(res, path);
+  if (file)
+    return send_file_entry(res, file);
+
+  if (!validate_client_for_response(res)) {
+    res->replied = true;
+    if (res->arena)
+      arena_reset(res->arena);
+    return 0;
+  }
+
+  uv_tcp_t *sock = (uv_tcp_t *)res->ecewo__client_socket;
+  ecewo_client_t *client = (ecewo_client_t *)sock->data;
+
+  // Freed in on_file_opened
+  file_open_t *op = malloc(sizeof(file_open_t));
+  if (op) {
+    op->res = res;
+    op->client = client;
+    op->request_seq = client->request_seq;
+    op->missing = missing;
+    ecewo_client_ref(client);
+
+    if (file_cache_open(sock->loop, path, on_file_opened, op) == 0)
+      return 0;
+
+    ecewo_client_unref(client);
+    free(op);
+  }
+
+  // Nothing could be queued; open it here after all
+  file = file_cache_acquire(path);
+  if (!file) {
+    missing(res);
+    return 0;
+  }
+  return send_file_entry(res, file);
 }
 
 static bool is_valid_header_char(char c) {
@@ -365,16 +1451,19 @@ static bool is_valid_header_char(char c) {
   return (uc == '\t') || (uc >= 32 && uc <= 126);
 }
 
-static bool is_valid_header_name(const char *name) {
+// Stores the name's length in *len when it is valid
+static bool is_valid_header_name(const char *name, size_t *len) {
   if (!name || !*name)
     return false;
 
-  for (const char *p = name; *p; p++) {
+  const char *p = name;
+  for (; *p; p++) {
     unsigned char c = *p;
     if (!(isalnum(c) || c == '-' || c == '_'))
       return false;
   }
 
+  *len = (size_t)(p - name);
   return true;
 }
 
@@ -393,11 +1482,13 @@ static bool is_reserved_response_header(const char *name) {
   return false;
 }
 
-static bool is_valid_header_value(const char *value) {
+// Stores the value's length in *len when it is valid
+static bool is_valid_header_value(const char *value, size_t *len) {
   if (!value)
     return false;
 
-  for (const char *p = value; *p; p++) {
+  const char *p = value;
+  for (; *p; p++) {
     if (*p == '\r' || *p == '\n') {
       LOG_ERROR("Invalid character in header value: CRLF detected");
       return false;
@@ -409,6 +1500,7 @@ static bool is_valid_header_value(const char *value) {
     }
   }
 
+  *len = (size_t)(p - value);
   return true;
 }
 
@@ -424,12 +1516,15 @@ void ecewo_header_set(ecewo_response_t *res, const char *name, const char *value
     return;
   }
 
-  if (!is_valid_header_name(name)) {
+  size_t name_len;
+  size_t value_len;
+
+  if (!is_valid_header_name(name, &name_len)) {
     LOG_ERROR("Invalid header name: '%s'", name);
     return;
   }
 
-  if (!is_valid_header_value(value)) {
+  if (!is_valid_header_value(value, &value_len)) {
     LOG_ERROR("Invalid header value for '%s'", name);
     return;
   }
@@ -458,17 +1553,174 @@ void ecewo_header_set(ecewo_response_t *res, const char *name, const char *value
     res->header_capacity = new_cap;
   }
 
-  res->headers[res->header_count].name = ecewo_strdup(res->arena, name);
-  res->headers[res->header_count].value = ecewo_strdup(res->arena, value);
-
-  if (!res->headers[res->header_count].name || !res->headers[res->header_count].value) {
+  // Name and value share one allocation, each NUL-terminated
+  char *copy = ecewo_alloc(res->arena, name_len + value_len + 2);
+  if (!copy) {
     LOG_ERROR("Failed to allocate memory in ecewo_header_set");
     return;
   }
 
+  memcpy(copy, name, name_len + 1);
+  memcpy(copy + name_len + 1, value, value_len + 1);
+
+  ecewo__res_header_t *hdr = &res->headers[res->header_count];
+  hdr->name = copy;
+  hdr->name_len = name_len;
+  hdr->value = copy + name_len + 1;
+  hdr->value_len = value_len;
+
   res->header_count++;
 }
 
+// Lays out the wire data again: the template's header lines, one more when
+// name is set, Content-Length, the blank line and body. The old data is
+// read before it is freed, so body may point into it.
+static int template_build(ecewo_response_template_t *tpl,
+                          const char *name,
+                          size_t name_len,
+                          const char *value,
+                          size_t value_len,
+                          const void *body,
+                          size_t body_len) {
+  // A 204 or 304 has neither a body nor a Content-Length
+  bool framed = tpl->status != 204 && tpl->status != 304;
+
+  head_writer_t w = { NULL, 0 };
+  for (int pass = 0; pass < 2; pass++) {
+    w.len = 0;
+    head_put(&w, tpl->wire, tpl->headers_len);
+    if (name)
+      head_put_line(&w, name, name_len, value, value_len);
+    size_t headers_len = w.len;
+
+    if (framed) {
+      char digits[20];
+      char *start = u64_to_dec(digits, body_len);
+      head_put_line(&w, "Content-Length", 14, start, (size_t)(digits + 20 - start));
+    }
+    HEAD_PUT_LITERAL(&w, "\r\n");
+    size_t head_len = w.len;
+    head_put(&w, (const char *)body, body_len);
+
+    if (pass == 0) {
+      // Freed in ecewo_template_free() or by the next rebuild
+      w.out = malloc(w.len ? w.len : 1);
+      if (!w.out)
+        return -1;
+      continue;
+    }
+
+    free(tpl->wire);
+    tpl->wire = w.out;
+    tpl->headers_len = headers_len;
+    tpl->head_len = head_len;
+    tpl->len = w.len;
+  }
+
+  return 0;
+}
+
+ecewo_response_template_t *ecewo_template_new(int status) {
+  if (status < 200 || status > 999) {
+    LOG_ERROR("ecewo_template_new(): status %d can't be sent from a template", status);
+    return NULL;
+  }
+
+  ecewo_response_template_t *tpl = calloc(1, sizeof(ecewo_response_template_t));
+  if (!tpl)
+    return NULL;
+
+  tpl->status = status;
+  if (template_build(tpl, NULL, 0, NULL, 0, NULL, 0) != 0) {
+    free(tpl);
+    return NULL;
+  }
+
+  return tpl;
+}
+
+int ecewo_template_header(ecewo_response_template_t *tpl, const char *name, const char *value) {
+  if (!tpl || tpl->builtin || !name || !value)
+    return -1;
+
+  size_t name_len;
+  size_t value_len;
+
+  if (!is_valid_header_name(name, &name_len)) {
+    LOG_ERROR("Invalid header name: '%s'", name);
+    return -1;
+  }
+
+  if (!is_valid_header_value(value, &value_len)) {
+    LOG_ERROR("Invalid header value for '%s'", name);
+    return -1;
+  }
+
+  if (is_reserved_response_header(name)) {
+    LOG_ERROR("Refusing reserved/framing header '%s' (set by framework)", name);
+    return -1;
+  }
+
+  return template_build(tpl, name, name_len, value, value_len,
+                        tpl->wire + tpl->head_len, tpl->len - tpl->head_len);
+}
+
+int ecewo_template_body(ecewo_response_template_t *tpl, const void *body, size_t body_len) {
+  if (!tpl || tpl->builtin || (body_len > 0 && !body))
+    return -1;
+
+  if ((tpl->status == 204 || tpl->status == 304) && body_len > 0) {
+    LOG_ERROR("ecewo_template_body(): a %d response has no body", tpl->status);
+    return -1;
+  }
+
+  return template_build(tpl, NULL, 0, NULL, 0, body, body_len);
+}
+
+void ecewo_template_free(ecewo_response_template_t *tpl) {
+  if (!tpl || tpl->builtin)
+    return;
+
+  free(tpl->wire);
+  free(tpl);
+}
+
+void ecewo_send_template(ecewo_response_t *res, const ecewo_response_template_t *tpl) {
+  if (!res || !tpl)
+    return;
+
+  if (res->stream_mode != STREAM_NONE) {
+    LOG_ERROR("Response is being streamed; finish it with ecewo_stream_end()");
+    return;
+  }
+
+  res->replied = true;
+
+  if (!validate_client_for_response(res)) {
+    if (res->arena)
+      arena_reset(res->arena);
+    return;
+  }
+
+  head_t head;
+  head_init(&head, res, tpl->status);
+  head.reason = tpl->reason;
+  head.open = true;
+
+  // A HEAD request gets the template's header lines and Content-Length only
+  size_t len = res->is_head_request ? tpl->head_len : tpl->len;
+  reply_send(res, &head, tpl->wire, len, BODY_STATIC, NULL);
+}
+
+// Built-in replies of dispatch() for unmatched requests
+void send_not_found(ecewo_response_t *res) {
+  ecewo_send_template(res, &not_found_template);
+}
+
+void send_method_not_allowed(ecewo_response_t *res) {
+  ecewo_send_template(res, &method_not_allowed_template);
+}
+
 void ecewo_redirect(ecewo_response_t *res, int status, const char *url) {
   if (!res || !url)
     return;
@@ -480,7 +1732,8 @@ void ecewo_redirect(ecewo_response_t *res, int status, const char *url) {
     return;
   }
 
-  if (!is_valid_header_value(url)) {
+  size_t url_len;
+  if (!is_valid_header_value(url, &url_len)) {
     LOG_ERROR("Invalid redirect URL (CRLF detected)");
     ecewo_send_text(res, ECEWO_BAD_REQUEST, "Bad Request");
     return;
@@ -0,0 +1,208 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <stdlib.h>
+#include <string.h>
+#include "route-cache.h"
+
+typedef struct {
+  const char *key; // param name, owned by the route table
+  uint16_t key_len;
+  uint16_t offset; // value position in the path
+  uint16_t len;
+} cached_param_t;
+
+typedef struct {
+  uint64_t hash;
+  ecewo_handler_t handler;
+  void *middleware_ctx;
+  route_stats_t *stats;
+  cached_param_t params[MAX_INLINE_PARAMS];
+  uint16_t path_len;
+  uint8_t method;
+  uint8_t param_count;
+  bool used;
+  bool referenced; // set on every hit, cleared as the CLOCK hand passes
+  char path[ROUTE_CACHE_MAX_PATH];
+} route_cache_entry_t;
+
+typedef struct {
+  route_cache_entry_t ways[ROUTE_CACHE_WAYS];
+  uint8_t hand;
+} route_cache_set_t;
+
+struct route_cache_s {
+  route_cache_set_t *sets;
+  size_t set_mask;
+  uint32_t generation;
+};
+
+route_cache_t *route_cache_create(size_t entries) {
+  if (entries == 0)
+    return NULL;
+
+  size_t set_count = 1;
+  while (set_count * ROUTE_CACHE_WAYS < entries)
+    set_count <<= 1;
+
+  route_cache_t *cache = calloc(1, sizeof(route_cache_t));
+  if (!cache)
+    return NULL;
+
+  cache->sets = calloc(set_count, sizeof(route_cache_set_t));
+  if (!cache->sets) {
+    free(cache);
+    return NULL;
+  }
+
+  cache->set_mask = set_count - 1;
+  return cache;
+}
+
+void route_cache_free(route_cache_t *cache) {
+  if (!cache)
+    return;
+  free(cache->sets);
+  free(cache);
+}
+
+// FNV-1a over the path, seeded with the method
+uint64_t route_cache_hash(llhttp_method_t method, const char *path, size_t path_len) {
+  uint64_t h = 14695981039346656037ull ^ (uint64_t)method;
+  for (size_t i = 0; i < path_len; i++) {
+    h ^= (unsigned char)path[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+static inline route_cache_set_t *set_for(route_cache_t *cache, uint64_t hash) {
+  return &cache->sets[(size_t)(hash ^ (hash >> 32)) & cache->set_mask];
+}
+
+static void invalidate(route_cache_t *cache, uint32_t generation) {
+  for (size_t s = 0; s <= cache->set_mask; s++) {
+    route_cache_set_t *set = &cache->sets[s];
+    for (int w = 0; w < ROUTE_CACHE_WAYS; w++)
+      set->ways[w].used = false;
+    set->hand = 0;
+  }
+  cache->generation = generation;
+}
+
+bool route_cache_lookup(route_cache_t *cache,
+                        uint32_t generation,
+                        uint64_t hash,
+                        llhttp_method_t method,
+                        const char *path,
+                        size_t path_len,
+                        route_match_t *match) {
+  if (!cache || path_len > ROUTE_CACHE_MAX_PATH)
+    return false;
+
+  if (cache->generation != generation) {
+    invalidate(cache, generation);
+    return false;
+  }
+
+  route_cache_set_t *set = set_for(cache, hash);
+  for (int w = 0; w < ROUTE_CACHE_WAYS; w++) {
+    route_cache_entry_t *e = &set->ways[w];
+    if (!e->used || e->hash != hash || e->method != (uint8_t)method || e->path_len != path_len
+        || memcmp(e->path, path, path_len) != 0)
+      continue;
+
+    e->referenced = true;
+
+    match->handler = e->handler;
+    match->middleware_ctx = e->middleware_ctx;
+    match->stats = e->stats;
+    match->params = NULL;
+    match->param_capacity = MAX_INLINE_PARAMS;
+    match->param_count = e->param_count;
+    for (uint8_t i = 0; i < e->param_count; i++) {
+      const cached_param_t *p = &e->params[i];
+      match->inline_params[i].key.data = p->key;
+      match->inline_params[i].key.len = p->key_len;
+      match->inline_params[i].value.data = path + p->offset;
+      match->inline_params[i].value.len = p->len;
+    }
+    return true;
+  }
+
+  return false;
+}
+
+// An empty way if the set has one; otherwise the first way the hand reaches
+// that hasn't been hit since the hand last passed it
+static route_cache_entry_t *pick_victim(route_cache_set_t *set) {
+  for (int w = 0; w < ROUTE_CACHE_WAYS; w++) {
+    if (!set->ways[w].used)
+      return &set->ways[w];
+  }
+
+  for (;;) {
+    route_cache_entry_t *e = &set->ways[set->hand];
+    set->hand = (uint8_t)((set->hand + 1) % ROUTE_CACHE_WAYS);
+    if (!e->referenced)
+      return e;
+    e->referenced = false;
+  }
+}
+
+void route_cache_insert(route_cache_t *cache,
+                        uint64_t hash,
+                        llhttp_method_t method,
+                        const char *path,
+                        size_t path_len,
+                        const route_match_t *match) {
+  if (!cache || !match || path_len > ROUTE_CACHE_MAX_PATH || match->params)
+    return;
+
+  // Values are stored as offsets, so each one has to be a view into path
+  for (uint8_t i = 0; i < match->param_count; i++) {
+    const param_match_t *p = &match->inline_params[i];
+    if (p->value.data < path || p->value.data + p->value.len > path + path_len
+        || p->key.len > UINT16_MAX)
+      return;
+  }
+
+  route_cache_entry_t *e = pick_victim(set_for(cache, hash));
+
+  for (uint8_t i = 0; i < match->param_count; i++) {
+    const param_match_t *p = &match->inline_params[i];
+    e->params[i].key = p->key.data;
+    e->params[i].key_len = (uint16_t)p->key.len;
+    e->params[i].offset = (uint16_t)(p->value.data - path);
+    e->params[i].len = (uint16_t)p->value.len;
+  }
+
+  e->hash = hash;
+  e->handler = match->handler;
+  e->middleware_ctx = match->middleware_ctx;
+  e->stats = match->stats;
+  e->path_len = (uint16_t)path_len;
+  e->method = (uint8_t)method;
+  e->param_count = match->param_count;
+  e->used = true;
+  e->referenced = false;
+  memcpy(e->path, path, path_len);
+}
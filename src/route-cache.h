@@ -0,0 +1,76 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ECEWO_ROUTE_CACHE_H
+#define ECEWO_ROUTE_CACHE_H
+
+#include "route-table.h"
+#include <stdint.h>
+
+// Paths longer than this are never cached; they are stored inline in the
+// entry, and param offsets into them are 16 bits
+#ifndef ROUTE_CACHE_MAX_PATH
+#define ROUTE_CACHE_MAX_PATH 128
+#endif
+
+#if ROUTE_CACHE_MAX_PATH > 65535
+#error "ROUTE_CACHE_MAX_PATH must fit in 16 bits"
+#endif
+
+// Entries per set. A path hashes to one set and may sit in any of its ways;
+// a CLOCK hand per set picks the way to evict.
+#define ROUTE_CACHE_WAYS 4
+
+// Remembers what route_table_match() resolved for recently seen
+// (method, path) pairs: the handler, the middleware context, the stats and
+// where each param value sits in the path. Each worker owns one, so it is
+// only ever touched from a single thread.
+typedef struct route_cache_s route_cache_t;
+
+// Allocates room for at least `entries` entries, rounded up to a power of
+// two sets. Returns NULL for 0 entries or when out of memory.
+route_cache_t *route_cache_create(size_t entries);
+void route_cache_free(route_cache_t *cache);
+
+uint64_t route_cache_hash(llhttp_method_t method, const char *path, size_t path_len);
+
+// Fills match from the entry for (method, path), whose values then point
+// into path. Entries cached under another route table generation are
+// dropped first, so adding a route invalidates the whole cache.
+bool route_cache_lookup(route_cache_t *cache,
+                        uint32_t generation,
+                        uint64_t hash,
+                        llhttp_method_t method,
+                        const char *path,
+                        size_t path_len,
+                        route_match_t *match);
+
+// Stores a match route_table_match() just returned for (method, path).
+// Paths longer than ROUTE_CACHE_MAX_PATH and matches whose params spilled
+// into the arena are skipped.
+void route_cache_insert(route_cache_t *cache,
+                        uint64_t hash,
+                        llhttp_method_t method,
+                        const char *path,
+                        size_t path_len,
+                        const route_match_t *match);
+
+#endif
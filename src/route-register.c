@@ -143,6 +143,13 @@ void ecewo_route_handler(ecewo_route_t *route, ecewo_handler_t handler) {
   info->handler = handler;
   info->middleware_count = (uint16_t)route->mw_count;
   info->middleware = mw;
+  info->pattern = ecewo_strdup(route->app->arena, route->path);
+  if (!info->pattern)
+    return;
+
+  ecewo__server_t *srv = route->app->server;
+  info->next = srv->route_middleware;
+  srv->route_middleware = info;
 
   int result = route_table_add(route->app->server->route_table,
                                route->app->arena,
@@ -166,3 +173,19 @@ void ecewo_route_register(ecewo_app_t *app, ecewo_method_t method, const char *p
     ecewo_route_middleware(r, (ecewo_middleware_t)fns[i]);
   ecewo_route_handler(r, (ecewo_handler_t)fns[count - 1]);
 }
+
+int ecewo_routes_freeze(ecewo_app_t *app) {
+  if (!app || !app->server) {
+    LOG_ERROR("NULL app in ecewo_routes_freeze");
+    return -1;
+  }
+  if (route_table_freeze(app->server->route_table) != 0) {
+    LOG_ERROR("Failed to compile the route table");
+    return -1;
+  }
+  if (middleware_freeze(app->server) != 0) {
+    LOG_ERROR("Failed to build the middleware chains");
+    return -1;
+  }
+  return 0;
+}
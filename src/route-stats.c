@@ -0,0 +1,145 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "route-stats.h"
+#include "server.h"
+#include "uv.h"
+#include <string.h>
+
+#define SUB_COUNT (1 << ROUTE_STATS_SUB_BITS)
+#define HALF_COUNT (1 << (ROUTE_STATS_SUB_BITS - 1))
+
+static int highest_bit(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - __builtin_clzll(v);
+#else
+  int bit = 0;
+  while (v >>= 1)
+    bit++;
+  return bit;
+#endif
+}
+
+static int bucket_index(uint64_t us) {
+  if (us < SUB_COUNT)
+    return (int)us;
+
+  if (us >> ROUTE_STATS_MAX_BITS)
+    return ROUTE_STATS_BUCKETS - 1;
+
+  int bit = highest_bit(us);
+  int shift = bit - (ROUTE_STATS_SUB_BITS - 1);
+  int sub = (int)(us >> shift) - HALF_COUNT;
+  return SUB_COUNT + (bit - ROUTE_STATS_SUB_BITS) * HALF_COUNT + sub;
+}
+
+// Largest value that falls into the bucket
+static uint64_t bucket_upper(int index) {
+  if (index < SUB_COUNT)
+    return (uint64_t)index;
+
+  int k = index - SUB_COUNT;
+  int bit = k / HALF_COUNT + ROUTE_STATS_SUB_BITS;
+  int shift = bit - (ROUTE_STATS_SUB_BITS - 1);
+  uint64_t sub = (uint64_t)(k % HALF_COUNT + HALF_COUNT);
+  return ((sub + 1) << shift) - 1;
+}
+
+route_stats_t *route_stats_create(ecewo_arena_t *arena, ecewo_method_t method, const char *pattern) {
+  route_stats_t *stats = ecewo_alloc(arena, sizeof(route_stats_t));
+  if (!stats)
+    return NULL;
+
+  memset(stats, 0, sizeof(route_stats_t));
+  stats->pattern = ecewo_strdup(arena, pattern);
+  stats->method = method;
+  return stats->pattern ? stats : NULL;
+}
+
+void route_stats_record(route_stats_t *stats, uint64_t started_at) {
+  if (!stats || started_at == 0)
+    return;
+
+  uint64_t us = (uv_hrtime() - started_at) / 1000;
+  atomic_fetch_add_explicit(&stats->buckets[bucket_index(us)], 1, memory_order_relaxed);
+}
+
+void ecewo_route_stats_each(ecewo_app_t *app, ecewo_route_stats_cb_t cb, void *user_data) {
+  if (!app || !app->server || !app->server->route_table || !cb)
+    return;
+
+  for (route_stats_t *s = route_table_stats(app->server->route_table); s; s = s->next)
+    cb(s, user_data);
+}
+
+const char *ecewo_route_stats_pattern(const ecewo_route_stats_t *stats) {
+  return stats ? stats->pattern : NULL;
+}
+
+ecewo_method_t ecewo_route_stats_method(const ecewo_route_stats_t *stats) {
+  return stats ? stats->method : ECEWO_METHOD_GET;
+}
+
+uint64_t ecewo_route_stats_count(const ecewo_route_stats_t *stats) {
+  if (!stats)
+    return 0;
+
+  uint64_t count = 0;
+  for (int i = 0; i < ROUTE_STATS_BUCKETS; i++)
+    count += atomic_load_explicit(&stats->buckets[i], memory_order_relaxed);
+  return count;
+}
+
+uint64_t ecewo_route_stats_percentile(const ecewo_route_stats_t *stats, double percentile) {
+  if (!stats)
+    return 0;
+
+  // Work on a snapshot so the scan sees the same counts the target came from
+  uint64_t counts[ROUTE_STATS_BUCKETS];
+  uint64_t total = 0;
+  for (int i = 0; i < ROUTE_STATS_BUCKETS; i++) {
+    counts[i] = atomic_load_explicit(&stats->buckets[i], memory_order_relaxed);
+    total += counts[i];
+  }
+
+  if (total == 0)
+    return 0;
+
+  if (percentile < 0.0)
+    percentile = 0.0;
+  if (percentile > 100.0)
+    percentile = 100.0;
+
+  // Nearest rank: the smallest value at least percentile% of samples reach
+  double rank = (percentile / 100.0) * (double)total;
+  uint64_t target = (uint64_t)rank;
+  if ((double)target < rank || target == 0)
+    target++;
+
+  uint64_t seen = 0;
+  for (int i = 0; i < ROUTE_STATS_BUCKETS; i++) {
+    seen += counts[i];
+    if (seen >= target)
+      return bucket_upper(i);
+  }
+
+  return bucket_upper(ROUTE_STATS_BUCKETS - 1);
+}
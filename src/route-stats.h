@@ -0,0 +1,55 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ECEWO_ROUTE_STATS_H
+#define ECEWO_ROUTE_STATS_H
+
+#include "ecewo.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Log-linear latency histogram in microseconds, after HdrHistogram: values
+// below 2^ROUTE_STATS_SUB_BITS get a bucket each, and every power of two
+// above that is split into 2^(ROUTE_STATS_SUB_BITS - 1) equal buckets, so a
+// reported percentile is at most 1/8 above the true value. Values beyond
+// 2^32 us (about 71 minutes) land in the last bucket.
+#define ROUTE_STATS_SUB_BITS 4
+#define ROUTE_STATS_MAX_BITS 32
+#define ROUTE_STATS_BUCKETS \
+  ((1 << ROUTE_STATS_SUB_BITS) + (ROUTE_STATS_MAX_BITS - ROUTE_STATS_SUB_BITS) * (1 << (ROUTE_STATS_SUB_BITS - 1)))
+
+// One per registered (method, pattern), allocated from the app arena and
+// linked in registration order. Workers record into it concurrently.
+typedef struct ecewo_route_stats_s route_stats_t;
+
+struct ecewo_route_stats_s {
+  route_stats_t *next;
+  const char *pattern;
+  ecewo_method_t method;
+  atomic_uint_fast64_t buckets[ROUTE_STATS_BUCKETS];
+};
+
+route_stats_t *route_stats_create(ecewo_arena_t *arena, ecewo_method_t method, const char *pattern);
+
+// Records the time since started_at (uv_hrtime()); no-op for a NULL stats
+void route_stats_record(route_stats_t *stats, uint64_t started_at);
+
+#endif
@@ -100,18 +100,82 @@ typedef struct route_node {
 
   ecewo_handler_t handlers[METHOD_COUNT];
   void *middleware_ctx[METHOD_COUNT];
+  route_stats_t *stats[METHOD_COUNT];
   char **route_param_names[METHOD_COUNT];
   uint8_t route_param_count[METHOD_COUNT];
 
   ecewo_handler_t wildcard_handlers[METHOD_COUNT];
   void *wildcard_middleware_ctx[METHOD_COUNT];
+  route_stats_t *wildcard_stats[METHOD_COUNT];
   char **wildcard_param_names[METHOD_COUNT];
   uint8_t wildcard_param_count[METHOD_COUNT];
 } route_node_t;
 
+// -------------------------------------------------------------------------
+// Compiled form
+// -------------------------------------------------------------------------
+//
+// route_table_freeze() turns the tree into two read-only structures:
+//
+//   nodes/edges: the tree flattened into arrays in depth-first order. Each
+//                node's literal children are a contiguous run of edges sorted
+//                by (length, bytes), searched by bisection instead of raxFind
+//   statics:     every route whose pattern has no ':' or '*' segment, keyed
+//                on method + canonical path ("/a/b") in a perfect hash built
+//                with hash-and-displace: the key's hash picks a bucket, the
+//                bucket's displacement picks the slot, and the slot holds at
+//                most one route, so a lookup is one hash and one memcmp
+//
+// Both live in the table's arena. Adding a route drops them; they are
+// rebuilt by the next route_table_freeze() or route_table_match().
+
+#define FLAT_NONE UINT32_MAX
+
+typedef struct {
+  const char *seg;
+  uint32_t len;
+  uint32_t node; // index into nodes
+} flat_edge_t;
+
+typedef struct {
+  const route_node_t *src; // handler and param name tables
+  uint32_t edges; // first literal child in edges
+  uint32_t edge_count;
+  uint32_t param_child; // FLAT_NONE if there is none
+} flat_node_t;
+
+typedef struct {
+  const char *path;
+  uint32_t len;
+  uint32_t hash;
+  int method_idx;
+  ecewo_handler_t handler;
+  void *middleware_ctx;
+  route_stats_t *stats;
+} static_route_t;
+
+typedef struct {
+  flat_node_t *nodes;
+  flat_edge_t *edges;
+  uint32_t node_count;
+  uint32_t edge_count;
+
+  static_route_t *statics;
+  uint32_t static_count;
+  uint32_t *displacement; // per bucket
+  uint32_t bucket_mask;
+  uint32_t *slots; // index + 1 into statics; 0 is empty
+  uint32_t slot_mask;
+} compiled_routes_t;
+
 struct route_table_s {
   route_node_t *root;
   size_t route_count;
+  route_stats_t *stats_head;
+  route_stats_t *stats_tail;
+  ecewo_arena_t *arena; // where the nodes and the compiled form live
+  compiled_routes_t *compiled; // NULL until frozen, and again after a route is added
+  uint32_t generation; // bumped by every route_table_add()
 };
 
 // -------------------------------------------------------------------------
@@ -148,8 +212,9 @@ int tokenize_path(ecewo_arena_t *arena, const char *path, size_t path_len, token
 
     const char *start = p;
 
-    while (p < end && *p != '/')
-      p++;
+    p = memchr(p, '/', (size_t)(end - p));
+    if (!p)
+      p = end;
 
     size_t len = (size_t)(p - start);
     if (len == 0)
@@ -341,30 +406,384 @@ static void route_node_free_rax_cb(void *data) {
   route_node_free_rax((route_node_t *)data);
 }
 
+// Stats survive re-registering a route, so only the first registration
+// of a (method, pattern) creates them
+static int attach_stats(route_table_t *table,
+                        ecewo_arena_t *arena,
+                        route_stats_t **slot,
+                        int method_idx,
+                        const char *path) {
+  if (*slot)
+    return 0;
+
+  route_stats_t *stats = route_stats_create(arena, (ecewo_method_t)method_idx, path);
+  if (!stats)
+    return -1;
+
+  if (table->stats_tail)
+    table->stats_tail->next = stats;
+  else
+    table->stats_head = stats;
+  table->stats_tail = stats;
+
+  *slot = stats;
+  return 0;
+}
+
 // -------------------------------------------------------------------------
-// Tree matching (recursive with backtracking)
+// Compilation
 // -------------------------------------------------------------------------
 
+// Tries per bucket before the slot table is doubled
+#define MAX_DISPLACEMENT 65536
+#define MAX_SLOT_GROWTH 4
+
+// FNV-1a over the path, seeded with the method
+static uint32_t route_hash(const char *path, size_t len, int method_idx) {
+  uint32_t h = 2166136261u ^ (uint32_t)method_idx;
+  for (size_t i = 0; i < len; i++) {
+    h ^= (unsigned char)path[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static inline uint32_t displace(uint32_t hash, uint32_t d) {
+  uint32_t h = hash ^ (d * 0x9e3779b9u);
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  return h;
+}
+
+static uint32_t next_pow2(uint32_t n) {
+  uint32_t p = 1;
+  while (p < n)
+    p <<= 1;
+  return p;
+}
+
+typedef struct {
+  uint32_t nodes;
+  uint32_t edges;
+  uint32_t statics;
+} compile_counts_t;
+
+typedef struct {
+  compiled_routes_t *c;
+  ecewo_arena_t *arena;
+  string_view_t trail[MAX_PATH_SEGMENTS]; // literal segments from the root
+  uint8_t depth;
+} compile_state_t;
+
+static int count_nodes(const route_node_t *node, bool literal_only, compile_counts_t *n) {
+  n->nodes++;
+
+  if (literal_only) {
+    for (int m = 0; m < METHOD_COUNT; m++) {
+      if (node->handlers[m])
+        n->statics++;
+    }
+  }
+
+  if (node->children) {
+    raxIterator it;
+    raxStart(&it, node->children);
+    if (!raxSeek(&it, "^", NULL, 0)) {
+      raxStop(&it);
+      return -1;
+    }
+    while (raxNext(&it)) {
+      n->edges++;
+      if (count_nodes((const route_node_t *)it.data, literal_only, n) != 0) {
+        raxStop(&it);
+        return -1;
+      }
+    }
+    raxStop(&it);
+  }
+
+  if (node->param_child)
+    return count_nodes(node->param_child, false, n);
+
+  return 0;
+}
+
+static int edge_cmp(const void *a, const void *b) {
+  const flat_edge_t *x = a;
+  const flat_edge_t *y = b;
+  if (x->len != y->len)
+    return x->len < y->len ? -1 : 1;
+  return memcmp(x->seg, y->seg, x->len);
+}
+
+// Records the endpoint handlers of a node reached through literal segments
+// only, under the path those segments spell
+static int add_statics(compile_state_t *st, const route_node_t *node) {
+  char *path = NULL;
+  size_t path_len = 0;
+
+  for (int m = 0; m < METHOD_COUNT; m++) {
+    if (!node->handlers[m])
+      continue;
+
+    if (!path) {
+      path_len = st->depth == 0 ? 1 : 0;
+      for (uint8_t i = 0; i < st->depth; i++)
+        path_len += 1 + st->trail[i].len;
+
+      path = ecewo_alloc(st->arena, path_len + 1);
+      if (!path)
+        return -1;
+
+      char *p = path;
+      *p = '/';
+      for (uint8_t i = 0; i < st->depth; i++) {
+        *p++ = '/';
+        memcpy(p, st->trail[i].data, st->trail[i].len);
+        p += st->trail[i].len;
+      }
+      path[path_len] = '\0';
+    }
+
+    static_route_t *r = &st->c->statics[st->c->static_count++];
+    r->path = path;
+    r->len = (uint32_t)path_len;
+    r->hash = route_hash(path, path_len, m);
+    r->method_idx = m;
+    r->handler = node->handlers[m];
+    r->middleware_ctx = node->middleware_ctx[m];
+    r->stats = node->stats[m];
+  }
+
+  return 0;
+}
+
+// Appends node and, depth first, everything below it. The node's literal
+// children take the next run of edges so that they stay contiguous.
+static int flatten_node(compile_state_t *st, const route_node_t *node, bool literal_only, uint32_t *index_out) {
+  compiled_routes_t *c = st->c;
+  uint32_t idx = c->node_count++;
+
+  flat_node_t *fn = &c->nodes[idx];
+  fn->src = node;
+  fn->edges = c->edge_count;
+  fn->edge_count = 0;
+  fn->param_child = FLAT_NONE;
+
+  if (literal_only && add_statics(st, node) != 0)
+    return -1;
+
+  if (node->children) {
+    uint32_t first = c->edge_count;
+    uint32_t count = (uint32_t)raxSize(node->children);
+    c->edge_count += count;
+    fn->edges = first;
+    fn->edge_count = count;
+
+    raxIterator it;
+    raxStart(&it, node->children);
+    if (!raxSeek(&it, "^", NULL, 0)) {
+      raxStop(&it);
+      return -1;
+    }
+
+    for (uint32_t i = 0; i < count && raxNext(&it); i++) {
+      flat_edge_t *e = &c->edges[first + i];
+
+      char *seg = ecewo_alloc(st->arena, it.key_len + 1);
+      if (!seg) {
+        raxStop(&it);
+        return -1;
+      }
+      memcpy(seg, it.key, it.key_len);
+      seg[it.key_len] = '\0';
+      e->seg = seg;
+      e->len = (uint32_t)it.key_len;
+
+      st->trail[st->depth].data = seg;
+      st->trail[st->depth].len = it.key_len;
+      st->depth++;
+      int rc = flatten_node(st, (const route_node_t *)it.data, literal_only, &e->node);
+      st->depth--;
+
+      if (rc != 0) {
+        raxStop(&it);
+        return -1;
+      }
+    }
+    raxStop(&it);
+
+    qsort(&c->edges[first], count, sizeof(flat_edge_t), edge_cmp);
+  }
+
+  if (node->param_child) {
+    uint32_t child;
+    if (flatten_node(st, node->param_child, false, &child) != 0)
+      return -1;
+    c->nodes[idx].param_child = child;
+  }
+
+  *index_out = idx;
+  return 0;
+}
+
+// Places every static route in its own slot. Buckets are placed largest
+// first, each with the first displacement that lands all of its routes in
+// free slots. Scratch space is malloc'd; only the result goes to the arena.
+static int build_static_index(compiled_routes_t *c, ecewo_arena_t *arena) {
+  uint32_t n = c->static_count;
+  if (n == 0)
+    return 0;
+
+  uint32_t bucket_count = next_pow2((n + 1) / 2);
+  uint32_t bucket_mask = bucket_count - 1;
+  uint32_t slot_count = next_pow2(n * 2);
+
+  // Routes grouped by bucket, counting sort
+  uint32_t *bucket_start = calloc(bucket_count + 1, sizeof(uint32_t));
+  uint32_t *members = malloc(sizeof(uint32_t) * n);
+  uint32_t *order = malloc(sizeof(uint32_t) * bucket_count);
+  uint32_t *displacement = calloc(bucket_count, sizeof(uint32_t));
+  uint32_t *slots = NULL;
+  int rc = -1;
+
+  if (!bucket_start || !members || !order || !displacement)
+    goto out;
+
+  for (uint32_t i = 0; i < n; i++)
+    bucket_start[(c->statics[i].hash & bucket_mask) + 1]++;
+  for (uint32_t b = 0; b < bucket_count; b++)
+    bucket_start[b + 1] += bucket_start[b];
+
+  // order doubles as the fill cursor here; it is rewritten below
+  memcpy(order, bucket_start, sizeof(uint32_t) * bucket_count);
+  for (uint32_t i = 0; i < n; i++)
+    members[order[c->statics[i].hash & bucket_mask]++] = i;
+
+  // Non-empty buckets, largest first. Buckets hold two routes on average,
+  // so going over them once per size is cheap.
+  uint32_t max_size = 0;
+  for (uint32_t b = 0; b < bucket_count; b++) {
+    uint32_t size = bucket_start[b + 1] - bucket_start[b];
+    if (size > max_size)
+      max_size = size;
+  }
+
+  uint32_t used_buckets = 0;
+  for (uint32_t size = max_size; size > 0; size--) {
+    for (uint32_t b = 0; b < bucket_count; b++) {
+      if (bucket_start[b + 1] - bucket_start[b] == size)
+        order[used_buckets++] = b;
+    }
+  }
+
+  for (int growth = 0; growth <= MAX_SLOT_GROWTH; growth++, slot_count <<= 1) {
+    free(slots);
+    slots = calloc(slot_count, sizeof(uint32_t));
+    if (!slots)
+      goto out;
+
+    uint32_t slot_mask = slot_count - 1;
+    bool placed_all = true;
+
+    for (uint32_t k = 0; k < used_buckets && placed_all; k++) {
+      uint32_t b = order[k];
+      uint32_t first = bucket_start[b];
+      uint32_t last = bucket_start[b + 1];
+      bool placed = false;
+      for (uint32_t d = 0; d < MAX_DISPLACEMENT && !placed; d++) {
+        uint32_t i = first;
+        for (; i < last; i++) {
+          uint32_t s = displace(c->statics[members[i]].hash, d) & slot_mask;
+          if (slots[s])
+            break;
+          slots[s] = members[i] + 1;
+        }
+        if (i == last) {
+          displacement[b] = d;
+          placed = true;
+        } else {
+          // Undo this attempt
+          while (i-- > first)
+            slots[displace(c->statics[members[i]].hash, d) & slot_mask] = 0;
+        }
+      }
+      placed_all = placed;
+    }
+
+    if (!placed_all)
+      continue;
+
+    c->displacement = ecewo_alloc(arena, sizeof(uint32_t) * bucket_count);
+    c->slots = ecewo_alloc(arena, sizeof(uint32_t) * slot_count);
+    if (!c->displacement || !c->slots)
+      goto out;
+    memcpy(c->displacement, displacement, sizeof(uint32_t) * bucket_count);
+    memcpy(c->slots, slots, sizeof(uint32_t) * slot_count);
+    c->bucket_mask = bucket_mask;
+    c->slot_mask = slot_mask;
+    rc = 0;
+    break;
+  }
+
+out:
+  free(bucket_start);
+  free(members);
+  free(order);
+  free(displacement);
+  free(slots);
+  return rc;
+}
+
+// -------------------------------------------------------------------------
+// Reference matcher (recursive with backtracking)
+// -------------------------------------------------------------------------
+
+static const flat_node_t *find_literal(const compiled_routes_t *c,
+                                       const flat_node_t *node,
+                                       const char *seg,
+                                       size_t len) {
+  const flat_edge_t *lo = c->edges + node->edges;
+  const flat_edge_t *hi = lo + node->edge_count;
+
+  while (lo < hi) {
+    const flat_edge_t *mid = lo + (hi - lo) / 2;
+    int cmp = mid->len != len ? (mid->len < len ? -1 : 1) : memcmp(mid->seg, seg, len);
+    if (cmp == 0)
+      return &c->nodes[mid->node];
+    if (cmp < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return NULL;
+}
+
 // allow_wildcards controls whether wildcard handlers are considered.
 // route_table_match runs two passes: first without wildcards (so endpoint
 // matches via params always beat wildcard-zero matches), then with wildcards.
 //
 // leaf_out: on success, set to the node that owns the matched handler so the
 // caller can retrieve the per-route param name table.
-static bool match_node(route_node_t *node,
+static bool match_node(const compiled_routes_t *c,
+                       const flat_node_t *fn,
                        const tokenized_path_t *path,
                        uint8_t seg_idx,
                        int method_idx,
                        route_match_t *match,
                        ecewo_arena_t *arena,
                        bool allow_wildcards,
-                       route_node_t **leaf_out) {
+                       const route_node_t **leaf_out) {
+  const route_node_t *node = fn->src;
+
   // All segments consumed
   // Check for an endpoint handler
   if (seg_idx == path->count) {
     if (node->handlers[method_idx]) {
       match->handler = node->handlers[method_idx];
       match->middleware_ctx = node->middleware_ctx[method_idx];
+      match->stats = node->stats[method_idx];
       *leaf_out = node;
       return true;
     }
@@ -372,6 +791,7 @@ static bool match_node(route_node_t *node,
     if (allow_wildcards && node->wildcard_handlers[method_idx]) {
       match->handler = node->wildcard_handlers[method_idx];
       match->middleware_ctx = node->wildcard_middleware_ctx[method_idx];
+      match->stats = node->wildcard_stats[method_idx];
       *leaf_out = node;
       return true;
     }
@@ -381,22 +801,20 @@ static bool match_node(route_node_t *node,
   const path_segment_t *seg = &path->segments[seg_idx];
 
   // 1. Literal child (highest priority)
-  if (node->children) {
-    void *child = raxFind(node->children, (unsigned char *)seg->start, seg->len);
-    if (child != raxNotFound) {
-      if (match_node((route_node_t *)child, path, seg_idx + 1, method_idx, match, arena, allow_wildcards, leaf_out))
-        return true;
-    }
+  if (fn->edge_count > 0) {
+    const flat_node_t *child = find_literal(c, fn, seg->start, seg->len);
+    if (child && match_node(c, child, path, seg_idx + 1, method_idx, match, arena, allow_wildcards, leaf_out))
+      return true;
   }
 
   // 2. Param child
-  if (node->param_child) {
+  if (fn->param_child != FLAT_NONE) {
     uint8_t saved = match->param_count;
     if (add_param_to_match(match, arena,
                            NULL, 0,
                            seg->start, seg->len)
         == 0) {
-      if (match_node(node->param_child, path, seg_idx + 1, method_idx, match, arena, allow_wildcards, leaf_out))
+      if (match_node(c, &c->nodes[fn->param_child], path, seg_idx + 1, method_idx, match, arena, allow_wildcards, leaf_out))
         return true;
     }
     match->param_count = saved;
@@ -406,6 +824,7 @@ static bool match_node(route_node_t *node,
   if (allow_wildcards && node->wildcard_handlers[method_idx]) {
     match->handler = node->wildcard_handlers[method_idx];
     match->middleware_ctx = node->wildcard_middleware_ctx[method_idx];
+    match->stats = node->wildcard_stats[method_idx];
     *leaf_out = node;
     return true;
   }
@@ -477,6 +896,7 @@ route_table_t *route_table_create(ecewo_arena_t *arena) {
   if (!table)
     return NULL;
   memset(table, 0, sizeof(route_table_t));
+  table->arena = arena;
   table->root = route_node_create(arena);
   if (!table->root)
     return NULL;
@@ -498,6 +918,10 @@ int route_table_add(route_table_t *table,
     return -1;
   }
 
+  // Rebuilt with the new route on the next freeze or match
+  table->compiled = NULL;
+  table->generation++;
+
   path_segment_t *segs;
   uint8_t seg_count;
   char *pattern_buf;
@@ -535,12 +959,16 @@ int route_table_add(route_table_t *table,
         }
       }
 
+      free(segs);
+      free(pattern_buf);
+
+      if (attach_stats(table, arena, &node->wildcard_stats[method_idx], method_idx, path) != 0)
+        return -1;
+
       node->wildcard_handlers[method_idx] = handler;
       node->wildcard_middleware_ctx[method_idx] = middleware_ctx;
       node->wildcard_param_names[method_idx] = names;
       node->wildcard_param_count[method_idx] = collected_count;
-      free(segs);
-      free(pattern_buf);
       table->route_count++;
       return 0;
     }
@@ -615,68 +1043,328 @@ int route_table_add(route_table_t *table,
     }
   }
 
+  free(segs);
+  free(pattern_buf);
+
+  if (attach_stats(table, arena, &node->stats[method_idx], method_idx, path) != 0)
+    return -1;
+
   node->handlers[method_idx] = handler;
   node->middleware_ctx[method_idx] = middleware_ctx;
   node->route_param_names[method_idx] = names;
   node->route_param_count[method_idx] = collected_count;
-
-  free(segs);
-  free(pattern_buf);
   table->route_count++;
   return 0;
 }
 
-bool route_table_match(route_table_t *table,
-                       llhttp_t *parser,
-                       const tokenized_path_t *tokenized_path,
-                       route_match_t *match,
-                       ecewo_arena_t *arena) {
-  if (!table || !parser || !tokenized_path || !match)
+int route_table_freeze(route_table_t *table) {
+  if (!table || !table->root)
+    return -1;
+
+  if (table->compiled)
+    return 0;
+
+  compile_counts_t n = { 0 };
+  if (count_nodes(table->root, true, &n) != 0)
+    return -1;
+
+  compiled_routes_t *c = ecewo_alloc(table->arena, sizeof(compiled_routes_t));
+  if (!c)
+    return -1;
+  memset(c, 0, sizeof(compiled_routes_t));
+
+  c->nodes = ecewo_alloc(table->arena, sizeof(flat_node_t) * n.nodes);
+  c->edges = n.edges ? ecewo_alloc(table->arena, sizeof(flat_edge_t) * n.edges) : NULL;
+  c->statics = n.statics ? ecewo_alloc(table->arena, sizeof(static_route_t) * n.statics) : NULL;
+  if (!c->nodes || (n.edges && !c->edges) || (n.statics && !c->statics))
+    return -1;
+
+  compile_state_t st = { .c = c, .arena = table->arena, .depth = 0 };
+  uint32_t root;
+  if (flatten_node(&st, table->root, true, &root) != 0)
+    return -1;
+
+  if (build_static_index(c, table->arena) != 0) {
+    // Still correct without it, just slower: statics go through the tree
+    LOG_DEBUG("Could not build the static route index for %" PRIu32 " routes", c->static_count);
+    c->static_count = 0;
+  }
+
+  table->compiled = c;
+  return 0;
+}
+
+bool route_table_match_static(route_table_t *table,
+                              llhttp_t *parser,
+                              const char *path,
+                              size_t path_len,
+                              route_match_t *match) {
+  if (!table || !table->compiled || !parser || !path || !match)
     return false;
 
-  llhttp_method_t method = llhttp_get_method(parser);
-  int method_idx = method_to_index(method);
+  const compiled_routes_t *c = table->compiled;
+  if (c->static_count == 0)
+    return false;
 
+  int method_idx = method_to_index(llhttp_get_method(parser));
   if (method_idx < 0)
     return false;
 
+  uint32_t hash = route_hash(path, path_len, method_idx);
+  uint32_t slot = c->slots[displace(hash, c->displacement[hash & c->bucket_mask]) & c->slot_mask];
+  if (slot == 0)
+    return false;
+
+  const static_route_t *r = &c->statics[slot - 1];
+  if (r->hash != hash || r->method_idx != method_idx || r->len != path_len
+      || memcmp(r->path, path, path_len) != 0)
+    return false;
+
+  match->handler = r->handler;
+  match->middleware_ctx = r->middleware_ctx;
+  match->stats = r->stats;
+  match->param_count = 0;
+  match->params = NULL;
+  match->param_capacity = MAX_INLINE_PARAMS;
+  return true;
+}
+
+// Fills in the deferred param key names from the winning leaf's name table
+static void name_params(route_match_t *match, const route_node_t *leaf, int method_idx, bool is_wildcard) {
+  if (!leaf || match->param_count == 0)
+    return;
+
+  char **names = is_wildcard
+      ? leaf->wildcard_param_names[method_idx]
+      : leaf->route_param_names[method_idx];
+  if (!names)
+    return;
+
+  param_match_t *arr = match->params ? match->params : match->inline_params;
+  for (uint8_t i = 0; i < match->param_count; i++) {
+    arr[i].key.data = names[i];
+    arr[i].key.len = strlen(names[i]);
+  }
+}
+
+static int begin_match(route_table_t *table, llhttp_t *parser, route_match_t *match) {
+  if (!table->compiled && route_table_freeze(table) != 0)
+    return -1;
+
+  int method_idx = method_to_index(llhttp_get_method(parser));
+  if (method_idx < 0)
+    return -1;
+
   match->handler = NULL;
   match->middleware_ctx = NULL;
+  match->stats = NULL;
   match->param_count = 0;
   match->params = NULL;
   match->param_capacity = MAX_INLINE_PARAMS;
+  return method_idx;
+}
 
-  if (!table->root)
-    return false;
-
-  route_node_t *leaf = NULL;
+// One node on the path being tried. Segments are cut from the request path
+// as the walk reaches them, and a frame remembers which of its children it
+// has tried so that backtracking resumes where it left off.
+typedef enum {
+  FRAME_ENTER, // segment not cut yet
+  FRAME_LITERAL, // try the literal child
+  FRAME_PARAM, // try the param child
+  FRAME_DONE, // children exhausted
+} frame_stage_t;
+
+typedef struct {
+  const flat_node_t *node;
+  const char *pos; // where this node's segment starts, slashes included
+  const char *seg; // the segment itself, once cut
+  size_t seg_len;
+  uint8_t stage;
+  bool via_param; // entered through the parent's param child
+} match_frame_t;
+
+// Frames needed for the deepest pattern, plus the node it ends at
+#define MATCH_STACK_DEPTH (MAX_PATH_SEGMENTS + 1)
+
+typedef struct {
+  const route_node_t *node;
+  uint8_t param_count;
+  string_view_t params[MAX_PATH_SEGMENTS];
+} wildcard_candidate_t;
+
+// Values of the params on the path to the top frame
+static uint8_t collect_params(const match_frame_t *stack, int top, string_view_t *out) {
+  uint8_t count = 0;
+  for (int i = 1; i < top; i++) {
+    if (stack[i].via_param) {
+      out[count].data = stack[i - 1].seg;
+      out[count].len = stack[i - 1].seg_len;
+      count++;
+    }
+  }
+  return count;
+}
 
-  // Pass 1: endpoints only (no wildcards): ensures param endpoint matches
-  // always beat wildcard-zero matches at a different tree branch.
-  if (!match_node(table->root, tokenized_path, 0, method_idx, match, arena, false, &leaf)) {
-    // Pass 2: allow wildcard fallback
-    if (!match_node(table->root, tokenized_path, 0, method_idx, match, arena, true, &leaf))
+static bool commit_params(route_match_t *match, ecewo_arena_t *arena, const string_view_t *values, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (add_param_to_match(match, arena, NULL, 0, values[i].data, values[i].len) != 0)
       return false;
   }
+  return true;
+}
+
+bool route_table_match(route_table_t *table,
+                       llhttp_t *parser,
+                       const char *path,
+                       size_t path_len,
+                       route_match_t *match,
+                       ecewo_arena_t *arena) {
+  if (!table || !parser || !path || !match)
+    return false;
+
+  int method_idx = begin_match(table, parser, match);
+  if (method_idx < 0)
+    return false;
+
+  const compiled_routes_t *c = table->compiled;
+  const char *end = path + path_len;
+
+  // Depth-first, literal before param, looking for an endpoint. The first
+  // wildcard the walk passes on its way back up, or that covers the end of
+  // the path, is kept: it is what a second pass allowing wildcards would
+  // find first, and it wins only if no endpoint turns up.
+  match_frame_t stack[MATCH_STACK_DEPTH];
+  wildcard_candidate_t wildcard;
+  wildcard.node = NULL;
+
+  int top = 0;
+  stack[top++] = (match_frame_t){ .node = &c->nodes[0], .pos = path, .stage = FRAME_ENTER };
+
+  while (top > 0) {
+    match_frame_t *f = &stack[top - 1];
+    const route_node_t *node = f->node->src;
+
+    if (f->stage == FRAME_ENTER) {
+      const char *p = f->pos;
+      while (p < end && *p == '/')
+        p++;
+
+      if (p == end) {
+        // All segments consumed
+        if (node->handlers[method_idx]) {
+          string_view_t values[MAX_PATH_SEGMENTS];
+          uint8_t count = collect_params(stack, top, values);
+          if (!commit_params(match, arena, values, count))
+            return false;
+          match->handler = node->handlers[method_idx];
+          match->middleware_ctx = node->middleware_ctx[method_idx];
+          match->stats = node->stats[method_idx];
+          name_params(match, node, method_idx, false);
+          return true;
+        }
+        // Wildcard matches zero remaining segments too
+        if (!wildcard.node && node->wildcard_handlers[method_idx]) {
+          wildcard.node = node;
+          wildcard.param_count = collect_params(stack, top, wildcard.params);
+        }
+        top--;
+        continue;
+      }
+
+      const char *seg_end = memchr(p, '/', (size_t)(end - p));
+      f->seg = p;
+      f->seg_len = (size_t)((seg_end ? seg_end : end) - p);
+      f->stage = FRAME_LITERAL;
+    }
+
+    // A pattern is at most MAX_PATH_SEGMENTS deep, so a full stack means
+    // there are no children to descend into anyway
+    if (top == MATCH_STACK_DEPTH)
+      f->stage = FRAME_DONE;
+
+    if (f->stage == FRAME_LITERAL) {
+      f->stage = FRAME_PARAM;
+      const flat_node_t *child = f->node->edge_count > 0
+          ? find_literal(c, f->node, f->seg, f->seg_len)
+          : NULL;
+      if (child) {
+        stack[top++] = (match_frame_t){ .node = child, .pos = f->seg + f->seg_len, .stage = FRAME_ENTER };
+        continue;
+      }
+    }
 
-  // Fill in the deferred param key names from the winning leaf's name table.
-  if (leaf && match->param_count > 0) {
-    bool is_wildcard = (match->handler == leaf->wildcard_handlers[method_idx]);
-    char **names = is_wildcard
-        ? leaf->wildcard_param_names[method_idx]
-        : leaf->route_param_names[method_idx];
-    if (names) {
-      param_match_t *arr = match->params ? match->params : match->inline_params;
-      for (uint8_t i = 0; i < match->param_count; i++) {
-        arr[i].key.data = names[i];
-        arr[i].key.len = strlen(names[i]);
+    if (f->stage == FRAME_PARAM) {
+      f->stage = FRAME_DONE;
+      if (f->node->param_child != FLAT_NONE) {
+        stack[top++] = (match_frame_t){
+          .node = &c->nodes[f->node->param_child],
+          .pos = f->seg + f->seg_len,
+          .stage = FRAME_ENTER,
+          .via_param = true,
+        };
+        continue;
       }
     }
+
+    // Wildcard (matches all remaining segments)
+    if (!wildcard.node && node->wildcard_handlers[method_idx]) {
+      wildcard.node = node;
+      wildcard.param_count = collect_params(stack, top, wildcard.params);
+    }
+    top--;
   }
 
+  if (!wildcard.node)
+    return false;
+
+  if (!commit_params(match, arena, wildcard.params, wildcard.param_count))
+    return false;
+
+  match->handler = wildcard.node->wildcard_handlers[method_idx];
+  match->middleware_ctx = wildcard.node->wildcard_middleware_ctx[method_idx];
+  match->stats = wildcard.node->wildcard_stats[method_idx];
+  name_params(match, wildcard.node, method_idx, true);
   return true;
 }
 
+bool route_table_match_recursive(route_table_t *table,
+                                 llhttp_t *parser,
+                                 const tokenized_path_t *tokenized_path,
+                                 route_match_t *match,
+                                 ecewo_arena_t *arena) {
+  if (!table || !parser || !tokenized_path || !match)
+    return false;
+
+  int method_idx = begin_match(table, parser, match);
+  if (method_idx < 0)
+    return false;
+
+  const compiled_routes_t *c = table->compiled;
+  const route_node_t *leaf = NULL;
+
+  // Pass 1: endpoints only (no wildcards): ensures param endpoint matches
+  // always beat wildcard-zero matches at a different tree branch.
+  if (match_node(c, &c->nodes[0], tokenized_path, 0, method_idx, match, arena, false, &leaf)) {
+    name_params(match, leaf, method_idx, false);
+    return true;
+  }
+
+  // Pass 2: allow wildcard fallback
+  if (!match_node(c, &c->nodes[0], tokenized_path, 0, method_idx, match, arena, true, &leaf))
+    return false;
+
+  name_params(match, leaf, method_idx, match->handler == leaf->wildcard_handlers[method_idx]);
+  return true;
+}
+
+uint32_t route_table_generation(const route_table_t *table) {
+  return table ? table->generation : 0;
+}
+
+route_stats_t *route_table_stats(route_table_t *table) {
+  return table ? table->stats_head : NULL;
+}
+
 void route_table_free(route_table_t *table) {
   if (!table)
     return;
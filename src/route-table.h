@@ -23,6 +23,7 @@
 #define ECEWO_ROUTE_TABLE_H
 
 #include "ecewo.h"
+#include "route-stats.h"
 #include "llhttp.h"
 
 #ifndef MAX_INLINE_PARAMS
@@ -56,18 +57,48 @@ typedef struct {
 typedef struct {
   ecewo_handler_t handler;
   void *middleware_ctx;
+  route_stats_t *stats;
   param_match_t inline_params[MAX_INLINE_PARAMS];
   param_match_t *params;
   uint8_t param_count;
   uint8_t param_capacity;
 } route_match_t;
 
+// Compiles the table into the flat form route_table_match() walks and a
+// perfect-hash index of the routes without params or wildcards. Adding a
+// route drops it; route_table_match() rebuilds it when it finds it missing.
+int route_table_freeze(route_table_t *table);
+
+// Looks path up, as it came off the wire, among the routes without params
+// or wildcards: one hash and one memcmp. Spellings tokenize_path() would
+// normalize, such as "/a//b" or "/a/", miss and go through
+// route_table_match(). Always misses on a table that isn't frozen.
+bool route_table_match_static(route_table_t *table,
+                              llhttp_t *parser,
+                              const char *path,
+                              size_t path_len,
+                              route_match_t *match);
+
+// Matches path against every route, cutting it into segments as it goes.
+// Iterative, with a fixed-size backtrack stack: literal beats param beats
+// wildcard at each segment, and any endpoint beats any wildcard. The arena
+// is only touched for routes with more than MAX_INLINE_PARAMS params.
 bool route_table_match(route_table_t *table,
                        llhttp_t *parser,
-                       const tokenized_path_t *tokenized_path,
+                       const char *path,
+                       size_t path_len,
                        route_match_t *match,
                        ecewo_arena_t *arena);
 
+// The same match done recursively over a tokenized path, in two passes
+// (endpoints, then wildcards). Kept as the reference for the router
+// benchmark and the fuzz target; the server doesn't use it.
+bool route_table_match_recursive(route_table_t *table,
+                                 llhttp_t *parser,
+                                 const tokenized_path_t *tokenized_path,
+                                 route_match_t *match,
+                                 ecewo_arena_t *arena);
+
 uint8_t route_table_allowed_methods(route_table_t *table,
                                     const tokenized_path_t *path);
 
@@ -78,6 +109,13 @@ int route_table_add(route_table_t *table,
                     ecewo_handler_t handler,
                     void *middleware_ctx);
 
+// Changes whenever a route is added; lets route_cache_lookup() notice that
+// what it remembers may no longer be what route_table_match() returns
+uint32_t route_table_generation(const route_table_t *table);
+
+// Latency stats of every registered route, in registration order
+route_stats_t *route_table_stats(route_table_t *table);
+
 int tokenize_path(ecewo_arena_t *arena, const char *path, size_t path_len, tokenized_path_t *result);
 void route_table_free(route_table_t *table);
 route_table_t *route_table_create(ecewo_arena_t *arena);
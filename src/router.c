@@ -26,10 +26,11 @@
 #include "utils.h"
 #include "request.h"
 #include "logger.h"
-#include <stdlib.h> // for strtol
 
 extern void send_error(ecewo_arena_t *request_arena, uv_tcp_t *ecewo__client_socket, int error_code);
 extern void body_stream_complete(ecewo_request_t *req);
+extern void send_not_found(ecewo_response_t *res);
+extern void send_method_not_allowed(ecewo_response_t *res);
 
 // Extracts URL parameters from a previously matched route
 static int extract_url_params(ecewo_arena_t *arena, const route_match_t *match, ecewo__req_t *url_params) {
@@ -126,17 +127,63 @@ static int populate_req_from_context(ecewo_request_t *req, http_context_t *ctx,
   req->http_minor = ctx->http_minor;
 
   req->headers = &ctx->headers;
-  req->query = &ctx->query_params;
+  req->query_string = ctx->query_string;
+  req->query_len = ctx->query_length;
 
   return 0;
 }
 
+// Whether a body follows the headers, announced by Content-Length or
+// chunked transfer encoding
+static bool message_has_body(const http_context_t *ctx) {
+  return ctx->chunked || ctx->content_length > 0;
+}
+
+// Whether the bytes after the headers run past this message's body, i.e.
+// the client has pipelined more requests behind it. A chunked body can't
+// be measured before it is parsed, so it never counts.
+static bool requests_follow(const http_context_t *ctx, size_t left) {
+  if (ctx->chunked)
+    return false;
+  return left > ctx->content_length;
+}
+
 // Empty handler for running global middleware only (OPTIONS preflight / CORS)
 static void noop_route_handler(ecewo_request_t *req, ecewo_response_t *res) {
   (void)req;
   (void)res;
 }
 
+// Matches routes with params or wildcards, going through the worker's route
+// cache when the app has one
+static bool match_dynamic(ecewo__server_t *srv,
+                          ecewo_client_t *client,
+                          llhttp_t *parser,
+                          const char *path,
+                          size_t path_len,
+                          route_match_t *match,
+                          ecewo_arena_t *arena) {
+  route_cache_t *cache = client && client->worker ? client->worker->route_cache : NULL;
+  if (!cache)
+    return route_table_match(srv->route_table, parser, path, path_len, match, arena);
+
+  llhttp_method_t method = llhttp_get_method(parser);
+  uint64_t hash = route_cache_hash(method, path, path_len);
+  ecewo__metrics_t *m = &client->worker->metrics;
+
+  if (route_cache_lookup(cache, route_table_generation(srv->route_table), hash, method, path, path_len, match)) {
+    metric_counter_add(&m->route_cache_hits, 1);
+    return true;
+  }
+
+  metric_counter_add(&m->route_cache_misses, 1);
+  if (!route_table_match(srv->route_table, parser, path, path_len, match, arena))
+    return false;
+
+  route_cache_insert(cache, hash, method, path, path_len, match);
+  return true;
+}
+
 // Matches a route and invokes the handler/middleware chain.
 static int dispatch(ecewo__server_t *srv,
                     ecewo_arena_t *arena,
@@ -147,6 +194,8 @@ static int dispatch(ecewo__server_t *srv,
                     size_t path_len,
                     ecewo_request_t **req_out,
                     ecewo_response_t **res_out) {
+  uint64_t dispatched_at = uv_hrtime();
+
   ecewo_request_t *req = create_req(arena, handle, srv);
   ecewo_response_t *res = create_res(arena, handle);
   if (!req || !res) {
@@ -156,6 +205,7 @@ static int dispatch(ecewo__server_t *srv,
 
   res->keep_alive = ctx->keep_alive;
   res->is_head_request = (ctx->method_length == 4 && memcmp(ctx->method, "HEAD", 4) == 0);
+  res->http10 = (ctx->http_major == 1 && ctx->http_minor == 0);
 
   if (populate_req_from_context(req, ctx, path, path_len) != 0) {
     send_error(arena, handle, 500);
@@ -169,27 +219,30 @@ static int dispatch(ecewo__server_t *srv,
     *res_out = res;
 
   if (!srv || !srv->route_table || !ctx->method) {
-    ecewo_header_set(res, "Content-Type", "text/plain");
-    ecewo_send(res, 404, "404 Not Found", 13);
+    send_not_found(res);
     return 0;
   }
 
-  tokenized_path_t tok = { 0 };
-  if (tokenize_path(arena, path, path_len, &tok) != 0) {
-    send_error(arena, handle, 500);
-    return -1;
-  }
-
+  // Routes without params or wildcards are found with one hash lookup
   route_match_t match;
-  if (!route_table_match(srv->route_table, ctx->parser, &tok, &match, arena)) {
+  bool matched = route_table_match_static(srv->route_table, ctx->parser, path, path_len, &match)
+      || match_dynamic(srv, client, ctx->parser, path, path_len, &match, arena);
+
+  if (!matched) {
     // OPTIONS preflight: give global middleware a chance (e.g. CORS)
     if (ctx->method_length == 7 && memcmp(ctx->method, "OPTIONS", 7) == 0) {
-      MiddlewareInfo dummy = { NULL, 0, noop_route_handler };
+      MiddlewareInfo dummy = { .handler = noop_route_handler };
       chain_start(req, res, &dummy, srv);
       if (res->replied)
         return 0;
     }
 
+    tokenized_path_t tok = { 0 };
+    if (tokenize_path(arena, path, path_len, &tok) != 0) {
+      send_error(arena, handle, 500);
+      return -1;
+    }
+
     uint8_t allowed = route_table_allowed_methods(srv->route_table, &tok);
     if (allowed) {
       // Generated from ECEWO_METHOD_TABLE; index i matches the method bit set
@@ -214,11 +267,9 @@ static int dispatch(ecewo__server_t *srv,
       }
       allow_buf[pos] = '\0';
       ecewo_header_set(res, "Allow", allow_buf);
-      ecewo_header_set(res, "Content-Type", "text/plain");
-      ecewo_send(res, 405, "405 Method Not Allowed", 22);
+      send_method_not_allowed(res);
     } else {
-      ecewo_header_set(res, "Content-Type", "text/plain");
-      ecewo_send(res, 404, "404 Not Found", 13);
+      send_not_found(res);
     }
     return 0;
   }
@@ -243,56 +294,22 @@ static int dispatch(ecewo__server_t *srv,
     return -1;
   }
 
-  MiddlewareInfo *mw = (MiddlewareInfo *)match.middleware_ctx;
-
-  bool has_stream_middleware = false;
-  if (mw) {
-    for (uint16_t i = 0; i < mw->middleware_count; i++) {
-      if ((void *)mw->middleware[i] == (void *)ecewo_body_stream) {
-        has_stream_middleware = true;
-        break;
-      }
-    }
-  }
-  if (!has_stream_middleware && srv) {
-    for (uint16_t i = 0; i < srv->global_middleware_count; i++) {
-      if ((void *)srv->global_middleware[i].handler == (void *)ecewo_body_stream) {
-        has_stream_middleware = true;
-        break;
-      }
-    }
-  }
-
-  bool is_chunked = false;
-  bool has_body = false;
-  long content_length = 0;
-
-  for (uint16_t i = 0; i < ctx->headers.count; i++) {
-    const char *k = ctx->headers.items[i].key;
-    const char *v = ctx->headers.items[i].value;
+  res->route_stats = match.stats;
+  res->dispatched_at = dispatched_at;
 
-    if (strcasecmp(k, "Content-Length") == 0 && strcmp(v, "0") != 0) {
-      has_body = true;
-      char *endptr;
-      content_length = strtol(v, &endptr, 10);
-      if (endptr == v || *endptr != '\0')
-        content_length = 0;
-    }
+  MiddlewareInfo *mw = (MiddlewareInfo *)match.middleware_ctx;
 
-    if (strcasecmp(k, "Transfer-Encoding") == 0) {
-      has_body = true;
-      is_chunked = true;
-    }
-  }
+  bool has_stream_middleware = middleware_has_body_stream(mw, srv);
 
-  if (!has_stream_middleware && has_body && (content_length >= (long)BUFFERED_BODY_MAX_SIZE || is_chunked)) {
+  // Refused before any of the body is read
+  if (!has_stream_middleware && ctx->body_too_large) {
     ecewo_header_set(res, "Content-Type", "text/plain");
     res->keep_alive = false;
     ecewo_send(res, 413, "Payload Too Large", 17);
     return 0;
   }
 
-  if (!has_stream_middleware && has_body && !ctx->message_complete) {
+  if (!has_stream_middleware && message_has_body(ctx) && !ctx->message_complete) {
     if (client) {
       client->pending_handler = match.handler;
       client->pending_mw = (void *)mw;
@@ -337,7 +354,27 @@ static void run_pending_handler(ecewo_client_t *client, http_context_t *ctx, ece
     client->pending_handler(preq, pres);
 }
 
-int router(ecewo_client_t *client, const char *request_data, size_t request_len) {
+// Body of a request that was answered before its body was read. Skipped so
+// that a pipelined request behind it can still be parsed.
+static int discard_body(void *udata, const uint8_t *chunk, size_t len) {
+  (void)udata;
+  (void)chunk;
+  (void)len;
+  return 0;
+}
+
+// How much of data the parser has gone through. It pauses at the end of
+// every message; if it didn't, everything was used.
+static size_t parsed_length(const http_context_t *ctx, const char *data, size_t len) {
+  const char *pos = llhttp_get_error_pos(ctx->parser);
+  if (ctx->last_error != HPE_PAUSED || !pos || pos < data || pos > data + len)
+    return len;
+  return (size_t)(pos - data);
+}
+
+int router(ecewo_client_t *client, const char *request_data, size_t request_len, size_t *consumed) {
+  *consumed = request_len;
+
   if (!client || !request_data || request_len == 0) {
     if (client)
       send_error(NULL, (uv_tcp_t *)&client->handle, 400);
@@ -371,6 +408,17 @@ int router(ecewo_client_t *client, const char *request_data, size_t request_len)
       path_len = 1;
     }
 
+    // llhttp_get_error_pos() points to where the pause happened
+    // Everything after that has not been parsed yet
+    const char *pause_pos = llhttp_get_error_pos(ctx->parser);
+    size_t headers_len = pause_pos ? (size_t)(pause_pos - request_data) : request_len;
+    size_t left = request_len > headers_len ? request_len - headers_len : 0;
+
+    // More requests are waiting in this buffer; collect the replies the
+    // handlers send synchronously and write them out together
+    if (requests_follow(ctx, left))
+      client->corked = true;
+
     ecewo_request_t *req = NULL;
     ecewo_response_t *res = NULL;
 
@@ -388,31 +436,60 @@ int router(ecewo_client_t *client, const char *request_data, size_t request_len)
       client->stream_res = res;
     }
 
-    // Calculate remaining bytes before touching the parser
-    // llhttp_get_error_pos() points to where the pause happened
-    // Everything after that has not been parsed yet
-    const char *pause_pos = llhttp_get_error_pos(ctx->parser);
-    size_t consumed = pause_pos ? (size_t)(pause_pos - request_data) : request_len;
-    size_t left = request_len > consumed ? request_len - consumed : 0;
-
     llhttp_resume(ctx->parser);
 
     if (res && res->replied) {
-      if (client->taken_over)
+      if (client->taken_over) {
         retval = REQUEST_PENDING;
-      else
-        retval = res->keep_alive ? REQUEST_KEEP_ALIVE : REQUEST_CLOSE;
+        goto done;
+      }
+
+      retval = res->keep_alive ? REQUEST_KEEP_ALIVE : REQUEST_CLOSE;
+      if (retval == REQUEST_CLOSE)
+        goto done;
+
+      if (left == 0 && !message_has_body(ctx)) {
+        ctx->message_complete = true;
+        goto done;
+      }
+
+      // The reply is out and the arena it used has been reset; read past
+      // the body, here and in later reads, to find the next request
+      ctx->on_body_chunk = discard_body;
+      ctx->stream_udata = NULL;
+      client->stream_req = NULL;
+      client->stream_res = NULL;
+      client->request_in_progress = true;
+
+      if (left == 0)
+        goto done;
+
+      switch (http_parse_request(ctx, pause_pos, left)) {
+      case PARSE_SUCCESS:
+        *consumed = parsed_length(ctx, request_data, request_len);
+        break;
+      case PARSE_INCOMPLETE:
+        break;
+      default:
+        retval = REQUEST_CLOSE;
+        break;
+      }
       goto done;
     }
 
     parse_result_t body_result;
-    if (left > 0)
-      body_result = http_parse_request(ctx, pause_pos, left);
-    else
-      body_result = ctx->message_complete ? PARSE_SUCCESS : PARSE_INCOMPLETE;
+    if (left > 0) {
+      body_result = http_parse_body(ctx, pause_pos, left);
+    } else if (!message_has_body(ctx)) {
+      ctx->message_complete = true;
+      body_result = PARSE_SUCCESS;
+    } else {
+      body_result = PARSE_INCOMPLETE;
+    }
 
     switch (body_result) {
     case PARSE_SUCCESS:
+      *consumed = parsed_length(ctx, request_data, request_len);
       if (ctx->on_body_chunk && req) {
         client->stream_req = NULL;
         client->stream_res = NULL;
@@ -440,6 +517,7 @@ int router(ecewo_client_t *client, const char *request_data, size_t request_len)
 
     case PARSE_OVERFLOW:
       LOG_ERROR("Body too large: %s", ctx->error_reason ? ctx->error_reason : "");
+      metrics_parse_error(client, PARSE_OVERFLOW);
       send_error(arena, handle, 413);
       goto done;
 
@@ -448,6 +526,7 @@ int router(ecewo_client_t *client, const char *request_data, size_t request_len)
     default:
       LOG_ERROR("Parse error after resume: %s",
                 ctx->error_reason ? ctx->error_reason : "unknown");
+      metrics_parse_error(client, PARSE_ERROR);
       send_error(arena, handle, 400);
       goto done;
     }
@@ -460,15 +539,18 @@ int router(ecewo_client_t *client, const char *request_data, size_t request_len)
 
   case PARSE_OVERFLOW:
     LOG_ERROR("Request too large: %s", ctx->error_reason ? ctx->error_reason : "");
+    metrics_parse_error(client, PARSE_OVERFLOW);
     send_error(NULL, handle, 413);
     goto done;
 
   case PARSE_ERROR:
     LOG_ERROR("Parse error: %s", ctx->error_reason ? ctx->error_reason : "unknown");
+    metrics_parse_error(client, PARSE_ERROR);
     send_error(NULL, handle, 400);
     goto done;
 
   case PARSE_SUCCESS:
+    *consumed = parsed_length(ctx, request_data, request_len);
     break;
 
   default:
@@ -476,6 +558,12 @@ int router(ecewo_client_t *client, const char *request_data, size_t request_len)
     goto done;
   }
 
+  // The end of a body skipped after an early reply; nothing to dispatch
+  if (ctx->on_body_chunk == discard_body) {
+    retval = REQUEST_KEEP_ALIVE;
+    goto done;
+  }
+
   // A streaming request whose body arrived across multiple TCP reads:
   // the first TCP read parsed headers and started dispatch but the body
   // was not yet complete (PARSE_INCOMPLETE), so body_stream_complete was
@@ -523,6 +611,7 @@ int router(ecewo_client_t *client, const char *request_data, size_t request_len)
   if (http_message_needs_eof(ctx)) {
     if (http_finish_parsing(ctx) != PARSE_SUCCESS) {
       LOG_ERROR("Finish parse failed: %s", ctx->error_reason ? ctx->error_reason : "");
+      metrics_parse_error(client, PARSE_ERROR);
       send_error(arena, handle, 400);
       goto done;
     }
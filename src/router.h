@@ -31,6 +31,9 @@ typedef enum RouterResult {
   REQUEST_PENDING
 } RouterResult;
 
-int router(ecewo_client_t *client, const char *request_data, size_t request_len);
+// Handles the request that starts at request_data (or continues one from an
+// earlier read). Stops after the end of the message and reports in consumed
+// how many bytes it used; the rest belongs to pipelined requests.
+int router(ecewo_client_t *client, const char *request_data, size_t request_len, size_t *consumed);
 
 #endif
@@ -0,0 +1,172 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "scan.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SCAN_X86 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SCAN_AVX2 1
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+static inline int scan_ctz(uint32_t v) {
+  unsigned long index;
+  _BitScanForward(&index, v);
+  return (int)index;
+}
+#else
+static inline int scan_ctz(uint32_t v) {
+  return __builtin_ctz(v);
+}
+#endif
+
+const char *scan_find2_scalar(const char *p, const char *end, char a, char b) {
+  while (p < end && *p != a && *p != b)
+    p++;
+  return p;
+}
+
+#ifdef SCAN_X86
+static const char *scan_find2_sse2(const char *p, const char *end, char a, char b) {
+  const __m128i va = _mm_set1_epi8(a);
+  const __m128i vb = _mm_set1_epi8(b);
+
+  while (end - p >= 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+    __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb));
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+    if (mask)
+      return p + scan_ctz(mask);
+    p += 16;
+  }
+
+  return scan_find2_scalar(p, end, a, b);
+}
+#endif
+
+#ifdef SCAN_AVX2
+__attribute__((target("avx2"))) static const char *scan_find2_avx2(const char *p, const char *end, char a, char b) {
+  const __m256i va = _mm256_set1_epi8(a);
+  const __m256i vb = _mm256_set1_epi8(b);
+
+  while (end - p >= 32) {
+    __m256i chunk = _mm256_loadu_si256((const __m256i *)p);
+    __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, va), _mm256_cmpeq_epi8(chunk, vb));
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(hits);
+    if (mask)
+      return p + scan_ctz(mask);
+    p += 32;
+  }
+
+  // The 16-byte step is repeated here rather than calling the SSE2 kernel:
+  // in this function it is VEX-encoded, and mixing it with legacy SSE code
+  // after touching the upper halves costs a state transition on every call
+  if (end - p >= 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+    __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm256_castsi256_si128(va)),
+                                _mm_cmpeq_epi8(chunk, _mm256_castsi256_si128(vb)));
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+    if (mask)
+      return p + scan_ctz(mask);
+    p += 16;
+  }
+
+  return scan_find2_scalar(p, end, a, b);
+}
+#endif
+
+#ifdef SCAN_NEON
+static const char *scan_find2_neon(const char *p, const char *end, char a, char b) {
+  const uint8x16_t va = vdupq_n_u8((uint8_t)a);
+  const uint8x16_t vb = vdupq_n_u8((uint8_t)b);
+
+  while (end - p >= 16) {
+    uint8x16_t chunk = vld1q_u8((const uint8_t *)p);
+    uint8x16_t hits = vorrq_u8(vceqq_u8(chunk, va), vceqq_u8(chunk, vb));
+    // Narrow each byte to a nibble: bit 4i..4i+3 set for a hit at i
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+    if (mask)
+      return p + (__builtin_ctzll(mask) >> 2);
+    p += 16;
+  }
+
+  return scan_find2_scalar(p, end, a, b);
+}
+#endif
+
+static scan_find2_fn scan_select(const char **name) {
+#if defined(SCAN_AVX2)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    *name = "avx2";
+    return scan_find2_avx2;
+  }
+#endif
+#if defined(SCAN_X86)
+  *name = "sse2";
+  return scan_find2_sse2;
+#elif defined(SCAN_NEON)
+  *name = "neon";
+  return scan_find2_neon;
+#else
+  *name = "scalar";
+  return scan_find2_scalar;
+#endif
+}
+
+static _Atomic(scan_find2_fn) scan_impl;
+static const char *_Atomic scan_impl_name;
+
+static scan_find2_fn scan_resolve(void) {
+  scan_find2_fn impl = atomic_load_explicit(&scan_impl, memory_order_acquire);
+  if (impl)
+    return impl;
+
+  // Every thread that gets here picks the same kernel
+  const char *name = "scalar";
+  impl = scan_select(&name);
+  atomic_store_explicit(&scan_impl_name, name, memory_order_relaxed);
+  atomic_store_explicit(&scan_impl, impl, memory_order_release);
+  return impl;
+}
+
+const char *scan_find2(const char *p, const char *end, char a, char b) {
+  // Short spans (most path segments) aren't worth a call through a pointer
+  if (end - p < 16)
+    return scan_find2_scalar(p, end, a, b);
+
+  return scan_resolve()(p, end, a, b);
+}
+
+const char *scan_kernel_name(void) {
+  scan_resolve();
+  return atomic_load_explicit(&scan_impl_name, memory_order_relaxed);
+}
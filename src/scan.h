@@ -0,0 +1,42 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ECEWO_SCAN_H
+#define ECEWO_SCAN_H
+
+#include <stddef.h>
+
+// Delimiter search for URL, path and query tokenizing. On x86-64 the kernel
+// is AVX2 when the CPU has it and SSE2 otherwise, picked on first use; on
+// AArch64 it is NEON; anything else uses the scalar loop. For a single
+// delimiter, memchr() is already vectorized by the C library.
+
+typedef const char *(*scan_find2_fn)(const char *p, const char *end, char a, char b);
+
+// First byte in [p, end) equal to a or b, or end if there is none
+const char *scan_find2(const char *p, const char *end, char a, char b);
+
+// The portable loop, and the name of the kernel scan_find2() runs; for
+// tests and the microbenchmark
+const char *scan_find2_scalar(const char *p, const char *end, char a, char b);
+const char *scan_kernel_name(void);
+
+#endif
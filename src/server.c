@@ -30,7 +30,11 @@
 #include "middleware.h"
 #include "router.h"
 #include "arena-internal.h"
+#include "file-cache.h"
 #include "logger.h"
+#include "utils.h"
+
+extern void response_flush_corked(ecewo_client_t *client);
 
 const char *ecewo_version(void) {
   return ECEWO_VERSION_STRING;
@@ -74,7 +78,10 @@ static void runtime_cleanup(ecewo__runtime_t *rt);
 static void runtime_register_app(ecewo__runtime_t *rt, ecewo_app_t *app);
 static void runtime_close_handles(ecewo__runtime_t *rt);
 static void server_destroy(ecewo__server_t *srv);
-static void server_shutdown_listener(ecewo__server_t *srv);
+
+// Set on worker threads (workers > 0) for their whole lifetime. NULL on the
+// runtime thread, which hosts worker 0 of every app.
+static ECEWO_THREAD_LOCAL ecewo__worker_t *current_worker;
 
 // ---------------------------------------------------------------------------
 // DATE CACHE HELPERS
@@ -82,47 +89,34 @@ static void server_shutdown_listener(ecewo__server_t *srv);
 
 typedef struct {
   time_t timestamp;
+  size_t date_len;
   char date_str[64];
-  uv_mutex_t mutex;
 } date_cache_t;
 
-static date_cache_t date_cache = { 0 };
-static bool date_cache_initialized = false;
-
-static void init_date_cache(void) {
-  if (date_cache_initialized)
-    return;
-
-  uv_mutex_init(&date_cache.mutex);
-  date_cache.timestamp = 0;
-  date_cache_initialized = true;
-}
-
-static void destroy_date_cache(void) {
-  if (!date_cache_initialized)
-    return;
+// One cache per thread, so worker loops format the Date header without
+// sharing (or locking) anything.
+static ECEWO_THREAD_LOCAL date_cache_t date_cache;
 
-  uv_mutex_destroy(&date_cache.mutex);
-  date_cache_initialized = false;
+static void format_date(time_t now) {
+  struct tm gmt;
+#ifdef _WIN32
+  gmtime_s(&gmt, &now);
+#else
+  gmtime_r(&now, &gmt);
+#endif
+  date_cache.date_len = strftime(date_cache.date_str, sizeof(date_cache.date_str),
+                                 "%a, %d %b %Y %H:%M:%S GMT", &gmt);
+  date_cache.timestamp = now;
 }
 
-const char *get_cached_date(void) {
+const char *get_cached_date(size_t *len) {
   time_t now = time(NULL);
 
-  if (date_cache.timestamp == now)
-    return date_cache.date_str;
-
-  uv_mutex_lock(&date_cache.mutex);
-
-  if (date_cache.timestamp != now) {
-    struct tm *gmt = gmtime(&now);
-    strftime(date_cache.date_str, sizeof(date_cache.date_str),
-             "%a, %d %b %Y %H:%M:%S GMT", gmt);
-    date_cache.timestamp = now;
-  }
-
-  uv_mutex_unlock(&date_cache.mutex);
+  if (date_cache.timestamp != now)
+    format_date(now);
 
+  if (len)
+    *len = date_cache.date_len;
   return date_cache.date_str;
 }
 
@@ -131,7 +125,12 @@ static void client_free_server(ecewo_client_t *client) {
     return;
   if (client->connection_arena)
     ecewo_arena_return(client->connection_arena);
-  free(client->buffer); // safe on NULL; allocated lazily in server_alloc_buffer
+  // Read buffers are plain malloc() blocks, and the worker's pool may be
+  // gone by now
+  free(client->buffer);
+  free(client->header_block);
+  free(client->pipeline_buf);
+  free(client->cork_buf);
   free(client); // ref-counted; freed here when the count reaches zero
 }
 
@@ -149,22 +148,22 @@ void ecewo_client_unref(ecewo_client_t *client) {
     client_free_server(client);
 }
 
-static void add_ecewo_client_to_list(ecewo__server_t *srv, ecewo_client_t *client) {
+static void add_ecewo_client_to_list(ecewo__worker_t *w, ecewo_client_t *client) {
   client->prev = NULL;
-  client->next = srv->client_list_head;
-  if (srv->client_list_head)
-    srv->client_list_head->prev = client;
-  srv->client_list_head = client;
+  client->next = w->client_list_head;
+  if (w->client_list_head)
+    w->client_list_head->prev = client;
+  w->client_list_head = client;
 }
 
-static void remove_client_from_list(ecewo__server_t *srv, ecewo_client_t *client) {
+static void remove_client_from_list(ecewo__worker_t *w, ecewo_client_t *client) {
   if (!client)
     return;
 
   if (client->prev)
     client->prev->next = client->next;
-  else if (srv->client_list_head == client)
-    srv->client_list_head = client->next;
+  else if (w->client_list_head == client)
+    w->client_list_head = client->next;
 
   if (client->next)
     client->next->prev = client->prev;
@@ -190,17 +189,22 @@ static void on_client_closed(uv_handle_t *handle) {
     cb(handle);
   }
 
-  ecewo__server_t *srv = client->srv;
-  if (srv) {
-    remove_client_from_list(srv, client);
-    if (srv->active_connections > 0)
-      srv->active_connections--;
-
-    if (srv->shutdown_requested && srv->active_connections == 0
-        && srv->force_close_timer) {
-      uv_timer_stop(srv->force_close_timer);
-      uv_close((uv_handle_t *)srv->force_close_timer, (uv_close_cb)free);
-      srv->force_close_timer = NULL;
+  ecewo__worker_t *w = client->worker;
+  if (w) {
+    timer_wheel_disarm(&w->timeouts, &client->idle_timer);
+    timer_wheel_disarm(&w->timeouts, &client->request_timer);
+    remove_client_from_list(w, client);
+    if (w->active_connections > 0) {
+      w->active_connections--;
+      atomic_fetch_sub_explicit(&w->srv->active_connections, 1, memory_order_relaxed);
+      metric_counter_add(&w->metrics.connections_closed, 1);
+    }
+
+    if (w->shutdown_started && w->active_connections == 0
+        && w->force_close_timer) {
+      uv_timer_stop(w->force_close_timer);
+      uv_close((uv_handle_t *)w->force_close_timer, (uv_close_cb)free);
+      w->force_close_timer = NULL;
     }
   }
 
@@ -236,12 +240,15 @@ static void close_client(ecewo_client_t *client) {
   if (!client || client->closing)
     return;
 
-  if (client->request_timeout_timer) {
-    uv_timer_stop(client->request_timeout_timer);
-    uv_close((uv_handle_t *)client->request_timeout_timer, (uv_close_cb)free);
-    client->request_timeout_timer = NULL;
+  if (client->worker) {
+    timer_wheel_disarm(&client->worker->timeouts, &client->idle_timer);
+    timer_wheel_disarm(&client->worker->timeouts, &client->request_timer);
   }
 
+  // Stream bytes corked for this loop iteration go out before the shutdown
+  if (!client->taken_over)
+    response_flush_corked(client);
+
   client->closing = true;
   client->valid = false;
 
@@ -278,66 +285,32 @@ static void close_client(ecewo_client_t *client) {
   }
 }
 
-static void cleanup_idle_connections(uv_timer_t *handle) {
-  ecewo__server_t *srv = (ecewo__server_t *)handle->data;
-  if (!srv || srv->shutdown_requested)
-    return;
-
-  uint64_t idle_timeout = srv->app->idle_timeout_ms;
-  uv_loop_t *loop = srv->runtime ? srv->runtime->loop : NULL;
-  uint64_t now = loop ? uv_now(loop) : 0;
-  ecewo_client_t *current = srv->client_list_head;
-
-  while (current) {
-    ecewo_client_t *next = current->next;
+// Reads only move last_activity; the entry is re-armed for the remainder
+// when it fires, so traffic on a busy connection never touches the wheel.
+static void on_idle_timeout(timer_wheel_entry_t *entry) {
+  ecewo_client_t *client = (ecewo_client_t *)entry->data;
+  ecewo__worker_t *w = client->worker;
 
-    if (current->taken_over) {
-      current = next;
-      continue;
-    }
-
-    if (current->keep_alive_enabled && !current->closing) {
-      uint64_t idle_time = now - current->last_activity;
-      if (idle_time > idle_timeout)
-        close_client(current);
-    }
-    current = next;
-  }
-}
-
-static int start_cleanup_timer(ecewo__server_t *srv) {
-  if (!srv || !srv->runtime || !srv->runtime->loop)
-    return -1;
-
-  // libuv handle; freed via uv_close(handle, (uv_close_cb)free).
-  srv->cleanup_timer = malloc(sizeof(uv_timer_t));
-  if (!srv->cleanup_timer)
-    return -1;
-
-  if (uv_timer_init(srv->runtime->loop, srv->cleanup_timer) != 0) {
-    free(srv->cleanup_timer);
-    srv->cleanup_timer = NULL;
-    return -1;
-  }
-
-  srv->cleanup_timer->data = srv;
+  if (client->closing || client->taken_over || w->shutdown_started)
+    return;
 
-  uint64_t interval = srv->app->cleanup_interval_ms;
-  if (uv_timer_start(srv->cleanup_timer, cleanup_idle_connections, interval, interval) != 0) {
-    uv_close((uv_handle_t *)srv->cleanup_timer, (uv_close_cb)free);
-    srv->cleanup_timer = NULL;
-    return -1;
+  uint64_t idle_timeout = w->srv->app->idle_timeout_ms;
+  uint64_t idle_time = uv_now(w->loop) - client->last_activity;
+  if (idle_timeout > 0 && idle_time < idle_timeout) {
+    timer_wheel_arm(&w->timeouts, entry, idle_timeout - idle_time);
+    return;
   }
 
-  return 0;
+  atomic_fetch_add_explicit(&w->srv->timeout_expirations, 1, memory_order_relaxed);
+  close_client(client);
 }
 
-static void stop_cleanup_timer(ecewo__server_t *srv) {
-  if (srv->cleanup_timer) {
-    uv_timer_stop(srv->cleanup_timer);
-    uv_close((uv_handle_t *)srv->cleanup_timer, (uv_close_cb)free);
-    srv->cleanup_timer = NULL;
-  }
+static void start_idle_timer(ecewo_client_t *client) {
+  ecewo__worker_t *w = client->worker;
+  uint64_t idle_timeout = w->srv->app->idle_timeout_ms;
+
+  if (idle_timeout > 0 && !timer_wheel_armed(&client->idle_timer))
+    timer_wheel_arm(&w->timeouts, &client->idle_timer, idle_timeout);
 }
 
 void ecewo_increment_async_work(void) {
@@ -455,11 +428,11 @@ static void close_walk_cb(uv_handle_t *handle, void *arg) {
 }
 
 static void on_server_closed(uv_handle_t *handle) {
-  ecewo__server_t *srv = (ecewo__server_t *)handle->data;
+  ecewo__worker_t *w = (ecewo__worker_t *)handle->data;
   free(handle); // tcp_server libuv handle; freed here after uv_close completes
-  if (srv) {
-    srv->tcp_server = NULL;
-    srv->server_closed = true;
+  if (w) {
+    w->tcp_server = NULL;
+    w->server_closed = true;
   }
 }
 
@@ -468,15 +441,15 @@ static void on_async_work_noop(uv_async_t *handle) {
 }
 
 static void on_force_close_timeout(uv_timer_t *handle) {
-  ecewo__server_t *srv = (ecewo__server_t *)handle->data;
+  ecewo__worker_t *w = (ecewo__worker_t *)handle->data;
   uv_timer_stop(handle);
   uv_close((uv_handle_t *)handle, (uv_close_cb)free);
-  if (!srv)
+  if (!w)
     return;
 
-  srv->force_close_timer = NULL;
+  w->force_close_timer = NULL;
 
-  ecewo_client_t *current = srv->client_list_head;
+  ecewo_client_t *current = w->client_list_head;
   while (current) {
     ecewo_client_t *next = current->next;
     if (!current->closing && !uv_is_closing((uv_handle_t *)&current->handle))
@@ -485,34 +458,26 @@ static void on_force_close_timeout(uv_timer_t *handle) {
   }
 }
 
-// Per-app shutdown: stop the listener, close idle connections, arm a force-close
-// timer for in-progress ones, fire the atexit callback, and unregister the app
-// from the runtime. Safe to call from inside a request handler. Does not run
-// any nested uv_run; the loop simply exits naturally once the app's handles
-// drain and any other registered apps have also shut down.
-void ecewo_shutdown(ecewo_app_t *app) {
-  if (!app || !app->server)
-    return;
-
-  ecewo__server_t *srv = app->server;
-  ecewo__runtime_t *rt = srv->runtime;
+static void worker_close_listener(ecewo__worker_t *w) {
+  if (w->tcp_server && !uv_is_closing((uv_handle_t *)w->tcp_server)) {
+    w->tcp_server->data = w;
+    uv_close((uv_handle_t *)w->tcp_server, on_server_closed);
+  }
+}
 
-  if (srv->shutdown_requested)
+// Runs on the worker's own thread: stop accepting, close idle connections and
+// arm the force-close backstop for the ones still serving a request.
+static void worker_shutdown(ecewo__worker_t *w) {
+  if (w->shutdown_started)
     return;
 
-  srv->shutdown_requested = true;
-  srv->running = false;
-
-  server_shutdown_listener(srv);
+  w->shutdown_started = true;
 
-  // Unref cleanup timer so it no longer keeps the loop alive.
-  // stop_cleanup_timer() in server_destroy() will fully close it.
-  if (srv->cleanup_timer)
-    uv_unref((uv_handle_t *)srv->cleanup_timer);
+  worker_close_listener(w);
 
   // Close idle connections immediately; in-progress ones close themselves
   // when their request finishes. The force-close timer is the backstop.
-  ecewo_client_t *current = srv->client_list_head;
+  ecewo_client_t *current = w->client_list_head;
   while (current) {
     ecewo_client_t *next = current->next;
     if (!current->request_in_progress && !current->closing)
@@ -522,17 +487,62 @@ void ecewo_shutdown(ecewo_app_t *app) {
 
   // Arm a hard timeout as backstop for connections that take too long.
   // on_client_closed() cancels it early once all connections drain.
-  if (srv->active_connections > 0 && rt && rt->loop) {
+  if (w->active_connections > 0) {
     // libuv handle; freed via uv_close in on_client_closed once all connections drain.
-    srv->force_close_timer = malloc(sizeof(uv_timer_t));
-    if (srv->force_close_timer) {
-      uv_timer_init(rt->loop, srv->force_close_timer);
-      srv->force_close_timer->data = srv;
-      uv_timer_start(srv->force_close_timer, on_force_close_timeout,
-                     srv->app->shutdown_timeout_ms, 0);
+    w->force_close_timer = malloc(sizeof(uv_timer_t));
+    if (w->force_close_timer) {
+      uv_timer_init(w->loop, w->force_close_timer);
+      w->force_close_timer->data = w;
+      uv_timer_start(w->force_close_timer, on_force_close_timeout,
+                     w->srv->app->shutdown_timeout_ms, 0);
     }
   }
 
+  if (w->index > 0 && !uv_is_closing((uv_handle_t *)&w->wakeup))
+    uv_close((uv_handle_t *)&w->wakeup, NULL);
+}
+
+static void on_worker_wakeup(uv_async_t *handle) {
+  worker_shutdown((ecewo__worker_t *)handle->data);
+}
+
+// Per-app shutdown: stop the listeners, close idle connections, arm a
+// force-close timer for in-progress ones, fire the atexit callback, and
+// unregister the app from the runtime. Safe to call from inside a request
+// handler. Does not run any nested uv_run; the loop simply exits naturally
+// once the app's handles drain and any other registered apps have also shut
+// down.
+void ecewo_shutdown(ecewo_app_t *app) {
+  if (!app || !app->server)
+    return;
+
+  ecewo__server_t *srv = app->server;
+  ecewo__runtime_t *rt = srv->runtime;
+
+  // Called from a worker thread: everything below belongs to the runtime
+  // thread, so hand the request over to it. rt->shutdown_async outlives every
+  // live app, and this app is still live.
+  if (current_worker) {
+    if (rt && !atomic_exchange(&srv->shutdown_forwarded, true))
+      uv_async_send(&rt->shutdown_async);
+    return;
+  }
+
+  if (srv->shutdown_requested)
+    return;
+
+  srv->shutdown_requested = true;
+  srv->running = false;
+
+  // Worker 0 shares this thread; the others shut down on their own loops.
+  for (int i = 0; i < srv->worker_count; i++) {
+    ecewo__worker_t *w = &srv->workers[i];
+    if (i == 0)
+      worker_shutdown(w);
+    else if (w->thread_started)
+      uv_async_send(&w->wakeup);
+  }
+
   // Fire the per-app atexit callback while the loop is still valid.
   // Safe here because we don't tear down the loop ourselves.
   if (srv->atexit_cb) {
@@ -557,28 +567,144 @@ void ecewo_shutdown(ecewo_app_t *app) {
   // once all apps' handles + async_work_handle close or unref.
 }
 
-static void server_shutdown_listener(ecewo__server_t *srv) {
-  if (!srv)
-    return;
+// Flushes every client whose stream writes were corked during this loop
+// iteration. Check handles run right after the poll phase, so the bytes a
+// round of callbacks produced go out in one write per connection.
+static void on_flush_check(uv_check_t *handle) {
+  ecewo__worker_t *w = (ecewo__worker_t *)handle->data;
+
+  ecewo_client_t *client = w->flush_list;
+  w->flush_list = NULL;
+  uv_check_stop(handle);
+
+  while (client) {
+    ecewo_client_t *next = client->flush_next;
+    client->flush_next = NULL;
+    client->flush_scheduled = false;
 
-  if (srv->tcp_server && !uv_is_closing((uv_handle_t *)srv->tcp_server)) {
-    srv->tcp_server->data = srv;
-    uv_close((uv_handle_t *)srv->tcp_server, on_server_closed);
+    response_flush_corked(client);
+    ecewo_client_unref(client);
+    client = next;
   }
 }
 
+static int flush_check_init(ecewo__worker_t *w) {
+  // libuv handle; freed via uv_close(handle, (uv_close_cb)free) in flush_check_close
+  w->flush_check = malloc(sizeof(uv_check_t));
+  if (!w->flush_check)
+    return -1;
+
+  if (uv_check_init(w->loop, w->flush_check) != 0) {
+    free(w->flush_check);
+    w->flush_check = NULL;
+    return -1;
+  }
+
+  w->flush_check->data = w;
+  return 0;
+}
+
+// The loop is no longer serving requests; corked bytes still waiting are
+// dropped along with their connections
+static void flush_check_close(ecewo__worker_t *w) {
+  while (w->flush_list) {
+    ecewo_client_t *client = w->flush_list;
+    w->flush_list = client->flush_next;
+    client->flush_next = NULL;
+    client->flush_scheduled = false;
+    ecewo_client_unref(client);
+  }
+
+  if (!w->flush_check)
+    return;
+
+  uv_check_stop(w->flush_check);
+  uv_close((uv_handle_t *)w->flush_check, (uv_close_cb)free);
+  w->flush_check = NULL;
+}
+
+// Queues the client's corked bytes for the end of this loop iteration.
+// Returns false if the worker has no check handle; the caller then flushes
+// right away.
+bool server_schedule_flush(ecewo_client_t *client) {
+  ecewo__worker_t *w = client->worker;
+  if (!w || !w->flush_check)
+    return false;
+
+  if (client->flush_scheduled)
+    return true;
+
+  if (!w->flush_list && uv_check_start(w->flush_check, on_flush_check) != 0)
+    return false;
+
+  ecewo_client_ref(client);
+  client->flush_scheduled = true;
+  client->flush_next = w->flush_list;
+  w->flush_list = client;
+  return true;
+}
+
 #ifdef ECEWO_DEBUG
 static void inspect_loop(uv_loop_t *loop);
 #endif
 
+// Closes and frees the private loop of a worker > 0. Its thread has either
+// exited or never started, so nothing else is touching the loop.
+static void worker_loop_destroy(ecewo__worker_t *w) {
+  if (!w->loop)
+    return;
+
+  timer_wheel_close(&w->timeouts);
+  flush_check_close(w);
+  worker_close_listener(w);
+  if (!uv_is_closing((uv_handle_t *)&w->wakeup))
+    uv_close((uv_handle_t *)&w->wakeup, NULL);
+
+  uv_walk(w->loop, close_walk_cb, NULL);
+  while (uv_run(w->loop, UV_RUN_DEFAULT) != 0)
+    ;
+
+  int result = uv_loop_close(w->loop);
+  if (result != 0)
+    LOG_ERROR("uv_loop_close failed: %s", uv_strerror(result));
+
+  free(w->loop);
+  w->loop = NULL;
+}
+
 // Frees per-app resources after the loop has exited. Must be called only when
 // the event loop is no longer running, since it returns the app arena.
 static void server_destroy(ecewo__server_t *srv) {
   if (!srv || !srv->initialized)
     return;
 
-  // Fully close the cleanup timer (was only unref'd in ecewo_shutdown).
-  stop_cleanup_timer(srv);
+  for (int i = 0; i < srv->worker_count; i++) {
+    ecewo__worker_t *w = &srv->workers[i];
+
+    route_cache_free(w->route_cache);
+    w->route_cache = NULL;
+
+    if (i > 0) {
+      worker_loop_destroy(w);
+    } else {
+      // The loop has exited, so nothing is armed any more
+      timer_wheel_close(&w->timeouts);
+      flush_check_close(w);
+
+      if (w->tcp_server && !w->server_closed) {
+        free(w->tcp_server);
+        w->tcp_server = NULL;
+      }
+    }
+
+    // Every write has completed, so all blocks are back in the pool
+    write_pool_destroy(&w->write_pool);
+    read_pool_destroy(&w->read_pool);
+  }
+
+  free(srv->workers);
+  srv->workers = NULL;
+  srv->worker_count = 0;
 
   // Router cleanup
   if (srv->route_table) {
@@ -593,11 +719,6 @@ static void server_destroy(ecewo__server_t *srv) {
     srv->app->arena = NULL;
   }
 
-  if (srv->tcp_server && !srv->server_closed) {
-    free(srv->tcp_server);
-    srv->tcp_server = NULL;
-  }
-
   srv->initialized = false;
 }
 
@@ -645,6 +766,16 @@ static void on_async_shutdown(uv_async_t *handle) {
   if (!rt->initialized)
     return;
 
+  if (!rt->shutdown_requested) {
+    // Woken by ecewo_shutdown() on a worker thread: only the apps that asked
+    for (size_t i = 0; i < rt->app_count; i++) {
+      ecewo_app_t *app = rt->apps[i];
+      if (app && app->server && atomic_load(&app->server->shutdown_forwarded))
+        ecewo_shutdown(app);
+    }
+    return;
+  }
+
   runtime_shutdown_all_apps(rt);
   runtime_close_handles(rt);
 }
@@ -712,16 +843,18 @@ int ecewo_connection_takeover(ecewo_response_t *res, const ecewo_takeover_config
     return -1;
   }
 
+  // Replies corked for earlier pipelined requests go before whatever the
+  // new owner writes
+  response_flush_corked(client);
   uv_read_stop((uv_stream_t *)handle);
 
   client->taken_over = true;
   client->takeover_user_data = config->user_data;
   client->takeover_close_cb = (void (*)(uv_handle_t *))config->close_cb;
   client->request_in_progress = false;
-  if (client->request_timeout_timer) {
-    uv_timer_stop(client->request_timeout_timer);
-    uv_close((uv_handle_t *)client->request_timeout_timer, (uv_close_cb)free);
-    client->request_timeout_timer = NULL;
+  if (client->worker) {
+    timer_wheel_disarm(&client->worker->timeouts, &client->idle_timer);
+    timer_wheel_disarm(&client->worker->timeouts, &client->request_timer);
   }
 
   res->replied = true;
@@ -823,28 +956,23 @@ static void inspect_loop(uv_loop_t *loop) {
 }
 #endif
 
-static void on_request_timeout(uv_timer_t *handle) {
-  ecewo_client_t *client = (ecewo_client_t *)handle->data;
+static void on_request_timeout(timer_wheel_entry_t *entry) {
+  ecewo_client_t *client = (ecewo_client_t *)entry->data;
 
   LOG_ERROR("Request timeout - closing connection");
 
-  if (client) {
-    if (client->connection_arena)
-      arena_reset(client->connection_arena);
-
-    client->request_timeout_timer = NULL;
-    close_client(client);
-  }
+  if (client->connection_arena)
+    arena_reset(client->connection_arena);
 
-  uv_timer_stop(handle);
-  uv_close((uv_handle_t *)handle, (uv_close_cb)free);
+  atomic_fetch_add_explicit(&client->srv->timeout_expirations, 1, memory_order_relaxed);
+  close_client(client);
 }
 
 static void stop_request_timer(ecewo_client_t *client) {
-  if (!client || !client->request_timeout_timer)
+  if (!client || !client->worker)
     return;
 
-  uv_timer_stop(client->request_timeout_timer);
+  timer_wheel_disarm(&client->worker->timeouts, &client->request_timer);
 }
 
 int ecewo_timeout_request(ecewo_response_t *res, uint64_t timeout_ms) {
@@ -857,40 +985,10 @@ int ecewo_timeout_request(ecewo_response_t *res, uint64_t timeout_ms) {
 
   ecewo_client_t *client = (ecewo_client_t *)sock->data;
 
-  if (!client || client->closing || !client->srv || !client->srv->runtime)
-    return -1;
-
-  if (client->request_timeout_timer) {
-    return uv_timer_start(client->request_timeout_timer,
-                          on_request_timeout,
-                          timeout_ms,
-                          0);
-  }
-
-  // libuv handle; freed via uv_close(handle, (uv_close_cb)free) in close_client.
-  client->request_timeout_timer = malloc(sizeof(uv_timer_t));
-  if (!client->request_timeout_timer)
-    return -1;
-
-  if (uv_timer_init(client->srv->runtime->loop, client->request_timeout_timer) != 0) {
-    free(client->request_timeout_timer);
-    client->request_timeout_timer = NULL;
-    return -1;
-  }
-
-  client->request_timeout_timer->data = client;
-
-  if (uv_timer_start(client->request_timeout_timer,
-                     on_request_timeout,
-                     timeout_ms,
-                     0)
-      != 0) {
-    uv_timer_t *timer = client->request_timeout_timer;
-    client->request_timeout_timer = NULL;
-    uv_close((uv_handle_t *)timer, (uv_close_cb)free);
+  if (!client || client->closing || !client->worker || !client->worker->timeouts.timer)
     return -1;
-  }
 
+  timer_wheel_arm(&client->worker->timeouts, &client->request_timer, timeout_ms);
   return 0;
 }
 
@@ -899,33 +997,227 @@ void server_alloc_buffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *b
   ecewo_client_t *client = (ecewo_client_t *)handle->data;
 
   if (!client || (client->closing && !client->draining)
-      || (client->srv && client->srv->shutdown_requested)) {
+      || (client->worker && client->worker->shutdown_started)) {
     buf->base = NULL;
     buf->len = 0;
     return;
   }
 
+  // Given back in server_on_read once the read is handled
   if (!client->buffer) {
-    client->buffer = malloc(READ_BUFFER_SIZE);
+    client->buffer = client->worker ? read_pool_get(&client->worker->read_pool)
+                                    : malloc(READ_BUFFER_SIZE + 1);
     if (!client->buffer) {
       buf->base = NULL;
       buf->len = 0;
       return;
     }
-    client->read_buf = uv_buf_init(client->buffer, READ_BUFFER_SIZE);
   }
 
-  *buf = client->read_buf;
+  *buf = uv_buf_init(client->buffer, READ_BUFFER_SIZE);
 }
 
-void server_on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
-  ecewo_client_t *client = (ecewo_client_t *)stream->data;
+static void release_read_buffer(ecewo_client_t *client, char **buf, bool pooled) {
+  if (pooled && client->worker)
+    read_pool_put(&client->worker->read_pool, *buf);
+  else
+    free(*buf);
+  *buf = NULL;
+}
 
-  if (!client)
+// Graceful close for responses that finish outside the read callback, e.g.
+// a streamed body whose end is marked by closing the connection.
+void server_close_client(ecewo_client_t *client) {
+  close_client(client);
+}
+
+static void pause_reading(ecewo_client_t *client) {
+  if (client->reading_paused || client->closing || client->taken_over)
+    return;
+
+  uv_read_stop((uv_stream_t *)&client->handle);
+  client->reading_paused = true;
+}
+
+static void resume_reading(ecewo_client_t *client) {
+  if (!client->reading_paused)
+    return;
+
+  client->reading_paused = false;
+  if (client->closing || uv_is_closing((uv_handle_t *)&client->handle))
     return;
 
+  if (uv_read_start((uv_stream_t *)&client->handle, server_alloc_buffer, server_on_read) != 0)
+    close_client(client);
+}
+
+// Starts the request timeout and a fresh parser context for the next message
+static void start_request(ecewo_client_t *client) {
   ecewo__server_t *srv = client->srv;
-  uv_loop_t *loop = (srv && srv->runtime) ? srv->runtime->loop : NULL;
+
+  // The previous request is over, and with it the headers in this block
+  release_read_buffer(client, &client->header_block, client->header_block_pooled);
+
+  client_context_reset(client);
+  client->request_in_progress = true;
+  client->request_start = uv_hrtime();
+  client->request_seq++;
+
+  // Start per-request timeout if configured
+  if (srv && srv->app && srv->app->request_timeout_ms > 0 && client->worker)
+    timer_wheel_arm(&client->worker->timeouts, &client->request_timer, srv->app->request_timeout_ms);
+}
+
+// Keeps bytes that arrived behind a request whose reply is still outstanding
+// and stops reading until server_response_done() lets them through. Reading
+// stops right away, so at most one read's worth is ever held.
+static int pipeline_hold(ecewo_client_t *client, const char *data, size_t len) {
+  // Freed in pipeline_drain_cb, or in client_free_server if the connection closes first
+  // Plus the spare byte http_parse_body() may write past the data
+  char *held = realloc(client->pipeline_buf, client->pipeline_len + len + 1);
+  if (!held)
+    return -1;
+
+  memcpy(held + client->pipeline_len, data, len);
+  client->pipeline_buf = held;
+  client->pipeline_len += len;
+  pause_reading(client);
+  return 0;
+}
+
+// Request headers point into the buffer they were read into, and so may a
+// body that arrived with them. When a request outlives the read, a complete
+// header block keeps that buffer (owner is where it is held) until its reply
+// is finished, since the handler may already hold pointers into it;
+// headers still being parsed, or a second block for the same request, are
+// copied to the arena instead. Any other read buffer goes back to the pool.
+static int keep_header_views(ecewo_client_t *client, int result, char **owner) {
+  http_context_t *ctx = &client->persistent_context;
+
+  if (!http_headers_borrowed(ctx))
+    return 0;
+
+  bool outlives_read = result == REQUEST_PENDING || client->taken_over;
+
+  if (outlives_read && ctx->headers_complete && !client->header_block && *owner) {
+    client->header_block_pooled = owner == &client->buffer;
+    client->header_block = *owner;
+    *owner = NULL;
+    http_headers_adopt(ctx);
+    return 0;
+  }
+
+  if (outlives_read || !ctx->message_complete)
+    return http_headers_copy(ctx);
+
+  return 0;
+}
+
+// Dispatches every complete request in data, in order. Replies the handlers
+// send synchronously are corked and flushed in one write at the end; a
+// request whose reply is still outstanding holds back everything behind it.
+// data lies in the allocation *owner points to.
+static void process_requests(ecewo_client_t *client, const char *data, size_t len, char **owner) {
+  http_context_t *ctx = &client->persistent_context;
+
+  ecewo_client_ref(client);
+
+  while (len > 0) {
+    if (client->pipeline_blocked) {
+      response_flush_corked(client);
+      if (pipeline_hold(client, data, len) != 0)
+        close_client(client);
+      break;
+    }
+
+    if (!client->request_in_progress || ctx->message_complete)
+      start_request(client);
+
+    size_t used = len;
+    int result = router(client, data, len, &used);
+
+    if (result != REQUEST_KEEP_ALIVE && result != REQUEST_PENDING) {
+      response_flush_corked(client);
+      close_client(client);
+      break;
+    }
+
+    if (keep_header_views(client, result, owner) != 0) {
+      response_flush_corked(client);
+      close_client(client);
+      break;
+    }
+
+    if (!client->valid || client->closing || client->taken_over)
+      break;
+
+    if (result == REQUEST_KEEP_ALIVE) {
+      stop_request_timer(client);
+      client->keep_alive_enabled = true;
+      start_idle_timer(client);
+    } else if (ctx->message_complete) {
+      // Fully received, but the handler replies later
+      client->pipeline_blocked = true;
+    }
+
+    data += used;
+    len -= used;
+  }
+
+  response_flush_corked(client);
+  client->corked = false;
+
+  ecewo_client_unref(client);
+}
+
+static void pipeline_drain_cb(void *user_data) {
+  ecewo_client_t *client = (ecewo_client_t *)user_data;
+  client->pipeline_drain_scheduled = false;
+
+  if (client->pipeline_blocked) {
+    ecewo_client_unref(client);
+    return;
+  }
+
+  char *held = client->pipeline_buf;
+  size_t held_len = client->pipeline_len;
+  client->pipeline_buf = NULL;
+  client->pipeline_len = 0;
+
+  if (client->valid && !client->closing && !client->taken_over) {
+    if (held)
+      process_requests(client, held, held_len, &held);
+    if (client->pipeline_len == 0)
+      resume_reading(client);
+  }
+
+  free(held);
+  ecewo_client_unref(client);
+}
+
+// Called once the reply to a request is complete or fully queued. Requests
+// held behind it are handled on the next loop iteration rather than here,
+// since this may run inside a handler.
+void server_response_done(ecewo_client_t *client) {
+  if (!client)
+    return;
+
+  client->pipeline_blocked = false;
+
+  if (client->pipeline_len == 0 || client->pipeline_drain_scheduled)
+    return;
+
+  ecewo_client_ref(client);
+  if (!ecewo_timeout(pipeline_drain_cb, 0, client)) {
+    ecewo_client_unref(client);
+    close_client(client);
+    return;
+  }
+  client->pipeline_drain_scheduled = true;
+}
+
+static void handle_read(ecewo_client_t *client, uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+  uv_loop_t *loop = client->worker ? client->worker->loop : NULL;
 
   if (client->draining) {
     if (nread < 0) {
@@ -939,7 +1231,7 @@ void server_on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
   if (client->closing)
     return;
 
-  if (srv && srv->shutdown_requested) {
+  if (client->worker && client->worker->shutdown_started) {
     close_client(client);
     return;
   }
@@ -953,6 +1245,8 @@ void server_on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
     return;
 
   client->last_activity = loop ? uv_now(loop) : 0;
+  if (client->worker)
+    metric_counter_add(&client->worker->metrics.bytes_in, (uint64_t)nread);
 
   if (!client->parser_initialized) {
     client_parser_init(client);
@@ -960,64 +1254,31 @@ void server_on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
     client->request_in_progress = false;
   }
 
-  if (!client->request_in_progress) {
-    client_context_reset(client);
-    client->request_in_progress = true;
-
-    // Start per-request timeout if configured
-    if (srv && srv->app && srv->app->request_timeout_ms > 0 && loop) {
-      if (client->request_timeout_timer) {
-        uv_timer_start(client->request_timeout_timer,
-                       on_request_timeout,
-                       srv->app->request_timeout_ms,
-                       0);
-      } else {
-        // libuv handle; freed via uv_close(handle, (uv_close_cb)free) in close_client.
-        client->request_timeout_timer = malloc(sizeof(uv_timer_t));
-        if (client->request_timeout_timer) {
-          if (uv_timer_init(loop, client->request_timeout_timer) == 0) {
-            client->request_timeout_timer->data = client;
-            if (uv_timer_start(client->request_timeout_timer,
-                               on_request_timeout,
-                               srv->app->request_timeout_ms,
-                               0)
-                != 0) {
-              uv_close((uv_handle_t *)client->request_timeout_timer, (uv_close_cb)free);
-              client->request_timeout_timer = NULL;
-            }
-          } else {
-            free(client->request_timeout_timer);
-            client->request_timeout_timer = NULL;
-          }
-        }
-      }
-    }
-  }
-
-  if (buf && buf->base) {
-    ecewo_client_ref(client);
-    int result = router(client, buf->base, (size_t)nread);
+  if (buf && buf->base)
+    process_requests(client, buf->base, (size_t)nread, &client->buffer);
+}
 
-    switch (result) {
-    case REQUEST_KEEP_ALIVE:
-      stop_request_timer(client);
-      client->keep_alive_enabled = true;
-      break;
+// Called once a final reply has been handed over along with its body.
+// Header views are only promised until then, so a read buffer the request
+// kept as its header block goes back to the pool now rather than when the
+// connection's next request starts, which may be never.
+void server_reply_finished(ecewo_client_t *client) {
+  if (!client || !client->header_block)
+    return;
 
-    case REQUEST_CLOSE:
-      close_client(client);
-      break;
+  release_read_buffer(client, &client->header_block, client->header_block_pooled);
+}
 
-    case REQUEST_PENDING:
-      break;
+// Nothing points into the read buffer once a read is handled, unless a
+// request kept it as its header block, so it goes back to the pool right away
+void server_on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+  ecewo_client_t *client = (ecewo_client_t *)stream->data;
 
-    default:
-      close_client(client);
-      break;
-    }
+  if (!client)
+    return;
 
-    ecewo_client_unref(client);
-  }
+  handle_read(client, stream, nread, buf);
+  release_read_buffer(client, &client->buffer, true);
 }
 
 static void on_connection(uv_stream_t *server, int status) {
@@ -1026,40 +1287,53 @@ static void on_connection(uv_stream_t *server, int status) {
     return;
   }
 
-  ecewo__server_t *srv = (ecewo__server_t *)server->data;
-  if (!srv || !srv->runtime || !srv->runtime->loop)
+  ecewo__worker_t *w = (ecewo__worker_t *)server->data;
+  if (!w || !w->loop)
     return;
 
-  if (srv->shutdown_requested)
+  if (w->shutdown_started)
     return;
 
-  if (srv->active_connections >= srv->app->max_connections) {
+  ecewo__server_t *srv = w->srv;
+
+  // The limit is per app, so reserve a slot in the counter shared by all
+  // workers before accepting.
+  int prev = atomic_fetch_add_explicit(&srv->active_connections, 1, memory_order_relaxed);
+  if (prev >= srv->app->max_connections) {
+    atomic_fetch_sub_explicit(&srv->active_connections, 1, memory_order_relaxed);
     LOG_DEBUG("Max connections (%d) reached", srv->app->max_connections);
     return;
   }
 
   // ref-counted; freed in client_free_server when the count reaches zero.
   ecewo_client_t *client = calloc(1, sizeof(ecewo_client_t));
-  if (!client)
+  if (!client) {
+    atomic_fetch_sub_explicit(&srv->active_connections, 1, memory_order_relaxed);
     return;
+  }
 
   client->valid = true;
-  client->last_activity = uv_now(srv->runtime->loop);
+  timer_wheel_entry_init(&client->idle_timer, on_idle_timeout, client);
+  timer_wheel_entry_init(&client->request_timer, on_request_timeout, client);
+  client->last_activity = uv_now(w->loop);
   client->keep_alive_enabled = false;
   client->next = NULL;
   client->parser_initialized = false;
   client->request_in_progress = false;
   client->connection_arena = NULL;
   client->srv = srv;
+  client->worker = w;
 
   atomic_init(&client->refcount, 1);
 
   if (client_connection_init(client) != 0) {
+    atomic_fetch_sub_explicit(&srv->active_connections, 1, memory_order_relaxed);
     free(client);
     return;
   }
 
-  if (uv_tcp_init(srv->runtime->loop, &client->handle) != 0) {
+  if (uv_tcp_init(w->loop, &client->handle) != 0) {
+    atomic_fetch_sub_explicit(&srv->active_connections, 1, memory_order_relaxed);
     if (client->connection_arena)
       ecewo_arena_return(client->connection_arena);
     free(client);
@@ -1067,7 +1341,12 @@ static void on_connection(uv_stream_t *server, int status) {
   }
 
   client->handle.data = client;
-  // client->buffer/read_buf are allocated lazily in server_alloc_buffer.
+  // client->buffer is lent by the read pool in server_alloc_buffer
+
+  // From here on the slot is released in on_client_closed
+  add_ecewo_client_to_list(w, client);
+  w->active_connections++;
+  metric_counter_add(&w->metrics.connections_accepted, 1);
 
   if (uv_accept(server, (uv_stream_t *)&client->handle) == 0) {
     uv_tcp_nodelay(&client->handle, 1);
@@ -1075,12 +1354,8 @@ static void on_connection(uv_stream_t *server, int status) {
     if (uv_read_start((uv_stream_t *)&client->handle,
                       server_alloc_buffer,
                       server_on_read)
-        == 0) {
-      add_ecewo_client_to_list(srv, client);
-      srv->active_connections++;
-    } else {
+        != 0)
       close_client(client);
-    }
   } else {
     close_client(client);
   }
@@ -1115,11 +1390,8 @@ static int runtime_ensure_initialized(void) {
     return -1;
   }
 
-  init_date_cache();
-
   if (uv_async_init(rt->loop, &rt->shutdown_async, on_async_shutdown) != 0) {
     arena_pool_destroy();
-    destroy_date_cache();
     uv_loop_close(rt->loop);
     free(rt->loop);
     rt->loop = NULL;
@@ -1132,7 +1404,6 @@ static int runtime_ensure_initialized(void) {
     while (uv_run(rt->loop, UV_RUN_NOWAIT) != 0)
       ;
     arena_pool_destroy();
-    destroy_date_cache();
     uv_loop_close(rt->loop);
     free(rt->loop);
     rt->loop = NULL;
@@ -1216,7 +1487,7 @@ static void runtime_cleanup(ecewo__runtime_t *rt) {
   }
 
   arena_pool_destroy();
-  destroy_date_cache();
+  file_cache_destroy();
 
   free(rt->apps);
   rt->apps = NULL;
@@ -1298,6 +1569,7 @@ ecewo_app_t *ecewo_create(void) {
   app->request_timeout_ms = 0;
   app->cleanup_interval_ms = 30000;
   app->shutdown_timeout_ms = 15000;
+  app->thread_count = 1;
   memcpy(app->listen_address, "0.0.0.0", sizeof("0.0.0.0"));
 
   // Root struct; no arena exists yet to allocate from.
@@ -1336,6 +1608,73 @@ ecewo_app_t *ecewo_create(void) {
   return app;
 }
 
+// Creates and binds the listener of one worker on the worker's loop.
+static int worker_listen(ecewo__worker_t *w, const struct sockaddr *bind_addr, unsigned int flags) {
+  // libuv handle; freed in on_server_closed after uv_close completes.
+  w->tcp_server = malloc(sizeof(uv_tcp_t));
+  if (!w->tcp_server)
+    return SERVER_OUT_OF_MEMORY;
+
+  if (uv_tcp_init(w->loop, w->tcp_server) != 0) {
+    free(w->tcp_server);
+    w->tcp_server = NULL;
+    return SERVER_INIT_FAILED;
+  }
+
+  // Store the worker in the tcp server handle so on_connection can retrieve it
+  w->tcp_server->data = w;
+
+  uv_tcp_simultaneous_accepts(w->tcp_server, 1);
+
+  if (uv_tcp_bind(w->tcp_server, bind_addr, flags) != 0)
+    return SERVER_BIND_FAILED;
+
+  if (uv_listen((uv_stream_t *)w->tcp_server, w->srv->app->listen_backlog, on_connection) != 0)
+    return SERVER_LISTEN_FAILED;
+
+  return SERVER_OK;
+}
+
+// Sets up a worker > 0: its own loop plus the wakeup handle used to deliver
+// shutdown. The thread itself is started by ecewo_run().
+static int worker_loop_init(ecewo__worker_t *w) {
+  // Freed via uv_loop_close + free in worker_loop_destroy.
+  w->loop = malloc(sizeof(uv_loop_t));
+  if (!w->loop)
+    return SERVER_OUT_OF_MEMORY;
+
+  if (uv_loop_init(w->loop) != 0) {
+    free(w->loop);
+    w->loop = NULL;
+    return SERVER_INIT_FAILED;
+  }
+
+  if (uv_async_init(w->loop, &w->wakeup, on_worker_wakeup) != 0) {
+    uv_loop_close(w->loop);
+    free(w->loop);
+    w->loop = NULL;
+    return SERVER_INIT_FAILED;
+  }
+  w->wakeup.data = w;
+
+  return SERVER_OK;
+}
+
+// Undoes a partially completed ecewo_bind(). No loop has run yet.
+static void workers_abort(ecewo__worker_t *workers, int count) {
+  for (int i = 1; i < count; i++)
+    worker_loop_destroy(&workers[i]);
+
+  // Worker 0 lives on the runtime loop, which may close the listener later
+  // than this array lives; detach it so on_server_closed only frees the handle.
+  if (count > 0 && workers[0].tcp_server) {
+    workers[0].tcp_server->data = NULL;
+    uv_close((uv_handle_t *)workers[0].tcp_server, on_server_closed);
+  }
+
+  free(workers);
+}
+
 int ecewo_bind(ecewo_app_t *app, uint16_t port) {
   if (!app || !app->server)
     return SERVER_NOT_INITIALIZED;
@@ -1351,9 +1690,13 @@ int ecewo_bind(ecewo_app_t *app, uint16_t port) {
   if (!srv->initialized || !rt || !rt->loop)
     return SERVER_NOT_INITIALIZED;
 
-  if (srv->running)
+  if (srv->running || srv->workers)
     return SERVER_ALREADY_RUNNING;
 
+  // Workers only read the routes and middleware from here on
+  if (ecewo_routes_freeze(app) != 0)
+    return SERVER_OUT_OF_MEMORY;
+
   // Parse the configured listen address as numeric IPv4 first, IPv6 second.
   // Failing here avoids allocating the tcp handle for an invalid address.
   struct sockaddr_in addr4;
@@ -1371,43 +1714,74 @@ int ecewo_bind(ecewo_app_t *app, uint16_t port) {
     return SERVER_BIND_FAILED;
   }
 
-  // libuv handle; freed in on_server_closed after uv_close completes.
-  srv->tcp_server = malloc(sizeof(uv_tcp_t));
-  if (!srv->tcp_server)
-    return SERVER_OUT_OF_MEMORY;
+  int thread_count = app->thread_count > 0 ? app->thread_count : 1;
+  unsigned int flags = 0;
 
-  if (uv_tcp_init(rt->loop, srv->tcp_server) != 0) {
-    free(srv->tcp_server);
-    srv->tcp_server = NULL;
-    return SERVER_INIT_FAILED;
+#if !defined(_WIN32) && !defined(__APPLE__)
+#ifdef ECEWO_TEST_MODE
+  // Several listeners on one port cannot work without it, test build or not
+  if (thread_count > 1)
+#endif
+    flags = UV_TCP_REUSEPORT;
+#else
+  // Without kernel load balancing across listeners, extra workers would
+  // never see a connection.
+  if (thread_count > 1) {
+    LOG_ERROR("Multi-threaded mode requires SO_REUSEPORT load balancing; using 1 thread");
+    thread_count = 1;
   }
+#endif
 
-  // Store srv in the tcp server handle so on_connection can retrieve it
-  srv->tcp_server->data = srv;
+  // Freed in server_destroy, or in workers_abort if binding fails.
+  ecewo__worker_t *workers = calloc((size_t)thread_count, sizeof(ecewo__worker_t));
+  if (!workers)
+    return SERVER_OUT_OF_MEMORY;
 
-  uv_tcp_simultaneous_accepts(srv->tcp_server, 1);
+  for (int i = 0; i < thread_count; i++) {
+    ecewo__worker_t *w = &workers[i];
+    w->srv = srv;
+    w->index = i;
 
-  unsigned int flags = 0;
+    int rc = SERVER_OK;
+    if (i == 0)
+      w->loop = rt->loop;
+    else
+      rc = worker_loop_init(w);
+
+    if (rc == SERVER_OK)
+      rc = worker_listen(w, bind_addr, flags);
+
+    if (rc != SERVER_OK) {
+      if (rc == SERVER_LISTEN_FAILED)
+        LOG_ERROR("Failed to listen on port %" PRIu16, port);
+      else if (rc == SERVER_BIND_FAILED)
+        LOG_ERROR("Failed to bind to %s:%" PRIu16 " (may be in use)", app->listen_address, port);
+      workers_abort(workers, i + 1);
+      return rc;
+    }
+  }
 
-#if !defined(_WIN32) && !defined(__APPLE__) && !defined(ECEWO_TEST_MODE)
-  flags = UV_TCP_REUSEPORT;
-#endif
+  for (int i = 0; i < thread_count; i++) {
+    if (timer_wheel_init(&workers[i].timeouts, workers[i].loop) != 0)
+      LOG_DEBUG("Failed to start the timeout wheel");
 
-  if (uv_tcp_bind(srv->tcp_server, bind_addr, flags) != 0) {
-    uv_close((uv_handle_t *)srv->tcp_server, on_server_closed);
-    LOG_ERROR("Failed to bind to %s:%" PRIu16 " (may be in use)", app->listen_address, port);
-    return SERVER_BIND_FAILED;
-  }
+    if (flush_check_init(&workers[i]) != 0)
+      LOG_DEBUG("Failed to start the write flush handle");
 
-  if (uv_listen((uv_stream_t *)srv->tcp_server, srv->app->listen_backlog, on_connection) != 0) {
-    uv_close((uv_handle_t *)srv->tcp_server, on_server_closed);
-    LOG_ERROR("Failed to listen on port %" PRIu16, port);
-    return SERVER_LISTEN_FAILED;
-  }
+    write_pool_init(&workers[i].write_pool, &workers[i].metrics);
+    // One byte more than is read into a buffer, for the NUL of a body that
+    // ends the read; see http_parse_body()
+    read_pool_init(&workers[i].read_pool, READ_BUFFER_SIZE + 1, &workers[i].metrics);
 
-  if (start_cleanup_timer(srv) != 0)
-    LOG_DEBUG("Failed to start cleanup timer");
+    if (app->route_cache_entries > 0) {
+      workers[i].route_cache = route_cache_create(app->route_cache_entries);
+      if (!workers[i].route_cache)
+        LOG_ERROR("Failed to allocate the route cache; matching without it");
+    }
+  }
 
+  srv->workers = workers;
+  srv->worker_count = thread_count;
   srv->running = true;
 
   const char *is_worker = getenv("ECEWO_WORKER");
@@ -1422,9 +1796,73 @@ int ecewo_bind(ecewo_app_t *app, uint16_t port) {
       printf("Server listening on http://%s:%" PRIu16 "\n", app->listen_address, port);
   }
 
+  if (thread_count > 1)
+    LOG_DEBUG("Serving on %d threads", thread_count);
+
   return SERVER_OK;
 }
 
+static void worker_thread_main(void *arg) {
+  ecewo__worker_t *w = (ecewo__worker_t *)arg;
+
+  current_worker = w;
+
+  uv_run(w->loop, UV_RUN_DEFAULT);
+
+  // Close whatever handlers left behind (timers, spawn handles) while this
+  // thread still owns the loop; worker_loop_destroy finishes the job later.
+  timer_wheel_close(&w->timeouts);
+  flush_check_close(w);
+  uv_walk(w->loop, close_walk_cb, NULL);
+  while (uv_run(w->loop, UV_RUN_DEFAULT) != 0)
+    ;
+
+  arena_pool_thread_detach();
+  current_worker = NULL;
+}
+
+// Starts the threads of workers > 0 for every bound app. A worker whose
+// thread cannot be created is torn down so the kernel stops routing
+// connections to its listener.
+static void runtime_start_workers(ecewo__runtime_t *rt) {
+  for (size_t i = 0; i < rt->app_count; i++) {
+    ecewo_app_t *a = rt->apps[i];
+    if (!a || !a->server || !a->server->running)
+      continue;
+
+    ecewo__server_t *srv = a->server;
+    for (int j = 1; j < srv->worker_count; j++) {
+      ecewo__worker_t *w = &srv->workers[j];
+      if (w->thread_started || !w->loop)
+        continue;
+
+      if (uv_thread_create(&w->thread, worker_thread_main, w) != 0) {
+        LOG_ERROR("Failed to start worker thread %d", j);
+        worker_loop_destroy(w);
+        continue;
+      }
+      w->thread_started = true;
+    }
+  }
+}
+
+static void runtime_join_workers(ecewo__runtime_t *rt) {
+  for (size_t i = 0; i < rt->app_count; i++) {
+    ecewo_app_t *a = rt->apps[i];
+    if (!a || !a->server)
+      continue;
+
+    ecewo__server_t *srv = a->server;
+    for (int j = 1; j < srv->worker_count; j++) {
+      ecewo__worker_t *w = &srv->workers[j];
+      if (!w->thread_started)
+        continue;
+      uv_thread_join(&w->thread);
+      w->thread_started = false;
+    }
+  }
+}
+
 void ecewo_run(void) {
   ecewo__runtime_t *rt = &ecewo_runtime;
 
@@ -1454,7 +1892,10 @@ void ecewo_run(void) {
     return;
 
   rt->running = true;
+  runtime_start_workers(rt);
   uv_run(rt->loop, UV_RUN_DEFAULT);
+  // Worker loops wind down on their own after ecewo_shutdown() woke them
+  runtime_join_workers(rt);
   rt->running = false;
 
   // The loop has exited. Tear down every app's internal state, then the
@@ -1485,7 +1926,11 @@ bool ecewo_is_running(ecewo_app_t *app) {
 }
 
 int ecewo_active_connections(ecewo_app_t *app) {
-  return app && app->server ? app->server->active_connections : 0;
+  return app && app->server ? atomic_load(&app->server->active_connections) : 0;
+}
+
+uint64_t ecewo_timeout_expirations(ecewo_app_t *app) {
+  return app && app->server ? atomic_load(&app->server->timeout_expirations) : 0;
 }
 
 ecewo_arena_t *ecewo_app_arena(const ecewo_app_t *app) {
@@ -1531,11 +1976,17 @@ int server_pending_async_work(ecewo_app_t *app) {
   return (int)atomic_load_explicit(&rt->async_work_count, memory_order_acquire);
 }
 
-void *ecewo_get_loop(void) {
+uv_loop_t *ecewo__current_loop(void) {
+  if (current_worker)
+    return current_worker->loop;
   ecewo__runtime_t *rt = &ecewo_runtime;
   return rt->initialized ? rt->loop : NULL;
 }
 
+void *ecewo_get_loop(void) {
+  return ecewo__current_loop();
+}
+
 static void timer_callback(uv_timer_t *handle) {
   timer_data_t *data = (timer_data_t *)handle->data;
 
@@ -1550,8 +2001,8 @@ static void timer_callback(uv_timer_t *handle) {
 }
 
 ecewo_timer_t *ecewo_timeout(ecewo_timer_cb_t callback, uint64_t delay_ms, void *user_data) {
-  ecewo__runtime_t *rt = &ecewo_runtime;
-  if (!rt->initialized || !rt->loop || !callback)
+  uv_loop_t *loop = ecewo__current_loop();
+  if (!loop || !callback)
     return NULL;
 
   // libuv handle; freed via uv_close(handle, (uv_close_cb)free) in timer_callback.
@@ -1569,7 +2020,7 @@ ecewo_timer_t *ecewo_timeout(ecewo_timer_cb_t callback, uint64_t delay_ms, void
   data->user_data = user_data;
   data->is_interval = false;
 
-  if (uv_timer_init(rt->loop, timer) != 0) {
+  if (uv_timer_init(loop, timer) != 0) {
     free(timer);
     free(data);
     return NULL;
@@ -1587,8 +2038,8 @@ ecewo_timer_t *ecewo_timeout(ecewo_timer_cb_t callback, uint64_t delay_ms, void
 }
 
 ecewo_timer_t *ecewo_interval(ecewo_timer_cb_t callback, uint64_t interval_ms, void *user_data) {
-  ecewo__runtime_t *rt = &ecewo_runtime;
-  if (!rt->initialized || !rt->loop || !callback)
+  uv_loop_t *loop = ecewo__current_loop();
+  if (!loop || !callback)
     return NULL;
 
   // libuv handle; freed via uv_close in ecewo_clear_timer or when the loop drains.
@@ -1606,7 +2057,7 @@ ecewo_timer_t *ecewo_interval(ecewo_timer_cb_t callback, uint64_t interval_ms, v
   data->user_data = user_data;
   data->is_interval = true;
 
-  if (uv_timer_init(rt->loop, timer) != 0) {
+  if (uv_timer_init(loop, timer) != 0) {
     free(timer);
     free(data);
     return NULL;
@@ -1680,6 +2131,19 @@ void ecewo_set_shutdown_timeout(ecewo_app_t *app, uint64_t ms) {
   if (app)
     app->shutdown_timeout_ms = ms;
 }
+void ecewo_set_threads(ecewo_app_t *app, int count) {
+  if (!app)
+    return;
+  if (count <= 0)
+    count = (int)uv_available_parallelism();
+  if (count > ECEWO_MAX_THREADS)
+    count = ECEWO_MAX_THREADS;
+  app->thread_count = count;
+}
+void ecewo_set_route_cache(ecewo_app_t *app, size_t entries) {
+  if (app)
+    app->route_cache_entries = entries;
+}
 void ecewo_set_listen_address(ecewo_app_t *app, const char *address) {
   if (!app || !address)
     return;
@@ -27,10 +27,19 @@
 #include "http.h"
 #include "middleware.h"
 #include "route-table.h"
+#include "route-cache.h"
+#include "timer-wheel.h"
+#include "write-pool.h"
+#include "read-pool.h"
+#include "metrics.h"
 #include "uv.h"
 #include "llhttp.h"
 #include <stdatomic.h>
 
+#ifndef ECEWO_MAX_THREADS
+#define ECEWO_MAX_THREADS 256
+#endif
+
 /* Full definitions of the three types that are opaque in the public header.
  * Only internal source files (which include this header) may access fields
  * directly; external code must use the accessor functions. */
@@ -49,6 +58,8 @@ struct ecewo_app_s {
   uint64_t request_timeout_ms;
   uint64_t cleanup_interval_ms;
   uint64_t shutdown_timeout_ms;
+  int thread_count;
+  size_t route_cache_entries; // per worker; 0 disables the route cache
   char listen_address[64]; // numeric IPv4 or IPv6 string; INET6_ADDRSTRLEN=46
   plugin_slot_t *plugin_slots;
   int plugin_slot_count;
@@ -64,7 +75,9 @@ struct ecewo_request_s {
   uint8_t *body;
   size_t body_len;
   ecewo__req_t *headers;
-  ecewo__req_t *query;
+  const char *query_string; // raw, without the '?'
+  size_t query_len;
+  ecewo__req_t *query; // NULL until the first ecewo_query() parses query_string
   ecewo__req_t *params;
   ecewo__req_ctx_t *ctx;
   uint8_t http_major;
@@ -73,6 +86,14 @@ struct ecewo_request_s {
   void *chain;
 };
 
+// How a response started with ecewo_stream_begin*() delimits its body
+typedef enum {
+  STREAM_NONE = 0,
+  STREAM_CHUNKED, // Transfer-Encoding: chunked
+  STREAM_LENGTH, // Content-Length known up front
+  STREAM_UNTIL_CLOSE, // HTTP/1.0 peer; body ends when the connection closes
+} ecewo__stream_mode_t;
+
 struct ecewo_response_s {
   ecewo_arena_t *arena;
   void *ecewo__client_socket;
@@ -85,12 +106,33 @@ struct ecewo_response_s {
   uint16_t header_capacity;
   bool replied;
   bool is_head_request;
+  bool http10; // HTTP/1.0 peer; can't receive chunked bodies
+
+  ecewo__stream_mode_t stream_mode;
+  bool stream_no_body; // HEAD/204/304: chunks are accepted and dropped
+  uint64_t stream_remaining; // bytes still owed in STREAM_LENGTH mode
+
+  route_stats_t *route_stats; // matched route; cleared once its latency is recorded
+  uint64_t dispatched_at; // uv_hrtime() at headers-complete
 };
 
 #ifndef READ_BUFFER_SIZE
 #define READ_BUFFER_SIZE 16384
 #endif
 
+// Upper bound on the replies to pipelined requests that are collected
+// before being written; a reply larger than this is written on its own
+#ifndef PIPELINE_CORK_SIZE
+#define PIPELINE_CORK_SIZE 65536
+#endif
+
+// Streamed chunks up to this size are copied into the cork buffer and
+// written together once the loop iteration is over; larger ones, and those
+// handed over with a done callback, get a write of their own
+#ifndef WRITE_COALESCE_SIZE
+#define WRITE_COALESCE_SIZE 4096
+#endif
+
 typedef struct ecewo__runtime_s ecewo__runtime_t;
 
 /* Process-level runtime singleton. Owns the shared event loop, signal handlers,
@@ -115,37 +157,74 @@ struct ecewo__runtime_s {
   size_t live_app_count; // number of apps that have not yet been shut down
 };
 
+typedef struct ecewo__worker_s ecewo__worker_t;
+
+/* One event loop with its own listener and connections. Every bound app has
+ * worker 0, which runs on the runtime loop; ecewo_set_threads() adds workers
+ * that own their loop and run it on a dedicated thread. The route table and
+ * middleware stay on the server and are only read by workers. Apart from the
+ * wakeup handle, a worker's fields are touched only from its own thread. */
+struct ecewo__worker_s {
+  ecewo__server_t *srv;
+  int index;
+  uv_loop_t *loop; // rt->loop for worker 0; owned and freed in server_destroy otherwise
+  uv_thread_t thread;
+  bool thread_started;
+  uv_async_t wakeup; // workers > 0 only; main thread signals shutdown through it
+  bool shutdown_started;
+  bool server_closed;
+  uv_tcp_t *tcp_server;
+  ecewo_client_t *client_list_head;
+  int active_connections;
+  timer_wheel_t timeouts; // idle and request timeouts of this worker's connections
+  ecewo__metrics_t metrics; // written only by this worker, read by ecewo_metrics_render()
+  route_cache_t *route_cache; // NULL unless ecewo_set_route_cache() asked for one
+  write_pool_t write_pool; // write requests and output buffers of this worker's replies
+  read_pool_t read_pool; // read buffers lent to this worker's connections
+  uv_check_t *flush_check; // runs after each poll phase while flush_list is non-empty
+  ecewo_client_t *flush_list; // clients whose corked bytes wait for flush_check
+  uv_timer_t *force_close_timer;
+};
+
 struct ecewo__server_s {
   ecewo_app_t *app;
   ecewo__runtime_t *runtime;
   bool initialized;
   bool running;
   bool shutdown_requested;
-  bool server_closed;
+  atomic_bool shutdown_forwarded; // ecewo_shutdown() called off the main thread
   bool registered; // currently in runtime->apps[]
-  int active_connections;
-  uv_tcp_t *tcp_server;
+  atomic_int active_connections; // sum over all workers
+  atomic_uint_fast64_t timeout_expirations; // connections closed by the idle or request timeout
   void (*atexit_cb)(void *user_data);
   void *atexit_user_data;
-  ecewo_client_t *client_list_head;
-  uv_timer_t *cleanup_timer;
-  uv_timer_t *force_close_timer;
+  ecewo__worker_t *workers; // allocated by ecewo_bind; freed in server_destroy
+  int worker_count;
   route_table_t *route_table;
   GlobalMiddlewareEntry *global_middleware;
   uint16_t global_middleware_count;
   uint16_t global_middleware_capacity;
+  uint32_t middleware_generation; // bumped by ecewo_use(); stales prebuilt chains
+  MiddlewareInfo *route_middleware; // every route's MiddlewareInfo, newest first
 };
 
 /* Returns the process-level runtime singleton. Used by callers that need the
  * shared event loop or async-work counter (timers, spawn, plugin authors). */
 ecewo__runtime_t *ecewo__runtime_get(void);
 
+/* Loop of the calling thread: the worker's loop on a worker thread, the
+ * runtime loop everywhere else. */
+uv_loop_t *ecewo__current_loop(void);
+
 struct ecewo_client_s {
   uv_tcp_t handle;
-  uv_buf_t read_buf;
-  // Lazily allocated by server_alloc_buffer on the first read so idle/half-open
-  // accepts don't reserve READ_BUFFER_SIZE bytes up front.
+  // Taken from the worker's read pool by server_alloc_buffer and given back
+  // once the read is handled, so idle connections hold no buffer
   char *buffer;
+  // A read buffer handed to the current request because its headers point
+  // into it, until server_reply_finished(); the next read takes another one
+  char *header_block;
+  bool header_block_pooled; // from the read pool rather than pipeline_buf
   bool closing;
   bool draining; // True while draining receive buffer before closing
   uint64_t last_activity;
@@ -162,11 +241,35 @@ struct ecewo_client_s {
   bool parser_initialized;
   bool request_in_progress; // True while parsing a multi-packet request
 
+  // HTTP/1.1 pipelining. Replies must go out in request order, so while one
+  // is still outstanding (async handler, stream, file transfer) the requests
+  // behind it wait in pipeline_buf with reading stopped.
+  bool pipeline_blocked;
+  bool pipeline_drain_scheduled;
+  bool reading_paused;
+  char *pipeline_buf;
+  size_t pipeline_len;
+
+  // While a batch of pipelined requests is being handled, replies sent from
+  // within the handlers are appended here and written out together
+  bool corked;
+  char *cork_buf;
+  size_t cork_len;
+  size_t cork_cap;
+
+  // Outside a batch, stream writes of one loop iteration are corked as well
+  // and flushed from the worker's check handle; the list holds a reference
+  bool flush_scheduled;
+  struct ecewo_client_s *flush_next;
+
   bool taken_over;
   void *takeover_user_data;
   void (*takeover_close_cb)(uv_handle_t *handle);
 
-  uv_timer_t *request_timeout_timer;
+  timer_wheel_entry_t idle_timer; // armed once keep-alive; checks last_activity when it fires
+  timer_wheel_entry_t request_timer;
+  uint64_t request_start; // uv_hrtime() when the current request began; 0 once replied
+  uint32_t request_seq; // bumped per request; writes finishing later compare it
   atomic_int refcount;
   bool valid;
 
@@ -186,9 +289,15 @@ struct ecewo_client_s {
 
   // Pointer back to the server that owns this client
   ecewo__server_t *srv;
+  // Worker whose loop owns the handle; all client state lives on its thread
+  ecewo__worker_t *worker;
 };
 
 void server_on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf);
+void server_close_client(ecewo_client_t *client);
+void server_response_done(ecewo_client_t *client);
+void server_reply_finished(ecewo_client_t *client);
+bool server_schedule_flush(ecewo_client_t *client);
 void server_alloc_buffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf);
 
 #endif
@@ -23,6 +23,7 @@
 #include "ecewo.h"
 #include "logger.h"
 #include "server.h"
+#include "metrics.h"
 #include <stdlib.h>
 
 typedef struct {
@@ -70,6 +71,8 @@ static void spawn_after_work_cb(uv_work_t *req, int status) {
   if (!task)
     return;
 
+  metric_gauge_add(&metrics_spawn_queue_depth, -1);
+
   if (status < 0)
     LOG_ERROR("Worker spawn execution failed");
 
@@ -124,6 +127,7 @@ static int spawn_internal(
     return result;
   }
 
+  metric_gauge_add(&metrics_spawn_queue_depth, 1);
   return 0;
 }
 
@@ -143,8 +147,9 @@ int ecewo_spawn(ecewo_response_t *res, void *context, ecewo_spawn_handler_t work
 
   ecewo_client_t *client = socket->data;
 
-  if (!client->srv || !client->srv->runtime)
+  if (!client->worker)
     return -1;
 
-  return spawn_internal(client->srv->runtime->loop, context, work_fn, done_fn, res, client);
+  // The completion must run on the loop that owns the connection
+  return spawn_internal(client->worker->loop, context, work_fn, done_fn, res, client);
 }
@@ -0,0 +1,169 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "ecewo.h"
+#include "server.h"
+#include "utils.h"
+#include "logger.h"
+#include <string.h>
+
+extern int response_send_file_async(ecewo_response_t *res,
+                                    const char *path,
+                                    void (*missing)(ecewo_response_t *res));
+
+// Directories mounted with ecewo_static(). Each mount registers GET and HEAD
+// wildcard routes below its prefix; they all share one handler, which picks
+// the longest mount prefix the request path falls under.
+
+typedef struct static_mount_s {
+  const char *prefix; // no trailing '/'; "" mounts at the root
+  size_t prefix_len;
+  const char *dir; // no trailing '/'
+  struct static_mount_s *next;
+} static_mount_t;
+
+static int static_mounts_key; // address is the app-data key
+
+static const static_mount_t *find_mount(const ecewo_app_t *app, const char *path) {
+  const static_mount_t *best = NULL;
+
+  for (const static_mount_t *m = ecewo_get_app_data(app, &static_mounts_key); m; m = m->next) {
+    if (strncmp(path, m->prefix, m->prefix_len) != 0)
+      continue;
+    if (path[m->prefix_len] != '/' && path[m->prefix_len] != '\0')
+      continue;
+    if (!best || m->prefix_len > best->prefix_len)
+      best = m;
+  }
+
+  return best;
+}
+
+// Rejects anything that could step outside the mounted directory once
+// decoded: ".." segments and backslashes (a separator on Windows).
+static bool is_safe_relative_path(const char *rel) {
+  const char *p = rel;
+  while (*p) {
+    while (*p == '/')
+      p++;
+
+    const char *end = strchr(p, '/');
+    size_t len = end ? (size_t)(end - p) : strlen(p);
+
+    if (len == 2 && p[0] == '.' && p[1] == '.')
+      return false;
+    if (memchr(p, '\\', len))
+      return false;
+
+    p += len;
+  }
+
+  return true;
+}
+
+static void static_not_found(ecewo_response_t *res) {
+  ecewo_header_set(res, "Content-Type", "text/plain");
+  ecewo_send(res, 404, "404 Not Found", 13);
+}
+
+static void static_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  const static_mount_t *mount = find_mount(req->app, req->path);
+  if (!mount) {
+    static_not_found(res);
+    return;
+  }
+
+  // Everything after the prefix: "" or "/..."
+  const char *rest = req->path + mount->prefix_len;
+
+  // %00 would cut the path short once decoded
+  if (strstr(rest, "%00")) {
+    static_not_found(res);
+    return;
+  }
+
+  char *rel = ecewo_strdup(req->arena, rest);
+  if (!rel) {
+    ecewo_send_text(res, 500, "Internal Server Error");
+    return;
+  }
+
+  url_decode(rel, false);
+  if (!is_safe_relative_path(rel)) {
+    static_not_found(res);
+    return;
+  }
+
+  size_t rel_len = strlen(rel);
+  const char *index = "";
+  if (rel_len == 0)
+    index = "/index.html";
+  else if (rel[rel_len - 1] == '/')
+    index = "index.html";
+
+  char *path = ecewo_sprintf(req->arena, "%s%s%s", mount->dir, rel, index);
+  if (!path) {
+    ecewo_send_text(res, 500, "Internal Server Error");
+    return;
+  }
+
+  response_send_file_async(res, path, static_not_found);
+}
+
+int ecewo_static(ecewo_app_t *app, const char *prefix, const char *dir) {
+  if (!app || !prefix || !dir || prefix[0] != '/' || !dir[0]) {
+    LOG_ERROR("ecewo_static(): prefix must start with '/' and dir must not be empty");
+    return -1;
+  }
+
+  ecewo_arena_t *arena = ecewo_app_arena(app);
+  static_mount_t *mount = ecewo_alloc(arena, sizeof(static_mount_t));
+  char *p = ecewo_strdup(arena, prefix);
+  char *d = ecewo_strdup(arena, dir);
+  if (!mount || !p || !d) {
+    LOG_ERROR("ecewo_static(): allocation failed");
+    return -1;
+  }
+
+  size_t plen = strlen(p);
+  while (plen > 0 && p[plen - 1] == '/')
+    p[--plen] = '\0';
+
+  size_t dlen = strlen(d);
+  while (dlen > 1 && d[dlen - 1] == '/')
+    d[--dlen] = '\0';
+
+  mount->prefix = p;
+  mount->prefix_len = plen;
+  mount->dir = d;
+  mount->next = ecewo_get_app_data(app, &static_mounts_key);
+  ecewo_set_app_data(app, &static_mounts_key, mount);
+
+  char *pattern = ecewo_sprintf(arena, "%s/*", p);
+  if (!pattern)
+    return -1;
+
+  ECEWO_GET(app, pattern, static_handler);
+  ECEWO_HEAD(app, pattern, static_handler);
+
+  return 0;
+}
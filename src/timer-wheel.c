@@ -0,0 +1,200 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "timer-wheel.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+#define LEVEL_SPAN(level) ((uint64_t)1 << (TIMER_WHEEL_BITS * ((level) + 1)))
+#define MAX_DELTA (LEVEL_SPAN(TIMER_WHEEL_LEVELS - 1) - 1)
+
+static uint64_t now_ticks(const timer_wheel_t *wheel) {
+  return uv_now(wheel->loop) / TIMER_WHEEL_TICK_MS;
+}
+
+static void link_entry(timer_wheel_t *wheel, timer_wheel_entry_t *entry) {
+  uint64_t delta = entry->expires > wheel->current ? entry->expires - wheel->current : 0;
+  if (delta > MAX_DELTA) {
+    delta = MAX_DELTA;
+    entry->expires = wheel->current + delta;
+  }
+
+  // The lowest level whose span still covers the delta; an entry that is
+  // already due goes to the slot expired next
+  int level = 0;
+  while (level < TIMER_WHEEL_LEVELS - 1 && delta >= LEVEL_SPAN(level))
+    level++;
+
+  uint64_t expires = delta == 0 ? wheel->current : entry->expires;
+  timer_wheel_entry_t **slot = &wheel->slots[level][(expires >> (TIMER_WHEEL_BITS * level)) & SLOT_MASK];
+
+  entry->prev = NULL;
+  entry->next = *slot;
+  if (*slot)
+    (*slot)->prev = entry;
+  *slot = entry;
+  entry->slot = slot;
+}
+
+static void unlink_entry(timer_wheel_entry_t *entry) {
+  if (entry->prev)
+    entry->prev->next = entry->next;
+  else
+    *entry->slot = entry->next;
+
+  if (entry->next)
+    entry->next->prev = entry->prev;
+
+  entry->next = NULL;
+  entry->prev = NULL;
+  entry->slot = NULL;
+}
+
+// Moves the entries of one slot on a higher level down to where they
+// belong now that their time is closer
+static void cascade(timer_wheel_t *wheel, int level, size_t index) {
+  timer_wheel_entry_t *entry = wheel->slots[level][index];
+  wheel->slots[level][index] = NULL;
+
+  while (entry) {
+    timer_wheel_entry_t *next = entry->next;
+    link_entry(wheel, entry);
+    entry = next;
+  }
+}
+
+static void expire_tick(timer_wheel_t *wheel) {
+  uint64_t tick = wheel->current;
+
+  // Each time a level wraps, the next slot of the level above comes due
+  for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+    if ((tick >> (TIMER_WHEEL_BITS * (level - 1))) & SLOT_MASK)
+      break;
+    cascade(wheel, level, (tick >> (TIMER_WHEEL_BITS * level)) & SLOT_MASK);
+  }
+
+  // Detach the due slot before running anything: a callback that re-arms
+  // lands in a later slot, and one that disarms an entry still waiting
+  // here unlinks it from the local list through its slot pointer.
+  timer_wheel_entry_t *due = wheel->slots[0][tick & SLOT_MASK];
+  wheel->slots[0][tick & SLOT_MASK] = NULL;
+  for (timer_wheel_entry_t *entry = due; entry; entry = entry->next)
+    entry->slot = &due;
+
+  wheel->current = tick + 1;
+
+  while (due) {
+    timer_wheel_entry_t *entry = due;
+    unlink_entry(entry);
+    wheel->count--;
+    entry->cb(entry);
+  }
+}
+
+static void on_tick(uv_timer_t *handle) {
+  timer_wheel_t *wheel = (timer_wheel_t *)handle->data;
+  uint64_t now = now_ticks(wheel);
+
+  // Catches up on ticks missed while the loop was busy
+  while (wheel->count > 0 && wheel->current <= now)
+    expire_tick(wheel);
+
+  if (wheel->count == 0)
+    uv_timer_stop(handle);
+}
+
+int timer_wheel_init(timer_wheel_t *wheel, uv_loop_t *loop) {
+  memset(wheel, 0, sizeof(*wheel));
+  wheel->loop = loop;
+
+  // libuv handle; freed via uv_close(handle, (uv_close_cb)free) in timer_wheel_close.
+  wheel->timer = malloc(sizeof(uv_timer_t));
+  if (!wheel->timer)
+    return -1;
+
+  if (uv_timer_init(loop, wheel->timer) != 0) {
+    free(wheel->timer);
+    wheel->timer = NULL;
+    return -1;
+  }
+
+  wheel->timer->data = wheel;
+  return 0;
+}
+
+void timer_wheel_close(timer_wheel_t *wheel) {
+  if (!wheel->timer)
+    return;
+
+  uv_timer_stop(wheel->timer);
+  uv_close((uv_handle_t *)wheel->timer, (uv_close_cb)free);
+  wheel->timer = NULL;
+
+  for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+    for (int i = 0; i < TIMER_WHEEL_SLOTS; i++) {
+      while (wheel->slots[level][i])
+        unlink_entry(wheel->slots[level][i]);
+    }
+  }
+  wheel->count = 0;
+}
+
+void timer_wheel_entry_init(timer_wheel_entry_t *entry, timer_wheel_cb_t cb, void *data) {
+  memset(entry, 0, sizeof(*entry));
+  entry->cb = cb;
+  entry->data = data;
+}
+
+void timer_wheel_arm(timer_wheel_t *wheel, timer_wheel_entry_t *entry, uint64_t timeout_ms) {
+  if (!wheel->timer)
+    return;
+
+  if (entry->slot) {
+    unlink_entry(entry);
+    wheel->count--;
+  }
+
+  // An idle wheel's clock stood still; restart it from now
+  uint64_t now = now_ticks(wheel);
+  if (wheel->count == 0)
+    wheel->current = now;
+
+  // The current tick is already partly over; rounding up and counting from
+  // the next one means an entry never fires before its timeout
+  entry->expires = now + 1 + (timeout_ms + TIMER_WHEEL_TICK_MS - 1) / TIMER_WHEEL_TICK_MS;
+  link_entry(wheel, entry);
+  wheel->count++;
+
+  if (!uv_is_active((uv_handle_t *)wheel->timer))
+    uv_timer_start(wheel->timer, on_tick, TIMER_WHEEL_TICK_MS, TIMER_WHEEL_TICK_MS);
+}
+
+void timer_wheel_disarm(timer_wheel_t *wheel, timer_wheel_entry_t *entry) {
+  if (!entry->slot)
+    return;
+
+  unlink_entry(entry);
+  wheel->count--;
+
+  if (wheel->count == 0 && wheel->timer)
+    uv_timer_stop(wheel->timer);
+}
@@ -0,0 +1,84 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ECEWO_TIMER_WHEEL_H
+#define ECEWO_TIMER_WHEEL_H
+
+#include "uv.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Resolution of idle and request timeouts (ms). A timeout fires within
+// two ticks after its deadline, never before.
+#ifndef TIMER_WHEEL_TICK_MS
+#define TIMER_WHEEL_TICK_MS 100
+#endif
+
+// Four levels of 64 slots span 64^4 ticks (about 19 days at 100 ms);
+// longer timeouts are clamped to that.
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+
+typedef struct timer_wheel_entry_s timer_wheel_entry_t;
+
+typedef void (*timer_wheel_cb_t)(timer_wheel_entry_t *entry);
+
+// Embedded in whatever owns the timeout; never allocated by the wheel
+struct timer_wheel_entry_s {
+  timer_wheel_entry_t *next;
+  timer_wheel_entry_t *prev;
+  timer_wheel_entry_t **slot; // list head the entry is on; NULL while disarmed
+  uint64_t expires; // in ticks
+  timer_wheel_cb_t cb;
+  void *data;
+};
+
+/* Hierarchical timing wheel. Each worker loop has one, driven by a single
+ * uv_timer_t that only runs while something is armed. Arming, disarming
+ * and expiring an entry are O(1); entries far in the future sit on a
+ * coarser level and move down as their slot comes up. Not thread-safe:
+ * every call happens on the loop's thread. */
+typedef struct {
+  uv_loop_t *loop;
+  uv_timer_t *timer;
+  uint64_t current; // next tick to expire
+  size_t count;
+  timer_wheel_entry_t *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+} timer_wheel_t;
+
+int timer_wheel_init(timer_wheel_t *wheel, uv_loop_t *loop);
+
+// Closes the driving timer. Armed entries are dropped without firing.
+void timer_wheel_close(timer_wheel_t *wheel);
+
+void timer_wheel_entry_init(timer_wheel_entry_t *entry, timer_wheel_cb_t cb, void *data);
+
+// (Re)arms entry to fire after timeout_ms. The callback runs on the loop,
+// once; it may re-arm the entry or disarm others.
+void timer_wheel_arm(timer_wheel_t *wheel, timer_wheel_entry_t *entry, uint64_t timeout_ms);
+void timer_wheel_disarm(timer_wheel_t *wheel, timer_wheel_entry_t *entry);
+
+static inline bool timer_wheel_armed(const timer_wheel_entry_t *entry) {
+  return entry->slot != NULL;
+}
+
+#endif
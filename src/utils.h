@@ -23,6 +23,14 @@
 #define ECEWO_UTILS_H
 
 #include <stdbool.h>
+#include <string.h>
+#include "scan.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define ECEWO_THREAD_LOCAL __declspec(thread)
+#else
+#define ECEWO_THREAD_LOCAL _Thread_local
+#endif
 
 static inline int hex_digit(unsigned char c) {
   if (c >= '0' && c <= '9')
@@ -37,34 +45,46 @@ static inline int hex_digit(unsigned char c) {
 // Decodes percent-encoded characters in-place.
 // plus_as_space=true: '+' -> ' ' (used for query strings, form encoding)
 // plus_as_space=false: '+' is left as-is (used for path params, like decodeURIComponent)
+// Runs without escapes are found with scan_find2() and moved in one piece;
+// a string without any is left untouched.
 static inline void url_decode(char *str, bool plus_as_space) {
   if (!str)
     return;
 
-  unsigned char *src = (unsigned char *)str;
-  unsigned char *dst = (unsigned char *)str;
+  char *end = str + strlen(str);
+  char plus = plus_as_space ? '+' : '%';
+
+  char *src = (char *)scan_find2(str, end, '%', plus);
+  char *dst = src;
 
-  while (*src) {
+  while (src < end) {
     if (*src == '%') {
-      int hi = (src[1] != '\0') ? hex_digit(src[1]) : -1;
-      int lo = (hi >= 0 && src[2] != '\0') ? hex_digit(src[2]) : -1;
+      int hi = (src + 1 < end) ? hex_digit((unsigned char)src[1]) : -1;
+      int lo = (hi >= 0 && src + 2 < end) ? hex_digit((unsigned char)src[2]) : -1;
       if (hi >= 0 && lo >= 0) {
-        *dst++ = (unsigned char)((hi << 4) | lo);
+        *dst++ = (char)((hi << 4) | lo);
         src += 3;
       } else {
         *dst++ = *src++;
       }
-    } else if (plus_as_space && *src == '+') {
+    } else {
       *dst++ = ' ';
       src++;
-    } else {
-      *dst++ = *src++;
     }
+
+    char *next = (char *)scan_find2(src, end, '%', plus);
+    size_t run = (size_t)(next - src);
+    if (dst != src)
+      memmove(dst, src, run);
+    dst += run;
+    src = next;
   }
 
   *dst = '\0';
 }
 
-const char *get_cached_date(void); // Defined in server.c
+// Date header value for the current second; its length is stored in *len
+// unless len is NULL. Defined in server.c
+const char *get_cached_date(size_t *len);
 
 #endif
@@ -0,0 +1,125 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "write-pool.h"
+
+static const size_t class_size[WRITE_POOL_CLASSES] = { 256, 1024, 4096, 16384 };
+
+// Precedes every block handed out, so write_pool_free() knows where the
+// block goes back to without being told its size
+struct write_pool_block_s {
+  union {
+    struct {
+      write_pool_t *pool; // NULL for blocks that bypassed the classes
+      write_pool_block_t *next; // free list link
+      uint32_t size_class;
+    };
+    max_align_t align;
+  };
+};
+
+static void count(write_pool_t *pool, bool hit) {
+  if (!pool->metrics)
+    return;
+  metric_counter_add(hit ? &pool->metrics->write_pool_hits : &pool->metrics->write_pool_misses, 1);
+}
+
+void write_pool_init(write_pool_t *pool, ecewo__metrics_t *metrics) {
+  memset(pool, 0, sizeof(*pool));
+  pool->metrics = metrics;
+}
+
+void write_pool_destroy(write_pool_t *pool) {
+  if (!pool)
+    return;
+
+  for (int i = 0; i < WRITE_POOL_CLASSES; i++) {
+    write_pool_block_t *block = pool->free_list[i];
+    while (block) {
+      write_pool_block_t *next = block->next;
+      free(block);
+      block = next;
+    }
+    pool->free_list[i] = NULL;
+    pool->free_count[i] = 0;
+  }
+}
+
+void *write_pool_alloc(write_pool_t *pool, size_t size) {
+  int cls = 0;
+  while (cls < WRITE_POOL_CLASSES && size > class_size[cls])
+    cls++;
+
+  if (!pool || cls == WRITE_POOL_CLASSES) {
+    if (pool)
+      count(pool, false);
+
+    write_pool_block_t *block = malloc(sizeof(write_pool_block_t) + size);
+    if (!block)
+      return NULL;
+    block->pool = NULL;
+    return block + 1;
+  }
+
+  write_pool_block_t *block = pool->free_list[cls];
+  if (block) {
+    pool->free_list[cls] = block->next;
+    pool->free_count[cls]--;
+    count(pool, true);
+    return block + 1;
+  }
+
+  count(pool, false);
+  block = malloc(sizeof(write_pool_block_t) + class_size[cls]);
+  if (!block)
+    return NULL;
+  block->pool = pool;
+  block->size_class = (uint32_t)cls;
+  return block + 1;
+}
+
+void *write_pool_calloc(write_pool_t *pool, size_t size) {
+  void *ptr = write_pool_alloc(pool, size);
+  if (ptr)
+    memset(ptr, 0, size);
+  return ptr;
+}
+
+void write_pool_free(void *ptr) {
+  if (!ptr)
+    return;
+
+  write_pool_block_t *block = (write_pool_block_t *)ptr - 1;
+  write_pool_t *pool = block->pool;
+
+  if (!pool || pool->free_count[block->size_class] >= WRITE_POOL_MAX_FREE) {
+    free(block);
+    return;
+  }
+
+  block->next = pool->free_list[block->size_class];
+  pool->free_list[block->size_class] = block;
+  pool->free_count[block->size_class]++;
+}
@@ -0,0 +1,68 @@
+// Copyright 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ECEWO_WRITE_POOL_H
+#define ECEWO_WRITE_POOL_H
+
+#include "metrics.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Blocks kept on each size class's free list. A block returned to a full
+// list goes back to free().
+#ifndef WRITE_POOL_MAX_FREE
+#define WRITE_POOL_MAX_FREE 64
+#endif
+
+// 256, 1024, 4096 and 16384 bytes. The smallest fits a write request; the
+// rest hold response heads and the part of a reply the socket didn't take.
+#define WRITE_POOL_CLASSES 4
+
+typedef struct write_pool_block_s write_pool_block_t;
+
+// Recycles the write requests and output buffers of one worker. Blocks are
+// allocated and returned on the worker's thread only, since a write's
+// callback runs on the loop that queued it.
+typedef struct {
+  write_pool_block_t *free_list[WRITE_POOL_CLASSES];
+  uint32_t free_count[WRITE_POOL_CLASSES];
+  ecewo__metrics_t *metrics; // counts hits and misses; may be NULL
+} write_pool_t;
+
+void write_pool_init(write_pool_t *pool, ecewo__metrics_t *metrics);
+
+// Frees the blocks on the free lists. Every block taken from the pool must
+// have been returned first.
+void write_pool_destroy(write_pool_t *pool);
+
+// Returns size bytes aligned for any type, from the free list of the
+// smallest class that fits when there is one. Sizes past the largest class,
+// or a NULL pool, go to malloc(). NULL when out of memory.
+void *write_pool_alloc(write_pool_t *pool, size_t size);
+
+// Same as write_pool_alloc(), zeroed
+void *write_pool_calloc(write_pool_t *pool, size_t size);
+
+// Returns a block from write_pool_alloc() to the pool it came from, or to
+// free(). NULL is ignored.
+void write_pool_free(void *ptr);
+
+#endif
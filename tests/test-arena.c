@@ -22,6 +22,7 @@
 
 #include "ecewo.h"
 #include "tester.h"
+#include "uv.h"
 #include <stdint.h>
 #include <string.h>
 
@@ -285,6 +286,108 @@ int test_arena_da_append_many(void) {
 }
 
 
+// TEST 15: pooled arenas cross threads: borrowed on one, returned on another
+#define XT_THREADS 4
+#define XT_ARENAS 64
+#define XT_ROUNDS 500
+
+typedef struct {
+  ecewo_arena_t *handoff[XT_ARENAS]; // borrowed by main, returned here
+  int failures;
+} xt_ctx_t;
+
+static void xt_worker(void *arg) {
+  xt_ctx_t *ctx = arg;
+
+  for (int i = 0; i < XT_ARENAS; i++) {
+    int *p = ecewo_alloc(ctx->handoff[i], sizeof(int));
+    if (!p)
+      ctx->failures++;
+    ecewo_arena_return(ctx->handoff[i]);
+  }
+
+  // Churn across magazine boundaries in both directions
+  ecewo_arena_t *held[XT_ARENAS];
+  for (int round = 0; round < XT_ROUNDS; round++) {
+    int n = 1 + round % XT_ARENAS;
+    for (int i = 0; i < n; i++) {
+      held[i] = ecewo_arena_borrow();
+      if (!held[i]) {
+        ctx->failures++;
+        n = i;
+        break;
+      }
+      memset(ecewo_alloc(held[i], 128), round & 0xFF, 128);
+    }
+    for (int i = 0; i < n; i++)
+      ecewo_arena_return(held[i]);
+  }
+}
+
+int test_arena_pool_cross_thread(void) {
+  // Creating an app initializes the shared pool
+  ecewo_app_t *app = ecewo_create();
+  ASSERT_NOT_NULL(app);
+
+  static xt_ctx_t ctx[XT_THREADS];
+  uv_thread_t threads[XT_THREADS];
+
+  for (int t = 0; t < XT_THREADS; t++) {
+    ctx[t].failures = 0;
+    for (int i = 0; i < XT_ARENAS; i++) {
+      ctx[t].handoff[i] = ecewo_arena_borrow();
+      ASSERT_NOT_NULL(ctx[t].handoff[i]);
+    }
+  }
+
+  for (int t = 0; t < XT_THREADS; t++)
+    ASSERT_EQ(0, uv_thread_create(&threads[t], xt_worker, &ctx[t]));
+
+  for (int t = 0; t < XT_THREADS; t++) {
+    uv_thread_join(&threads[t]);
+    ASSERT_EQ(0, ctx[t].failures);
+  }
+
+  // Arenas parked in the workers' caches flowed back through the depot
+  for (int i = 0; i < XT_ARENAS; i++) {
+    ecewo_arena_t *a = ecewo_arena_borrow();
+    ASSERT_NOT_NULL(a);
+    ASSERT_NOT_NULL(ecewo_alloc(a, 64));
+    ecewo_arena_return(a);
+  }
+
+  RETURN_OK();
+}
+
+
+// TEST 16: ecewo_realloc: the newest allocation grows in place, an older one moves
+int test_arena_realloc_in_place(void) {
+  ecewo_arena_t *a = ecewo_arena_borrow();
+  ASSERT_NOT_NULL(a);
+
+  char *p = ecewo_alloc(a, 16);
+  ASSERT_NOT_NULL(p);
+  memcpy(p, "fifteen chars..", 16);
+
+  char *q = ecewo_realloc(a, p, 16, 64);
+  ASSERT_TRUE(q == p);
+  ASSERT_EQ_STR("fifteen chars..", q);
+
+  // Space after the grown block belongs to the next allocation
+  char *next = ecewo_alloc(a, 8);
+  ASSERT_NOT_NULL(next);
+  ASSERT_TRUE(next >= q + 64);
+
+  char *moved = ecewo_realloc(a, q, 64, 128);
+  ASSERT_NOT_NULL(moved);
+  ASSERT_TRUE(moved != q);
+  ASSERT_EQ_STR("fifteen chars..", moved);
+
+  ecewo_arena_return(a);
+  RETURN_OK();
+}
+
+
 int main(void) {
   RUN_TEST(test_arena_alloc_basic);
   RUN_TEST(test_arena_alloc_no_overlap);
@@ -300,6 +403,8 @@ int main(void) {
   RUN_TEST(test_arena_free);
   RUN_TEST(test_arena_da_append_growth);
   RUN_TEST(test_arena_da_append_many);
+  RUN_TEST(test_arena_pool_cross_thread);
+  RUN_TEST(test_arena_realloc_in_place);
 
   return 0;
 }
@@ -72,9 +72,66 @@ int test_normal_body(void) {
   RETURN_OK();
 }
 
+void handler_strlen(ecewo_request_t *req, ecewo_response_t *res) {
+  const char *body = (const char *)ecewo_req_body(req);
+  char *response = ecewo_sprintf(ecewo_req_arena(req), "len=%zu,strlen=%zu,body=%s",
+                                 ecewo_req_body_len(req), body ? strlen(body) : 0, body ? body : "");
+  ecewo_send_text(res, 200, response);
+}
+
+int test_small_body_is_terminated(void) {
+  // Arrives with its headers, so the handler sees it where it was read
+  MockParams params = {
+    .method = MOCK_POST,
+    .path = "/strlen",
+    .body = "{\"id\":42}"
+  };
+
+  MockResponse res = request(&params);
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("len=9,strlen=9,body={\"id\":42}", res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+typedef struct {
+  ecewo_request_t *req;
+  ecewo_response_t *res;
+} later_t;
+
+static void on_later(void *user_data) {
+  later_t *l = user_data;
+  ecewo_send(l->res, 200, ecewo_req_body(l->req), ecewo_req_body_len(l->req));
+}
+
+void handler_later(ecewo_request_t *req, ecewo_response_t *res) {
+  later_t *l = ecewo_alloc(ecewo_req_arena(req), sizeof(later_t));
+  l->req = req;
+  l->res = res;
+  ecewo_timeout(on_later, 20, l);
+}
+
+int test_body_outlives_its_read(void) {
+  MockParams params = {
+    .method = MOCK_POST,
+    .path = "/later",
+    .body = "kept until the reply"
+  };
+
+  MockResponse res = request(&params);
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("kept until the reply", res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
 static void setup_routes(ecewo_app_t *app) {
   ECEWO_POST(app, "/large-body", handler_body);
   ECEWO_POST(app, "/normal-body", handler_body);
+  ECEWO_POST(app, "/strlen", handler_strlen);
+  ECEWO_POST(app, "/later", handler_later);
 }
 
 int main(void) {
@@ -82,6 +139,8 @@ int main(void) {
 
   RUN_TEST(test_large_body);
   RUN_TEST(test_normal_body);
+  RUN_TEST(test_small_body_is_terminated);
+  RUN_TEST(test_body_outlives_its_read);
 
   mock_cleanup();
   return 0;
@@ -76,8 +76,14 @@ static void handler(ecewo_request_t *req, ecewo_response_t *res) {
   ecewo_body_on_end(req, res, on_end);
 }
 
+static void buffered_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  char *b = ecewo_sprintf(ecewo_req_arena(req), "bytes=%zu", ecewo_req_body_len(req));
+  ecewo_send_text(res, ECEWO_OK, b);
+}
+
 static void setup_routes(ecewo_app_t *app) {
   ECEWO_POST(app, "/stream", ecewo_body_stream, handler);
+  ECEWO_POST(app, "/buffered", buffered_handler);
 }
 
 static int send_all(sock_t s, const char *buf, size_t len) {
@@ -182,11 +188,68 @@ static int test_streaming_over_buffered_cap(void) {
   RETURN_OK();
 }
 
+// An oversized upload to a buffered route is refused from its headers; the
+// reply arrives although no body byte was ever sent.
+static int test_buffered_over_cap_rejected_before_body(void) {
+  sock_t s = connect_sock();
+  ASSERT_TRUE(s != SOCK_INVALID);
+
+  const char *req =
+      "POST /buffered HTTP/1.1\r\n"
+      "Host: x\r\n"
+      "Content-Length: 2097152\r\n"
+      "\r\n";
+  ASSERT_TRUE(send_all(s, req, strlen(req)) == 0);
+
+  int code = read_status(s);
+  sock_close(s);
+  ASSERT_EQ(413, code);
+  RETURN_OK();
+}
+
+static int test_buffered_chunked_rejected(void) {
+  sock_t s = connect_sock();
+  ASSERT_TRUE(s != SOCK_INVALID);
+
+  const char *req =
+      "POST /buffered HTTP/1.1\r\n"
+      "Host: x\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n";
+  ASSERT_TRUE(send_all(s, req, strlen(req)) == 0);
+
+  int code = read_status(s);
+  sock_close(s);
+  ASSERT_EQ(413, code);
+  RETURN_OK();
+}
+
+static int test_buffered_empty_length(void) {
+  sock_t s = connect_sock();
+  ASSERT_TRUE(s != SOCK_INVALID);
+
+  const char *req =
+      "POST /buffered HTTP/1.1\r\n"
+      "Host: x\r\n"
+      "Connection: close\r\n"
+      "Content-Length: 0\r\n"
+      "\r\n";
+  ASSERT_TRUE(send_all(s, req, strlen(req)) == 0);
+
+  int code = read_status(s);
+  sock_close(s);
+  ASSERT_EQ(200, code);
+  RETURN_OK();
+}
+
 int main(void) {
   mock_init(setup_routes);
 
   RUN_TEST(test_streaming_chunked);
   RUN_TEST(test_streaming_over_buffered_cap);
+  RUN_TEST(test_buffered_over_cap_rejected_before_body);
+  RUN_TEST(test_buffered_chunked_rejected);
+  RUN_TEST(test_buffered_empty_length);
 
   mock_cleanup();
   return 0;
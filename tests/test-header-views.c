@@ -0,0 +1,206 @@
+// MIT License
+
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Request headers are parsed in place: names and values point into the read
+// buffer. These cover the cases where that buffer would go away or be
+// overwritten under them: a header block cut across reads, and a handler
+// that replies after later reads have arrived on the same connection.
+
+#include "ecewo.h"
+#include "ecewo-mock.h"
+#include "tester.h"
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET sock_t;
+#define SOCK_INVALID INVALID_SOCKET
+#define sock_close(s) closesocket(s)
+#define usleep(us) Sleep((us) / 1000)
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+typedef int sock_t;
+#define SOCK_INVALID (-1)
+#define sock_close(s) close(s)
+#endif
+
+static void handler_echo(ecewo_request_t *req, ecewo_response_t *res) {
+  const char *split = ecewo_header_get(req, "x-split-name");
+  const char *mixed = ecewo_header_get(req, "X-MIXED-CASE");
+  const char *host = ecewo_header_get(req, "host");
+
+  char *body = ecewo_sprintf(ecewo_req_arena(req), "split=%s,mixed=%s,host=%s",
+                             split ? split : "null",
+                             mixed ? mixed : "null",
+                             host ? host : "null");
+  ecewo_send_text(res, 200, body);
+}
+
+typedef struct {
+  ecewo_response_t *res;
+  const char *token; // not copied; must survive until the reply
+} late_reply_t;
+
+static void on_late_reply(void *user_data) {
+  late_reply_t *ctx = user_data;
+  ecewo_send_text(ctx->res, 200, ctx->token ? ctx->token : "null");
+}
+
+static void handler_late(ecewo_request_t *req, ecewo_response_t *res) {
+  late_reply_t *ctx = ecewo_alloc(ecewo_req_arena(req), sizeof(*ctx));
+  ctx->res = res;
+  ctx->token = ecewo_header_get(req, "X-Token");
+  ecewo_timeout(on_late_reply, 50, ctx);
+}
+
+static void setup_routes(ecewo_app_t *app) {
+  ECEWO_GET(app, "/echo", handler_echo);
+  ECEWO_GET(app, "/late", handler_late);
+}
+
+static sock_t connect_server(void) {
+  sock_t sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock == SOCK_INVALID)
+    return SOCK_INVALID;
+
+  int one = 1;
+  setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char *)&one, sizeof(one));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(TEST_PORT);
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+  if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+    sock_close(sock);
+    return SOCK_INVALID;
+  }
+  return sock;
+}
+
+// Sends each part in its own write, far enough apart to land in separate reads
+static bool send_parts(sock_t sock, const char **parts, int count) {
+  for (int i = 0; i < count; i++) {
+    size_t len = strlen(parts[i]);
+    if (send(sock, parts[i], (int)len, 0) != (ssize_t)len)
+      return false;
+    usleep(30000);
+  }
+  return true;
+}
+
+static ssize_t recv_all(sock_t sock, char *out, size_t size) {
+  ssize_t total = 0;
+  while ((size_t)total < size - 1) {
+    ssize_t n = recv(sock, out + total, (int)(size - 1 - (size_t)total), 0);
+    if (n <= 0)
+      break;
+    total += n;
+  }
+  out[total] = '\0';
+  return total;
+}
+
+static int test_header_split_across_reads(void) {
+  const char *parts[] = {
+    "GET /echo HTTP/1.1\r\nHost: localhost\r\nX-Sp",
+    "lit-Name: first-half",
+    "-second-half\r\nX-Mixed-Case: kept\r\nConnection: close\r\n\r\n",
+  };
+
+  sock_t sock = connect_server();
+  ASSERT_TRUE(sock != SOCK_INVALID);
+  ASSERT_TRUE(send_parts(sock, parts, 3));
+
+  char response[4096];
+  recv_all(sock, response, sizeof(response));
+  sock_close(sock);
+
+  ASSERT_NOT_NULL(strstr(response, "HTTP/1.1 200"));
+  ASSERT_NOT_NULL(strstr(response, "split=first-half-second-half,mixed=kept,host=localhost"));
+  RETURN_OK();
+}
+
+static int test_header_lookup_ignores_case(void) {
+  MockHeaders headers[] = {
+    { "X-SPLIT-NAME", "upper" },
+    { "x-mixed-case", "lower" },
+  };
+
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = "/echo",
+    .headers = headers,
+    .header_count = 2
+  };
+
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_NOT_NULL(strstr(res.body, "split=upper,mixed=lower,host="));
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+// The second request arrives while the first is still waiting to reply and
+// is read into the connection's buffer; the first reply must still see its
+// own header
+static int test_header_outlives_next_read(void) {
+  const char *parts[] = {
+    "GET /late HTTP/1.1\r\nHost: localhost\r\nX-Token: first-token\r\n\r\n",
+    "GET /late HTTP/1.1\r\nHost: localhost\r\nX-Token: SECOND-TOKEN-OVERWRITES\r\n"
+    "Connection: close\r\n\r\n",
+  };
+
+  sock_t sock = connect_server();
+  ASSERT_TRUE(sock != SOCK_INVALID);
+  ASSERT_TRUE(send_parts(sock, parts, 2));
+
+  char response[4096];
+  recv_all(sock, response, sizeof(response));
+  sock_close(sock);
+
+  const char *first = strstr(response, "first-token");
+  const char *second = strstr(response, "SECOND-TOKEN-OVERWRITES");
+  ASSERT_NOT_NULL(first);
+  ASSERT_NOT_NULL(second);
+  ASSERT_TRUE(first < second);
+  RETURN_OK();
+}
+
+int main(void) {
+  mock_init(setup_routes);
+
+  RUN_TEST(test_header_split_across_reads);
+  RUN_TEST(test_header_lookup_ignores_case);
+  RUN_TEST(test_header_outlives_next_read);
+
+  mock_cleanup();
+  return 0;
+}
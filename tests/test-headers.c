@@ -23,6 +23,7 @@
 #include "ecewo.h"
 #include "ecewo-mock.h"
 #include "tester.h"
+#include <stdio.h>
 
 void handler_echo_headers(ecewo_request_t *req, ecewo_response_t *res) {
   const char *auth = ecewo_header_get(req, "Authorization");
@@ -93,6 +94,52 @@ int test_set_headers(void) {
   RETURN_OK();
 }
 
+// The head is sized from the stored header lengths before it is written,
+// so every line has to come out whole, including empty and long values
+#define LONG_VALUE_SIZE 3000
+#define SIZED_BODY_SIZE 12345
+
+void handler_head_lines(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_arena_t *arena = ecewo_res_arena(res);
+
+  char *long_value = ecewo_alloc(arena, LONG_VALUE_SIZE + 1);
+  memset(long_value, 'v', LONG_VALUE_SIZE);
+  long_value[LONG_VALUE_SIZE] = '\0';
+
+  char *body = ecewo_alloc(arena, SIZED_BODY_SIZE + 1);
+  memset(body, 'b', SIZED_BODY_SIZE);
+  body[SIZED_BODY_SIZE] = '\0';
+
+  ecewo_header_set(res, "X-Empty", "");
+  ecewo_header_set(res, "X-Long", long_value);
+  ecewo_send_text(res, 202, body);
+}
+
+int test_head_lines(void) {
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = "/head-lines"
+  };
+
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(202, res.status_code);
+  ASSERT_EQ(SIZED_BODY_SIZE, (int64_t)strlen(res.body));
+  ASSERT_EQ_STR("12345", mock_get_header(&res, "Content-Length"));
+  ASSERT_EQ_STR("text/plain", mock_get_header(&res, "Content-Type"));
+  ASSERT_EQ_STR("", mock_get_header(&res, "X-Empty"));
+  ASSERT_NOT_NULL(mock_get_header(&res, "Date"));
+  ASSERT_NOT_NULL(mock_get_header(&res, "Connection"));
+
+  const char *long_value = mock_get_header(&res, "X-Long");
+  ASSERT_NOT_NULL(long_value);
+  ASSERT_EQ(LONG_VALUE_SIZE, (int64_t)strlen(long_value));
+
+  free_request(&res);
+  RETURN_OK();
+}
+
 void handler_header_injection(ecewo_request_t *req, ecewo_response_t *res) {
   (void)req;
 
@@ -120,17 +167,138 @@ int test_header_injection(void) {
   RETURN_OK();
 }
 
+// In ecewo_header_id_t order. Headers that change how the request is framed
+// or handled (Content-Length, Connection, ...) are left out.
+static const struct {
+  ecewo_header_id_t id;
+  const char *name;
+} well_known[] = {
+  { ECEWO_HDR_ACCEPT, "ACCEPT" },
+  { ECEWO_HDR_ACCEPT_ENCODING, "accept-encoding" },
+  { ECEWO_HDR_ACCEPT_LANGUAGE, "Accept-Language" },
+  { ECEWO_HDR_ACCESS_CONTROL_REQUEST_HEADERS, "Access-Control-Request-Headers" },
+  { ECEWO_HDR_ACCESS_CONTROL_REQUEST_METHOD, "Access-Control-Request-Method" },
+  { ECEWO_HDR_AUTHORIZATION, "Authorization" },
+  { ECEWO_HDR_CACHE_CONTROL, "Cache-Control" },
+  { ECEWO_HDR_CONTENT_ENCODING, "Content-Encoding" },
+  { ECEWO_HDR_CONTENT_TYPE, "Content-Type" },
+  { ECEWO_HDR_COOKIE, "Cookie" },
+  { ECEWO_HDR_FORWARDED, "Forwarded" },
+  { ECEWO_HDR_HOST, "host" },
+  { ECEWO_HDR_IF_MATCH, "If-Match" },
+  { ECEWO_HDR_IF_MODIFIED_SINCE, "If-Modified-Since" },
+  { ECEWO_HDR_IF_NONE_MATCH, "If-None-Match" },
+  { ECEWO_HDR_IF_RANGE, "If-Range" },
+  { ECEWO_HDR_IF_UNMODIFIED_SINCE, "If-Unmodified-Since" },
+  { ECEWO_HDR_ORIGIN, "Origin" },
+  { ECEWO_HDR_RANGE, "Range" },
+  { ECEWO_HDR_REFERER, "Referer" },
+  { ECEWO_HDR_SEC_WEBSOCKET_KEY, "Sec-WebSocket-Key" },
+  { ECEWO_HDR_SEC_WEBSOCKET_PROTOCOL, "Sec-WebSocket-Protocol" },
+  { ECEWO_HDR_SEC_WEBSOCKET_VERSION, "Sec-WebSocket-Version" },
+  { ECEWO_HDR_USER_AGENT, "User-Agent" },
+  { ECEWO_HDR_X_FORWARDED_FOR, "X-Forwarded-For" },
+  { ECEWO_HDR_X_FORWARDED_PROTO, "X-Forwarded-Proto" },
+  { ECEWO_HDR_X_REAL_IP, "X-Real-IP" },
+  { ECEWO_HDR_X_REQUEST_ID, "x-request-id" },
+};
+
+#define WELL_KNOWN_COUNT (sizeof(well_known) / sizeof(well_known[0]))
+
+// Replies with the names whose id lookup disagrees with the lookup by name
+void handler_header_ids(ecewo_request_t *req, ecewo_response_t *res) {
+  char *mismatches = ecewo_strdup(ecewo_req_arena(req), "");
+
+  for (size_t i = 0; i < WELL_KNOWN_COUNT; i++) {
+    const char *by_id = ecewo_header_get_id(req, well_known[i].id);
+    const char *by_name = ecewo_header_get(req, well_known[i].name);
+    if (!by_id || !by_name || by_id != by_name)
+      mismatches = ecewo_sprintf(ecewo_req_arena(req), "%s%s;", mismatches, well_known[i].name);
+  }
+
+  const char *missing = ecewo_header_get_id(req, ECEWO_HDR_UPGRADE);
+  const char *out_of_range = ecewo_header_get_id(req, ECEWO_HDR_COUNT);
+
+  ecewo_send_text(res, 200, ecewo_sprintf(ecewo_req_arena(req), "mismatches=%s,missing=%s,range=%s",
+                                          mismatches,
+                                          missing ? missing : "null",
+                                          out_of_range ? out_of_range : "null"));
+}
+
+int test_header_ids(void) {
+  MockHeaders headers[WELL_KNOWN_COUNT + 1];
+  char values[WELL_KNOWN_COUNT][16];
+
+  for (size_t i = 0; i < WELL_KNOWN_COUNT; i++) {
+    snprintf(values[i], sizeof(values[i]), "value-%zu", i);
+    headers[i].key = well_known[i].name;
+    headers[i].value = values[i];
+  }
+  // Only the first of a repeated header is indexed, matching ecewo_header_get
+  headers[WELL_KNOWN_COUNT].key = "cookie";
+  headers[WELL_KNOWN_COUNT].value = "second";
+
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = "/header-ids",
+    .headers = headers,
+    .header_count = WELL_KNOWN_COUNT + 1
+  };
+
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("mismatches=,missing=null,range=null", res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+void handler_cookie_id(ecewo_request_t *req, ecewo_response_t *res) {
+  const char *cookie = ecewo_header_get_id(req, ECEWO_HDR_COOKIE);
+  ecewo_send_text(res, 200, cookie ? cookie : "null");
+}
+
+int test_header_id_first_wins(void) {
+  MockHeaders headers[] = {
+    { "X-Cookie", "not-this" },
+    { "COOKIE", "first" },
+    { "cookie", "second" }
+  };
+
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = "/cookie-id",
+    .headers = headers,
+    .header_count = 3
+  };
+
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("first", res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
 static void setup_routes(ecewo_app_t *app) {
   ECEWO_GET(app, "/headers", handler_echo_headers);
   ECEWO_GET(app, "/custom-headers", handler_set_headers);
+  ECEWO_GET(app, "/head-lines", handler_head_lines);
   ECEWO_GET(app, "/header-injection", handler_header_injection);
+  ECEWO_GET(app, "/header-ids", handler_header_ids);
+  ECEWO_GET(app, "/cookie-id", handler_cookie_id);
 }
 
 int main(void) {
   mock_init(setup_routes);
   RUN_TEST(test_request_headers);
   RUN_TEST(test_set_headers);
+  RUN_TEST(test_head_lines);
   RUN_TEST(test_header_injection);
+  RUN_TEST(test_header_ids);
+  RUN_TEST(test_header_id_first_wins);
   mock_cleanup();
   return 0;
 }
@@ -0,0 +1,182 @@
+// MIT License
+
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ecewo.h"
+#include "ecewo-mock.h"
+#include "tester.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void handler_ok(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_text(res, 200, "ok");
+}
+
+static void handler_fail(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_text(res, 500, "fail");
+}
+
+static void handler_render_small(ecewo_request_t *req, ecewo_response_t *res) {
+  char small[32];
+  size_t len = ecewo_metrics_render(ecewo_req_app(req), small, sizeof(small));
+
+  char *full = malloc(len + 1);
+  size_t full_len = full ? ecewo_metrics_render(ecewo_req_app(req), full, len + 1) : 0;
+
+  bool ok = len >= sizeof(small)
+      && strlen(small) == sizeof(small) - 1
+      && full_len == len
+      && strlen(full) == len
+      && strncmp(full, small, sizeof(small) - 1) == 0;
+
+  free(full);
+  ecewo_send_text(res, ok ? 200 : 500, ok ? "ok" : "bad");
+}
+
+static void noop_work(void *context) {
+  (void)context;
+}
+
+static void handler_spawn_depth(ecewo_request_t *req, ecewo_response_t *res) {
+  ecewo_spawn(NULL, NULL, noop_work, NULL);
+
+  // The job can't have finished: its completion runs on this loop
+  char buf[8192];
+  ecewo_metrics_render(ecewo_req_app(req), buf, sizeof(buf));
+  bool queued = metric(buf, "ecewo_spawn_queue_depth") >= 1;
+  ecewo_send_text(res, queued ? 200 : 500, queued ? "ok" : "bad");
+}
+
+static MockResponse get(const char *path) {
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = path
+  };
+  return request(&params);
+}
+
+int test_metrics_exposition(void) {
+  for (int i = 0; i < 3; i++) {
+    MockResponse r = get("/ok");
+    ASSERT_EQ(200, r.status_code);
+    free_request(&r);
+  }
+
+  MockResponse missing = get("/missing");
+  ASSERT_EQ(404, missing.status_code);
+  free_request(&missing);
+
+  MockResponse fail = get("/fail");
+  ASSERT_EQ(500, fail.status_code);
+  free_request(&fail);
+
+  MockResponse res = get("/metrics");
+  ASSERT_EQ(200, res.status_code);
+
+  const char *type = mock_get_header(&res, "Content-Type");
+  ASSERT_NOT_NULL(type);
+  ASSERT_EQ(0, strncmp(type, "text/plain; version=0.0.4", 25));
+
+  ASSERT_NOT_NULL(strstr(res.body, "# TYPE ecewo_responses_total counter\n"));
+  ASSERT_NOT_NULL(strstr(res.body, "# TYPE ecewo_request_duration_seconds histogram\n"));
+
+  ASSERT_LE(3, metric(res.body, "ecewo_responses_total{class=\"2xx\"}"));
+  ASSERT_LE(1, metric(res.body, "ecewo_responses_total{class=\"4xx\"}"));
+  ASSERT_LE(1, metric(res.body, "ecewo_responses_total{class=\"5xx\"}"));
+  ASSERT_LE(5, metric(res.body, "ecewo_connections_accepted_total"));
+  ASSERT_LE(1, metric(res.body, "ecewo_connections_active"));
+  ASSERT_GT(metric(res.body, "ecewo_received_bytes_total"), 0);
+  ASSERT_GT(metric(res.body, "ecewo_sent_bytes_total"), 0);
+  ASSERT_EQ(0, metric(res.body, "ecewo_parse_errors_total{result=\"PARSE_ERROR\"}"));
+  ASSERT_GT(metric(res.body, "ecewo_arena_pool_arenas"), 0);
+
+  // Every reply so far was timed, and the +Inf bucket holds them all
+  long long count = metric(res.body, "ecewo_request_duration_seconds_count");
+  ASSERT_LE(5, count);
+  ASSERT_EQ(count, metric(res.body, "ecewo_request_duration_seconds_bucket{le=\"+Inf\"}"));
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+int test_metrics_count_each_reply(void) {
+  MockResponse before = get("/metrics");
+  ASSERT_EQ(200, before.status_code);
+  long long ok_before = metric(before.body, "ecewo_responses_total{class=\"2xx\"}");
+  long long err_before = metric(before.body, "ecewo_responses_total{class=\"5xx\"}");
+  free_request(&before);
+
+  MockResponse r = get("/ok");
+  ASSERT_EQ(200, r.status_code);
+  free_request(&r);
+
+  MockResponse fail = get("/fail");
+  ASSERT_EQ(500, fail.status_code);
+  free_request(&fail);
+
+  MockResponse after = get("/metrics");
+  ASSERT_EQ(200, after.status_code);
+
+  // The first scrape's own reply and /ok; a scrape is counted after rendering
+  ASSERT_EQ(ok_before + 2, metric(after.body, "ecewo_responses_total{class=\"2xx\"}"));
+  ASSERT_EQ(err_before + 1, metric(after.body, "ecewo_responses_total{class=\"5xx\"}"));
+
+  free_request(&after);
+  RETURN_OK();
+}
+
+int test_metrics_render_truncates(void) {
+  MockResponse res = get("/render-small");
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("ok", res.body);
+  free_request(&res);
+  RETURN_OK();
+}
+
+int test_metrics_spawn_queue_depth(void) {
+  MockResponse res = get("/spawn-depth");
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("ok", res.body);
+  free_request(&res);
+  RETURN_OK();
+}
+
+static void setup_routes(ecewo_app_t *app) {
+  ECEWO_GET(app, "/ok", handler_ok);
+  ECEWO_GET(app, "/fail", handler_fail);
+  ECEWO_GET(app, "/metrics", ecewo_metrics_handler);
+  ECEWO_GET(app, "/render-small", handler_render_small);
+  ECEWO_GET(app, "/spawn-depth", handler_spawn_depth);
+}
+
+int main(void) {
+  mock_init(setup_routes);
+
+  RUN_TEST(test_metrics_exposition);
+  RUN_TEST(test_metrics_count_each_reply);
+  RUN_TEST(test_metrics_render_truncates);
+  RUN_TEST(test_metrics_spawn_queue_depth);
+
+  mock_cleanup();
+  return 0;
+}
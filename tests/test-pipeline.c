@@ -0,0 +1,544 @@
+// MIT License
+//
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// HTTP/1.1 pipelining test. Several requests go out in a single write and
+// the replies must come back complete and in request order, also when one
+// of them is answered asynchronously.
+
+#include "ecewo.h"
+#include "tester.h"
+#include "uv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET sock_t;
+#define SOCK_INVALID INVALID_SOCKET
+#define sock_close(s) closesocket(s)
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int sock_t;
+#define SOCK_INVALID (-1)
+#define sock_close(s) close(s)
+#endif
+
+#define APP_PORT 18805
+
+#define BUF_SIZE (256 * 1024)
+#define MANY_REQUESTS 100
+// Far more than the socket takes at once, so the reply is still being
+// written when the requests behind it start
+#define BIG_REPLY_SIZE (8 * 1024 * 1024)
+
+static uv_thread_t server_thread;
+static _Atomic bool server_ready = false;
+
+static char big_reply[BIG_REPLY_SIZE];
+
+// ----- handlers --------------------------------------------------------------
+
+static void handler_name(ecewo_request_t *req, ecewo_response_t *res) {
+  ecewo_send_text(res, 200, ecewo_param(req, "name"));
+}
+
+static void handler_echo(ecewo_request_t *req, ecewo_response_t *res) {
+  ecewo_send(res, 200, ecewo_req_body(req), ecewo_req_body_len(req));
+}
+
+static void on_slow_reply(void *user_data) {
+  ecewo_send_text((ecewo_response_t *)user_data, 200, "slow");
+}
+
+static void handler_slow(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_timeout(on_slow_reply, 30, res);
+}
+
+typedef struct {
+  ecewo_request_t *req;
+  ecewo_response_t *res;
+} slow_echo_t;
+
+static void on_slow_echo(void *user_data) {
+  slow_echo_t *e = user_data;
+  ecewo_send(e->res, 200, ecewo_req_body(e->req), ecewo_req_body_len(e->req));
+}
+
+// Replies with the body after the rest of the read has moved on
+static void handler_slow_echo(ecewo_request_t *req, ecewo_response_t *res) {
+  slow_echo_t *e = ecewo_alloc(ecewo_req_arena(req), sizeof(slow_echo_t));
+  e->req = req;
+  e->res = res;
+  ecewo_timeout(on_slow_echo, 30, e);
+}
+
+static void on_hints_reply(void *user_data) {
+  ecewo_send_text((ecewo_response_t *)user_data, 200, "hints");
+}
+
+// Sends a 103 right away and the final reply later; the requests behind it
+// must wait for the final one
+static void handler_hints(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_header_set(res, "Link", "</style.css>; rel=preload; as=style");
+  ecewo_send(res, ECEWO_EARLY_HINTS, NULL, 0);
+  ecewo_timeout(on_hints_reply, 30, res);
+}
+
+static void on_stream_end(void *user_data) {
+  ecewo_response_t *res = user_data;
+  ecewo_stream_write(res, "streamed", 8, NULL);
+  ecewo_stream_end(res);
+}
+
+static void handler_stream(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_stream_begin_length(res, 200, 8);
+  ecewo_timeout(on_stream_end, 20, res);
+}
+
+static void handler_big(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_static(res, 200, big_reply, sizeof(big_reply));
+}
+
+static void handler_shutdown(ecewo_request_t *req, ecewo_response_t *res) {
+  ecewo_send_text(res, 200, "shutting-down");
+  ecewo_shutdown(ecewo_req_app(req));
+}
+
+// ----- minimal HTTP client ---------------------------------------------------
+
+typedef struct {
+  uv_tcp_t tcp;
+  uv_connect_t connect_req;
+  uv_write_t write_req;
+  const char *request_data;
+  char *response_buffer;
+  size_t response_len;
+  bool done;
+  int err;
+} http_client_t;
+
+static void client_alloc(uv_handle_t *handle, size_t suggested, uv_buf_t *buf) {
+  http_client_t *c = handle->data;
+  size_t avail = BUF_SIZE - c->response_len;
+  buf->base = c->response_buffer + c->response_len;
+  buf->len = avail < suggested ? avail : suggested;
+}
+
+static void client_on_close(uv_handle_t *handle) {
+  http_client_t *c = handle->data;
+  c->done = true;
+}
+
+static void client_on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+  (void)buf;
+  http_client_t *c = stream->data;
+  if (nread < 0) {
+    if (nread != UV_EOF)
+      c->err = (int)nread;
+    uv_close((uv_handle_t *)stream, client_on_close);
+    return;
+  }
+  c->response_len += (size_t)nread;
+}
+
+static void client_on_write(uv_write_t *req, int status) {
+  http_client_t *c = req->data;
+  if (status < 0) {
+    c->err = status;
+    uv_close((uv_handle_t *)&c->tcp, client_on_close);
+    return;
+  }
+  uv_read_start((uv_stream_t *)&c->tcp, client_alloc, client_on_read);
+}
+
+static void client_on_connect(uv_connect_t *req, int status) {
+  http_client_t *c = req->data;
+  if (status < 0) {
+    c->err = status;
+    uv_close((uv_handle_t *)&c->tcp, client_on_close);
+    return;
+  }
+  uv_buf_t buf = uv_buf_init((char *)c->request_data, (unsigned int)strlen(c->request_data));
+  c->write_req.data = c;
+  uv_write(&c->write_req, (uv_stream_t *)&c->tcp, &buf, 1, client_on_write);
+}
+
+// Sends a raw request and reads until the server closes the connection.
+// Returns the number of response bytes (NUL-terminated in out), or -1.
+static int http_raw(const char *request, char *out) {
+  uv_loop_t loop;
+  if (uv_loop_init(&loop) < 0)
+    return -1;
+
+  http_client_t c;
+  memset(&c, 0, sizeof(c));
+  c.tcp.data = &c;
+  c.connect_req.data = &c;
+  c.request_data = request;
+  c.response_buffer = out;
+
+  uv_tcp_init(&loop, &c.tcp);
+  struct sockaddr_in addr;
+  uv_ip4_addr("127.0.0.1", APP_PORT, &addr);
+  if (uv_tcp_connect(&c.connect_req, &c.tcp,
+                     (const struct sockaddr *)&addr, client_on_connect)
+      < 0) {
+    uv_close((uv_handle_t *)&c.tcp, client_on_close);
+  }
+
+  uint64_t start = uv_hrtime();
+  while (!c.done && uv_hrtime() - start < 5000ull * 1000000ull) {
+    uv_run(&loop, UV_RUN_NOWAIT);
+    if (c.done)
+      break;
+    uv_sleep(1);
+  }
+
+  if (!c.done) {
+    uv_close((uv_handle_t *)&c.tcp, NULL);
+    uv_run(&loop, UV_RUN_DEFAULT);
+    c.err = UV_ETIMEDOUT;
+  }
+  uv_loop_close(&loop);
+
+  if (c.err != 0 || c.response_len >= BUF_SIZE)
+    return -1;
+
+  out[c.response_len] = '\0';
+  return (int)c.response_len;
+}
+
+static int http_get_raw(const char *path, char *out) {
+  char request[256];
+  snprintf(request, sizeof(request),
+           "GET %s HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n",
+           path);
+  return http_raw(request, out);
+}
+
+static sock_t connect_server(void) {
+  sock_t sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock == SOCK_INVALID)
+    return SOCK_INVALID;
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(APP_PORT);
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+  if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+    sock_close(sock);
+    return SOCK_INVALID;
+  }
+  return sock;
+}
+
+static bool send_all(sock_t sock, const char *data) {
+  size_t len = strlen(data);
+  return send(sock, data, (int)len, 0) == (int)len;
+}
+
+// Reads one Content-Length delimited response. Its head goes to out; the
+// body is read and dropped. Returns the body length, or -1.
+static long read_response(sock_t sock, char *out, size_t size) {
+  size_t total = 0;
+  char *head_end = NULL;
+
+  while (!head_end && total < size - 1) {
+    int n = (int)recv(sock, out + total, (int)(size - 1 - total), 0);
+    if (n <= 0)
+      return -1;
+    total += (size_t)n;
+    out[total] = '\0';
+    head_end = strstr(out, "\r\n\r\n");
+  }
+
+  const char *length = strstr(out, "Content-Length: ");
+  if (!head_end || !length || length > head_end)
+    return -1;
+
+  long body_len = strtol(length + 16, NULL, 10);
+  long have = (long)(total - (size_t)(head_end + 4 - out));
+  head_end[4] = '\0';
+
+  static char scratch[64 * 1024];
+  while (have < body_len) {
+    int n = (int)recv(sock, scratch, sizeof(scratch), 0);
+    if (n <= 0)
+      return -1;
+    have += n;
+  }
+
+  return have == body_len ? body_len : -1;
+}
+
+// Splits a stream of Content-Length delimited responses and joins their
+// bodies with '|'. Returns the number of responses, or -1 on bad framing.
+static int join_bodies(const char *p, char *out) {
+  int count = 0;
+  out[0] = '\0';
+
+  while (*p) {
+    if (strncmp(p, "HTTP/1.1 200", 12) != 0)
+      return -1;
+
+    const char *head_end = strstr(p, "\r\n\r\n");
+    const char *length = strstr(p, "Content-Length: ");
+    if (!head_end || !length || length > head_end)
+      return -1;
+
+    size_t body_len = strtoul(length + 16, NULL, 10);
+    const char *body = head_end + 4;
+    if (strlen(body) < body_len)
+      return -1;
+
+    if (count > 0)
+      strcat(out, "|");
+    strncat(out, body, body_len);
+    p = body + body_len;
+    count++;
+  }
+
+  return count;
+}
+
+// ----- server thread ---------------------------------------------------------
+
+static void server_thread_fn(void *arg) {
+  (void)arg;
+
+  ecewo_app_t *app = ecewo_create();
+  if (!app) {
+    fprintf(stderr, "ecewo_create failed\n");
+    return;
+  }
+
+  ECEWO_GET(app, "/name/:name", handler_name);
+  ECEWO_POST(app, "/echo", handler_echo);
+  ECEWO_GET(app, "/slow", handler_slow);
+  ECEWO_POST(app, "/slow-echo", handler_slow_echo);
+  ECEWO_GET(app, "/stream", handler_stream);
+  ECEWO_GET(app, "/hints", handler_hints);
+  ECEWO_GET(app, "/big", handler_big);
+  ECEWO_GET(app, "/shutdown", handler_shutdown);
+
+  if (ecewo_bind(app, APP_PORT) != 0) {
+    fprintf(stderr, "bind failed\n");
+    return;
+  }
+
+  server_ready = true;
+  ecewo_run();
+  server_ready = false;
+}
+
+static bool wait_for_server_ready(char *buf) {
+  for (int i = 0; i < 50; i++) {
+    if (server_ready && http_get_raw("/name/ready", buf) > 0)
+      return true;
+    uv_sleep(100);
+  }
+  return false;
+}
+
+// ----- tests -----------------------------------------------------------------
+
+static char *response;
+static char *bodies;
+
+#define GET(path) "GET " path " HTTP/1.1\r\nHost: localhost\r\n\r\n"
+#define GET_LAST(path) "GET " path " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n"
+
+static int test_pipeline_in_order(void) {
+  ASSERT_GT(http_raw(GET("/name/a") GET("/name/b") GET_LAST("/name/c"), response), 0);
+
+  ASSERT_EQ(3, join_bodies(response, bodies));
+  ASSERT_EQ_STR("a|b|c", bodies);
+
+  RETURN_OK();
+}
+
+static int test_pipeline_with_bodies(void) {
+  ASSERT_GT(http_raw("POST /echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n\r\nfirst"
+                     GET("/name/between")
+                     "POST /echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: 4\r\n"
+                     "Connection: close\r\n\r\nlast",
+                     response),
+            0);
+
+  ASSERT_EQ(3, join_bodies(response, bodies));
+  ASSERT_EQ_STR("first|between|last", bodies);
+
+  RETURN_OK();
+}
+
+static int test_pipeline_async_body(void) {
+  // The first body is still needed after its read has moved on to the
+  // requests behind it
+  ASSERT_GT(http_raw("POST /slow-echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n\r\nfirst"
+                     "POST /slow-echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: 6\r\n\r\nsecond"
+                     GET_LAST("/name/end"),
+                     response),
+            0);
+
+  ASSERT_EQ(3, join_bodies(response, bodies));
+  ASSERT_EQ_STR("first|second|end", bodies);
+
+  RETURN_OK();
+}
+
+static int test_pipeline_async_holds_order(void) {
+  // /slow replies after the requests behind it have long been read
+  ASSERT_GT(http_raw(GET("/name/a") GET("/slow") GET("/name/b") GET_LAST("/name/c"), response), 0);
+
+  ASSERT_EQ(4, join_bodies(response, bodies));
+  ASSERT_EQ_STR("a|slow|b|c", bodies);
+
+  RETURN_OK();
+}
+
+static int test_pipeline_stream_holds_order(void) {
+  ASSERT_GT(http_raw(GET("/stream") GET("/slow") GET_LAST("/name/c"), response), 0);
+
+  ASSERT_EQ(3, join_bodies(response, bodies));
+  ASSERT_EQ_STR("streamed|slow|c", bodies);
+
+  RETURN_OK();
+}
+
+static int test_pipeline_early_hints_hold_order(void) {
+  ASSERT_GT(http_raw(GET("/hints") GET("/name/b") GET_LAST("/name/c"), response), 0);
+
+  ASSERT_EQ(0, strncmp(response, "HTTP/1.1 103", 12));
+  const char *head_end = strstr(response, "\r\n\r\n");
+  ASSERT_NOT_NULL(head_end);
+  ASSERT_NOT_NULL(strstr(response, "Link: </style.css>"));
+
+  ASSERT_EQ(3, join_bodies(head_end + 4, bodies));
+  ASSERT_EQ_STR("hints|b|c", bodies);
+
+  RETURN_OK();
+}
+
+static int test_pipeline_many(void) {
+  static char request[MANY_REQUESTS * 64];
+  char expected[MANY_REQUESTS * 4];
+  size_t pos = 0;
+  expected[0] = '\0';
+
+  for (int i = 0; i < MANY_REQUESTS; i++) {
+    bool last = i == MANY_REQUESTS - 1;
+    pos += (size_t)snprintf(request + pos, sizeof(request) - pos,
+                            "GET /name/%d HTTP/1.1\r\nHost: x\r\n%s\r\n",
+                            i, last ? "Connection: close\r\n" : "");
+    char part[8];
+    snprintf(part, sizeof(part), "%s%d", i ? "|" : "", i);
+    strcat(expected, part);
+  }
+
+  ASSERT_GT(http_raw(request, response), 0);
+
+  ASSERT_EQ(MANY_REQUESTS, join_bodies(response, bodies));
+  ASSERT_EQ_STR(expected, bodies);
+
+  RETURN_OK();
+}
+
+static int test_pipeline_bad_request_after_good(void) {
+  ASSERT_GT(http_raw(GET("/name/ok") "NOT-HTTP\r\n\r\n", response), 0);
+
+  // The first reply goes out before the 400 and the connection is closed
+  ASSERT_EQ(0, strncmp(response, "HTTP/1.1 200", 12));
+  const char *second = strstr(response + 12, "HTTP/1.1 400");
+  ASSERT_NOT_NULL(second);
+  ASSERT_NOT_NULL(strstr(response, "\r\n\r\nok"));
+
+  RETURN_OK();
+}
+
+// The reply to /big finishes writing only after the next request was
+// started from the bytes behind it; that request must not be reset when it
+// does
+static int test_pipeline_async_write_then_partial(void) {
+  sock_t sock = connect_server();
+  ASSERT_TRUE(sock != SOCK_INVALID);
+
+  ASSERT_TRUE(send_all(sock, GET("/big") "GET /name/after HTTP/1.1\r\nHo"));
+  uv_sleep(50);
+
+  ASSERT_EQ(BIG_REPLY_SIZE, read_response(sock, response, BUF_SIZE));
+  ASSERT_EQ(0, strncmp(response, "HTTP/1.1 200", 12));
+
+  // The big write has completed by now
+  uv_sleep(50);
+  ASSERT_TRUE(send_all(sock, "st: localhost\r\n\r\n"));
+
+  ASSERT_EQ(5, read_response(sock, response, BUF_SIZE));
+  sock_close(sock);
+
+  ASSERT_EQ(0, strncmp(response, "HTTP/1.1 200", 12));
+  RETURN_OK();
+}
+
+int main(void) {
+  response = malloc(BUF_SIZE);
+  bodies = malloc(BUF_SIZE);
+  if (!response || !bodies)
+    return 1;
+
+  if (uv_thread_create(&server_thread, server_thread_fn, NULL) != 0) {
+    fprintf(stderr, "Failed to create server thread\n");
+    return 1;
+  }
+
+  if (!wait_for_server_ready(response)) {
+    fprintf(stderr, "Server failed to start\n");
+    return 1;
+  }
+
+  RUN_TEST(test_pipeline_in_order);
+  RUN_TEST(test_pipeline_with_bodies);
+  RUN_TEST(test_pipeline_async_body);
+  RUN_TEST(test_pipeline_async_holds_order);
+  RUN_TEST(test_pipeline_stream_holds_order);
+  RUN_TEST(test_pipeline_early_hints_hold_order);
+  RUN_TEST(test_pipeline_many);
+  RUN_TEST(test_pipeline_bad_request_after_good);
+  RUN_TEST(test_pipeline_async_write_then_partial);
+
+  http_get_raw("/shutdown", response);
+  uv_thread_join(&server_thread);
+
+  free(response);
+  free(bodies);
+  return 0;
+}
@@ -23,6 +23,7 @@
 #include "ecewo.h"
 #include "ecewo-mock.h"
 #include "tester.h"
+#include <stdlib.h>
 #include <string.h>
 
 void handler_query_params(ecewo_request_t *req, ecewo_response_t *res) {
@@ -62,7 +63,7 @@ int test_query_empty_value(void) {
   MockResponse res = request(&params);
 
   ASSERT_EQ(200, res.status_code);
-  // Empty value should result in null (based on parse_query logic)
+  // Empty value should result in null (based on http_parse_query logic)
   ASSERT_EQ_STR("page=1,limit=null,sort=asc", res.body);
 
   free_request(&res);
@@ -84,8 +85,96 @@ int test_query_no_params(void) {
   RETURN_OK();
 }
 
+typedef struct {
+  ecewo_arena_t *arena;
+  char *out;
+  int limit; // stop after this many pairs, 0 for all
+  int seen;
+} each_ctx_t;
+
+static bool collect_pair(const char *key, size_t key_len, const char *value, size_t value_len, void *user_data) {
+  each_ctx_t *ctx = user_data;
+  ctx->out = ecewo_sprintf(ctx->arena, "%s[%.*s|%.*s]",
+                           ctx->out,
+                           (int)key_len, key,
+                           value ? (int)value_len : 4, value ? value : "NULL");
+  return ++ctx->seen != ctx->limit;
+}
+
+void handler_query_each(ecewo_request_t *req, ecewo_response_t *res) {
+  const char *limit = ecewo_query(req, "stop_after");
+
+  each_ctx_t ctx = {
+    .arena = ecewo_req_arena(req),
+    .out = "",
+    .limit = limit ? atoi(limit) : 0,
+  };
+
+  size_t visited = ecewo_query_each(req, collect_pair, &ctx);
+  ecewo_send_text(res, 200, ecewo_sprintf(ctx.arena, "%zu:%s", visited, ctx.out));
+}
+
+int test_query_each_raw(void) {
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = "/each?q=a%20b+c&&flag&empty=&url=http%3A%2F%2Fx"
+  };
+
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("4:[q|a%20b+c][flag|NULL][empty|][url|http%3A%2F%2Fx]", res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+int test_query_each_stops(void) {
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = "/each?a=1&stop_after=2&c=3"
+  };
+
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("2:[a|1][stop_after|2]", res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+void handler_query_decoded(ecewo_request_t *req, ecewo_response_t *res) {
+  // The first lookup parses the query string; the second reuses it
+  const char *first = ecewo_query(req, "q");
+  const char *again = ecewo_query(req, "q");
+  const char *missing = ecewo_query(req, "missing");
+
+  ecewo_send_text(res, 200, ecewo_sprintf(ecewo_req_arena(req), "%s,%s,%s",
+                                          first ? first : "null",
+                                          first == again ? "same" : "reparsed",
+                                          missing ? missing : "null"));
+}
+
+int test_query_decoded_once(void) {
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = "/decoded?q=a%20b+c"
+  };
+
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("a b c,same,null", res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
 static void setup_routes(ecewo_app_t *app) {
   ECEWO_GET(app, "/search", handler_query_params);
+  ECEWO_GET(app, "/each", handler_query_each);
+  ECEWO_GET(app, "/decoded", handler_query_decoded);
 }
 
 int main(void) {
@@ -94,6 +183,9 @@ int main(void) {
   RUN_TEST(test_query_multiple);
   RUN_TEST(test_query_empty_value);
   RUN_TEST(test_query_no_params);
+  RUN_TEST(test_query_each_raw);
+  RUN_TEST(test_query_each_stops);
+  RUN_TEST(test_query_decoded_once);
 
   mock_cleanup();
   return 0;
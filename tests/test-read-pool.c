@@ -0,0 +1,211 @@
+// MIT License
+
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Connections borrow a read buffer from their worker only while a read is
+// handled, or until the reply to a request answered later, so keep-alive
+// connections waiting for their next request don't hold one.
+
+#include "ecewo.h"
+#include "ecewo-mock.h"
+#include "tester.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET sock_t;
+#define SOCK_INVALID INVALID_SOCKET
+#define sock_close(s) closesocket(s)
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int sock_t;
+#define SOCK_INVALID (-1)
+#define sock_close(s) close(s)
+#endif
+
+#define IDLE_CONNECTIONS 16
+
+#define HITS "ecewo_read_pool_hits_total"
+#define MISSES "ecewo_read_pool_misses_total"
+
+static ecewo_app_t *test_app;
+
+static void hello_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_text(res, 200, "hello");
+}
+
+typedef struct {
+  ecewo_request_t *req;
+  ecewo_response_t *res;
+} late_reply_t;
+
+static void on_late_reply(void *user_data) {
+  late_reply_t *late = user_data;
+  ecewo_send_text(late->res, 200, ecewo_header_get(late->req, "Host"));
+}
+
+// Replies after the read is over, so the request keeps its read buffer for
+// the headers until then
+static void late_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  late_reply_t *late = ecewo_alloc(ecewo_req_arena(req), sizeof(*late));
+  late->req = req;
+  late->res = res;
+  ecewo_timeout(on_late_reply, 10, late);
+}
+
+static void setup_routes(ecewo_app_t *app) {
+  test_app = app;
+
+  ECEWO_GET(app, "/hello", hello_handler);
+  ECEWO_GET(app, "/late", late_handler);
+}
+
+static MockResponse get(const char *path) {
+  return request(&(MockParams){
+    .method = MOCK_GET,
+    .path = path,
+  });
+}
+
+// Sends one keep-alive request and waits for a reply whose body starts with
+// expected; the connection stays open
+static sock_t open_idle_connection(const char *path, const char *expected) {
+  sock_t sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock == SOCK_INVALID)
+    return SOCK_INVALID;
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(TEST_PORT);
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+  char request_line[128];
+  int request_len = snprintf(request_line, sizeof(request_line),
+                             "GET %s HTTP/1.1\r\nHost: localhost\r\n\r\n", path);
+  if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0
+      || send(sock, request_line, request_len, 0) != request_len) {
+    sock_close(sock);
+    return SOCK_INVALID;
+  }
+
+  char response[1024];
+  size_t total = 0;
+  while (total < sizeof(response) - 1) {
+    int n = (int)recv(sock, response + total, (int)(sizeof(response) - 1 - total), 0);
+    if (n <= 0)
+      break;
+    total += (size_t)n;
+    response[total] = '\0';
+    const char *body = strstr(response, "\r\n\r\n");
+    if (body && strncmp(body + 4, expected, strlen(expected)) == 0)
+      return sock;
+  }
+
+  sock_close(sock);
+  return SOCK_INVALID;
+}
+
+static int test_buffers_are_reused(void) {
+  MockResponse res = get("/hello");
+  ASSERT_EQ(200, res.status_code);
+  free_request(&res);
+
+  long long hits, misses;
+  metric_pair(test_app, HITS, MISSES, &hits, &misses);
+  ASSERT_TRUE(hits >= 0);
+  ASSERT_TRUE(misses > 0);
+
+  for (int i = 0; i < 20; i++) {
+    res = get("/hello");
+    ASSERT_EQ(200, res.status_code);
+    ASSERT_EQ_STR("hello", res.body);
+    free_request(&res);
+  }
+
+  long long hits_after, misses_after;
+  metric_pair(test_app, HITS, MISSES, &hits_after, &misses_after);
+
+  ASSERT_EQ(misses, misses_after);
+  ASSERT_TRUE(hits_after >= hits + 20);
+  RETURN_OK();
+}
+
+static int test_idle_connections_hold_no_buffer(void) {
+  long long hits, misses;
+  metric_pair(test_app, HITS, MISSES, &hits, &misses);
+
+  sock_t socks[IDLE_CONNECTIONS];
+  for (int i = 0; i < IDLE_CONNECTIONS; i++) {
+    socks[i] = open_idle_connection("/hello", "hello");
+    ASSERT_TRUE(socks[i] != SOCK_INVALID);
+  }
+
+  long long hits_after, misses_after;
+  metric_pair(test_app, HITS, MISSES, &hits_after, &misses_after);
+
+  for (int i = 0; i < IDLE_CONNECTIONS; i++)
+    sock_close(socks[i]);
+
+  // Every connection handed its buffer back before the next one read
+  ASSERT_EQ(misses, misses_after);
+  ASSERT_TRUE(hits_after >= hits + IDLE_CONNECTIONS);
+  RETURN_OK();
+}
+
+static int test_async_reply_returns_buffer(void) {
+  long long hits, misses;
+  metric_pair(test_app, HITS, MISSES, &hits, &misses);
+
+  sock_t socks[IDLE_CONNECTIONS];
+  for (int i = 0; i < IDLE_CONNECTIONS; i++) {
+    socks[i] = open_idle_connection("/late", "localhost");
+    ASSERT_TRUE(socks[i] != SOCK_INVALID);
+  }
+
+  long long hits_after, misses_after;
+  metric_pair(test_app, HITS, MISSES, &hits_after, &misses_after);
+
+  for (int i = 0; i < IDLE_CONNECTIONS; i++)
+    sock_close(socks[i]);
+
+  // Each request held its buffer only until its reply
+  ASSERT_EQ(misses, misses_after);
+  RETURN_OK();
+}
+
+int main(void) {
+  mock_init(setup_routes);
+
+  RUN_TEST(test_buffers_are_reused);
+  RUN_TEST(test_idle_connections_hold_no_buffer);
+  RUN_TEST(test_async_reply_returns_buffer);
+
+  mock_cleanup();
+  return 0;
+}
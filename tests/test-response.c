@@ -23,6 +23,9 @@
 #include "ecewo.h"
 #include "ecewo-mock.h"
 #include "tester.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 // JSON
 void handler_json_response(ecewo_request_t *req, ecewo_response_t *res) {
@@ -144,13 +147,226 @@ int test_404_wrong_method(void) {
   RETURN_OK();
 }
 
+// STATIC BODY
+static const char static_body[] = "static response body";
+
+void handler_static_body(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_header_set(res, "Content-Type", "text/plain");
+  ecewo_send_static(res, 200, static_body, sizeof(static_body) - 1);
+}
+
+int test_send_static(void) {
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = "/static-body"
+  };
+
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR(static_body, res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+// OWNED BODY
+// Larger than a socket send buffer, so part of it is written asynchronously
+#define OWNED_BODY_SIZE (8 * 1024 * 1024)
+
+static int owned_frees = 0;
+
+static void count_and_free(void *data) {
+  owned_frees++;
+  free(data);
+}
+
+void handler_owned_body(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  char *body = malloc(OWNED_BODY_SIZE);
+  if (!body) {
+    ecewo_send_text(res, 500, "OOM");
+    return;
+  }
+
+  for (size_t i = 0; i < OWNED_BODY_SIZE; i++)
+    body[i] = (char)('a' + i % 26);
+
+  ecewo_header_set(res, "Content-Type", "text/plain");
+  ecewo_send_owned(res, 200, body, OWNED_BODY_SIZE, count_and_free);
+}
+
+void handler_owned_frees(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  char *msg = ecewo_sprintf(ecewo_res_arena(res), "%d", owned_frees);
+  ecewo_send_text(res, 200, msg);
+}
+
+int test_send_owned(void) {
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = "/owned-body"
+  };
+
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_NOT_NULL(res.body);
+  ASSERT_EQ(OWNED_BODY_SIZE, (int64_t)strlen(res.body));
+  for (size_t i = 0; i < OWNED_BODY_SIZE; i += 4093) {
+    ASSERT_EQ('a' + (int)(i % 26), res.body[i]);
+  }
+
+  free_request(&res);
+
+  // The buffer is released exactly once after the write completes
+  MockParams count_params = {
+    .method = MOCK_GET,
+    .path = "/owned-frees"
+  };
+
+  MockResponse count = request(&count_params);
+  ASSERT_EQ(200, count.status_code);
+  ASSERT_EQ_STR("1", count.body);
+
+  free_request(&count);
+  RETURN_OK();
+}
+
+// TEMPLATES
+static const char health_body[] = "{\"status\":\"up\"}";
+static ecewo_response_template_t *health_template = NULL;
+static ecewo_response_template_t *no_content_template = NULL;
+static ecewo_response_template_t *not_modified_template = NULL;
+
+void handler_template(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_header_set(res, "X-Per-Request", "yes");
+  ecewo_send_template(res, health_template);
+}
+
+void handler_template_no_content(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_template(res, no_content_template);
+}
+
+void handler_template_not_modified(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_template(res, not_modified_template);
+}
+
+static void build_templates(void) {
+  health_template = ecewo_template_new(200);
+  ecewo_template_header(health_template, "Content-Type", "application/json");
+  ecewo_template_body(health_template, health_body, sizeof(health_body) - 1);
+  ecewo_template_header(health_template, "Cache-Control", "no-store");
+
+  no_content_template = ecewo_template_new(204);
+  not_modified_template = ecewo_template_new(304);
+  ecewo_template_header(not_modified_template, "ETag", "\"v1\"");
+}
+
+int test_send_template(void) {
+  for (int i = 0; i < 3; i++) {
+    MockParams params = {
+      .method = MOCK_GET,
+      .path = "/template"
+    };
+
+    MockResponse res = request(&params);
+
+    ASSERT_EQ(200, res.status_code);
+    ASSERT_EQ_STR(health_body, res.body);
+    ASSERT_EQ_STR("application/json", mock_get_header(&res, "Content-Type"));
+    ASSERT_EQ_STR("no-store", mock_get_header(&res, "Cache-Control"));
+    ASSERT_EQ_STR("yes", mock_get_header(&res, "X-Per-Request"));
+    ASSERT_NOT_NULL(mock_get_header(&res, "Date"));
+
+    free_request(&res);
+  }
+  RETURN_OK();
+}
+
+int test_send_template_head(void) {
+  MockParams params = {
+    .method = MOCK_HEAD,
+    .path = "/template"
+  };
+
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ(0, res.body_len);
+
+  char expected[16];
+  snprintf(expected, sizeof(expected), "%zu", sizeof(health_body) - 1);
+  ASSERT_EQ_STR(expected, mock_get_header(&res, "Content-Length"));
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+int test_send_template_no_content(void) {
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = "/template-204"
+  };
+
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(204, res.status_code);
+  ASSERT_EQ(0, res.body_len);
+  ASSERT_NULL(mock_get_header(&res, "Content-Length"));
+  free_request(&res);
+
+  params.path = "/template-304";
+  res = request(&params);
+
+  ASSERT_EQ(304, res.status_code);
+  ASSERT_EQ(0, res.body_len);
+  ASSERT_EQ_STR("\"v1\"", mock_get_header(&res, "ETag"));
+  ASSERT_NULL(mock_get_header(&res, "Content-Length"));
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+int test_template_rejects(void) {
+  ASSERT_NULL(ecewo_template_new(101));
+
+  ecewo_response_template_t *tpl = ecewo_template_new(204);
+  ASSERT_NOT_NULL(tpl);
+  ASSERT_EQ(-1, ecewo_template_body(tpl, "x", 1));
+  ASSERT_EQ(-1, ecewo_template_header(tpl, "Content-Length", "1"));
+  ASSERT_EQ(-1, ecewo_template_header(tpl, "X-Evil", "a\r\nb: c"));
+  ASSERT_EQ(0, ecewo_template_header(tpl, "X-Fine", "ok"));
+  ecewo_template_free(tpl);
+
+  tpl = ecewo_template_new(304);
+  ASSERT_NOT_NULL(tpl);
+  ASSERT_EQ(-1, ecewo_template_body(tpl, "x", 1));
+  ASSERT_EQ(0, ecewo_template_body(tpl, NULL, 0));
+  ecewo_template_free(tpl);
+
+  RETURN_OK();
+}
+
 static void setup_routes(ecewo_app_t *app) {
   ECEWO_GET(app, "/json-response", handler_json_response);
   ECEWO_GET(app, "/html-response", handler_html_response);
   ECEWO_GET(app, "/status", handler_status_codes);
+  ECEWO_GET(app, "/static-body", handler_static_body);
+  ECEWO_GET(app, "/owned-body", handler_owned_body);
+  ECEWO_GET(app, "/owned-frees", handler_owned_frees);
+  ECEWO_GET(app, "/template", handler_template);
+  ECEWO_HEAD(app, "/template", handler_template);
+  ECEWO_GET(app, "/template-204", handler_template_no_content);
+  ECEWO_GET(app, "/template-304", handler_template_not_modified);
 }
 
 int main(void) {
+  build_templates();
   mock_init(setup_routes);
 
   // Response Types
@@ -161,7 +377,16 @@ int main(void) {
   RUN_TEST(test_status_500);
   RUN_TEST(test_404_unknown_path);
   RUN_TEST(test_404_wrong_method);
+  RUN_TEST(test_send_static);
+  RUN_TEST(test_send_owned);
+  RUN_TEST(test_send_template);
+  RUN_TEST(test_send_template_head);
+  RUN_TEST(test_send_template_no_content);
+  RUN_TEST(test_template_rejects);
 
   mock_cleanup();
+  ecewo_template_free(health_template);
+  ecewo_template_free(no_content_template);
+  ecewo_template_free(not_modified_template);
   return 0;
 }
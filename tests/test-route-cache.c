@@ -0,0 +1,206 @@
+// MIT License
+
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include "ecewo.h"
+#include "ecewo-mock.h"
+#include "tester.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Small enough that the eviction test cycles through it
+#define CACHE_ENTRIES 8
+
+#define HITS "ecewo_route_cache_hits_total"
+#define MISSES "ecewo_route_cache_misses_total"
+
+static ecewo_app_t *test_app;
+
+static void user_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  const char *id = ecewo_param(req, "id");
+  ecewo_send_text(res, 200, id ? id : "no-id");
+}
+
+static void user_post_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  const char *id = ecewo_param(req, "id");
+  const char *post = ecewo_param(req, "post");
+  ecewo_send_text(res, 200, ecewo_sprintf(ecewo_req_arena(req), "%s:%s", id ? id : "", post ? post : ""));
+}
+
+static void update_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_text(res, 201, "updated");
+}
+
+static void files_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  ecewo_send_text(res, 200, ecewo_req_path(req));
+}
+
+static void me_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_text(res, 200, "literal me");
+}
+
+// Registers a route on the running app; runs on the loop thread
+static void register_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  ECEWO_GET(ecewo_req_app(req), "/users/me", me_handler);
+  ecewo_send_text(res, 200, "registered");
+}
+
+static void setup_routes(ecewo_app_t *app) {
+  test_app = app;
+
+  ecewo_set_route_cache(app, CACHE_ENTRIES);
+
+  ECEWO_GET(app, "/users/:id", user_handler);
+  ECEWO_POST(app, "/users/:id", update_handler);
+  ECEWO_GET(app, "/users/:id/posts/:post", user_post_handler);
+  ECEWO_GET(app, "/files/*", files_handler);
+  ECEWO_GET(app, "/register", register_handler);
+}
+
+static MockResponse get(const char *path) {
+  return request(&(MockParams){
+    .method = MOCK_GET,
+    .path = path,
+  });
+}
+
+static int test_repeat_request_hits(void) {
+  long long hits, misses;
+  metric_pair(test_app, HITS, MISSES, &hits, &misses);
+  ASSERT_TRUE(hits >= 0);
+  ASSERT_TRUE(misses >= 0);
+
+  for (int i = 0; i < 2; i++) {
+    MockResponse res = get("/users/42");
+    ASSERT_EQ(200, res.status_code);
+    ASSERT_EQ_STR("42", res.body);
+    free_request(&res);
+  }
+
+  long long hits_after, misses_after;
+  metric_pair(test_app, HITS, MISSES, &hits_after, &misses_after);
+  ASSERT_EQ(hits + 1, hits_after);
+  ASSERT_EQ(misses + 1, misses_after);
+  RETURN_OK();
+}
+
+static int test_params_come_from_the_current_path(void) {
+  static const char *paths[] = { "/users/41/posts/7", "/users/42/posts/8", "/users/41/posts/7" };
+  static const char *bodies[] = { "41:7", "42:8", "41:7" };
+
+  for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+    MockResponse res = get(paths[i]);
+    ASSERT_EQ(200, res.status_code);
+    ASSERT_EQ_STR(bodies[i], res.body);
+    free_request(&res);
+  }
+  RETURN_OK();
+}
+
+static int test_method_is_part_of_the_key(void) {
+  MockResponse res = get("/users/5");
+  ASSERT_EQ(200, res.status_code);
+  free_request(&res);
+
+  res = request(&(MockParams){
+    .method = MOCK_POST,
+    .path = "/users/5",
+  });
+  ASSERT_EQ(201, res.status_code);
+  ASSERT_EQ_STR("updated", res.body);
+  free_request(&res);
+  RETURN_OK();
+}
+
+static int test_eviction(void) {
+  // Far more distinct paths than entries, each asked for twice
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < 10 * CACHE_ENTRIES; i++) {
+      char path[32], id[16];
+      snprintf(path, sizeof(path), "/users/%d", i);
+      snprintf(id, sizeof(id), "%d", i);
+      MockResponse res = get(path);
+      ASSERT_EQ(200, res.status_code);
+      ASSERT_EQ_STR(id, res.body);
+      free_request(&res);
+    }
+  }
+  RETURN_OK();
+}
+
+static int test_long_path_is_not_cached(void) {
+  char path[256];
+  memcpy(path, "/files/", 7);
+  memset(path + 7, 'a', sizeof(path) - 8);
+  path[sizeof(path) - 1] = '\0';
+
+  long long hits, misses;
+  metric_pair(test_app, HITS, MISSES, &hits, &misses);
+
+  for (int i = 0; i < 2; i++) {
+    MockResponse res = get(path);
+    ASSERT_EQ(200, res.status_code);
+    ASSERT_EQ_STR(path, res.body);
+    free_request(&res);
+  }
+
+  long long hits_after, misses_after;
+  metric_pair(test_app, HITS, MISSES, &hits_after, &misses_after);
+  ASSERT_EQ(hits, hits_after);
+  ASSERT_EQ(misses + 2, misses_after);
+  RETURN_OK();
+}
+
+static int test_route_added_after_bind(void) {
+  for (int i = 0; i < 2; i++) {
+    MockResponse res = get("/users/me");
+    ASSERT_EQ(200, res.status_code);
+    ASSERT_EQ_STR("me", res.body);
+    free_request(&res);
+  }
+
+  MockResponse res = get("/register");
+  ASSERT_EQ(200, res.status_code);
+  free_request(&res);
+
+  // The cached param match must not shadow the new literal route
+  res = get("/users/me");
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("literal me", res.body);
+  free_request(&res);
+  RETURN_OK();
+}
+
+int main(void) {
+  mock_init(setup_routes);
+
+  RUN_TEST(test_repeat_request_hits);
+  RUN_TEST(test_params_come_from_the_current_path);
+  RUN_TEST(test_method_is_part_of_the_key);
+  RUN_TEST(test_eviction);
+  RUN_TEST(test_long_path_is_not_cached);
+  RUN_TEST(test_route_added_after_bind);
+
+  mock_cleanup();
+  return 0;
+}
@@ -0,0 +1,187 @@
+// MIT License
+
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include "ecewo.h"
+#include "ecewo-mock.h"
+#include "tester.h"
+#include <stdio.h>
+#include <string.h>
+
+#define STATIC_ROUTES 500
+
+static int freeze_result = -2;
+
+static void get_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  ecewo_send_text(res, 200, ecewo_req_path(req));
+}
+
+static void post_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_text(res, 201, "post");
+}
+
+static void param_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  const char *id = ecewo_param(req, "id");
+  ecewo_send_text(res, 202, id ? id : "no-id");
+}
+
+static void late_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_text(res, 200, "late");
+}
+
+// Registers a route on the running app; runs on the loop thread
+static void register_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  ECEWO_GET(ecewo_req_app(req), "/late", late_handler);
+  ecewo_send_text(res, 200, "registered");
+}
+
+static void setup_routes(ecewo_app_t *app) {
+  // Enough literal routes that the perfect hash needs several displacements
+  for (int i = 0; i < STATIC_ROUTES; i++) {
+    char *path = ecewo_sprintf(ecewo_app_arena(app), "/static/%d/page", i);
+    ECEWO_GET(app, path, get_handler);
+  }
+
+  ECEWO_GET(app, "/", get_handler);
+  ECEWO_POST(app, "/static/7/page", post_handler);
+  ECEWO_GET(app, "/static/:id/page", param_handler);
+  ECEWO_GET(app, "/register", register_handler);
+
+  freeze_result = ecewo_routes_freeze(app);
+}
+
+static int test_freeze(void) {
+  ASSERT_EQ(0, freeze_result);
+  ASSERT_EQ(-1, ecewo_routes_freeze(NULL));
+  RETURN_OK();
+}
+
+static int test_every_static_route(void) {
+  for (int i = 0; i < STATIC_ROUTES; i++) {
+    char path[64];
+    snprintf(path, sizeof(path), "/static/%d/page", i);
+    MockResponse res = request(&(MockParams){
+      .method = MOCK_GET,
+      .path = path,
+    });
+    ASSERT_EQ(200, res.status_code);
+    ASSERT_EQ_STR(path, res.body);
+    free_request(&res);
+  }
+  RETURN_OK();
+}
+
+static int test_root(void) {
+  MockResponse res = request(&(MockParams){
+    .method = MOCK_GET,
+    .path = "/",
+  });
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("/", res.body);
+  free_request(&res);
+  RETURN_OK();
+}
+
+static int test_method_is_part_of_the_key(void) {
+  MockResponse res = request(&(MockParams){
+    .method = MOCK_POST,
+    .path = "/static/7/page",
+  });
+  ASSERT_EQ(201, res.status_code);
+  ASSERT_EQ_STR("post", res.body);
+  free_request(&res);
+  RETURN_OK();
+}
+
+static int test_unregistered_literal_falls_to_param(void) {
+  // Not in the static index; the compiled tree matches the :id route
+  MockResponse res = request(&(MockParams){
+    .method = MOCK_GET,
+    .path = "/static/abc/page",
+  });
+  ASSERT_EQ(202, res.status_code);
+  ASSERT_EQ_STR("abc", res.body);
+  free_request(&res);
+  RETURN_OK();
+}
+
+static int test_non_canonical_spelling(void) {
+  // Miss the static index, match through the tokenized path
+  static const char *paths[] = { "/static/3/page/", "//static/3/page", "/static//3/page" };
+  for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+    MockResponse res = request(&(MockParams){
+      .method = MOCK_GET,
+      .path = paths[i],
+    });
+    ASSERT_EQ(200, res.status_code);
+    free_request(&res);
+  }
+  RETURN_OK();
+}
+
+static int test_route_added_after_bind(void) {
+  MockResponse res = request(&(MockParams){
+    .method = MOCK_GET,
+    .path = "/late",
+  });
+  ASSERT_EQ(404, res.status_code);
+  free_request(&res);
+
+  res = request(&(MockParams){
+    .method = MOCK_GET,
+    .path = "/register",
+  });
+  ASSERT_EQ(200, res.status_code);
+  free_request(&res);
+
+  // The table is rebuilt on the next request
+  res = request(&(MockParams){
+    .method = MOCK_GET,
+    .path = "/late",
+  });
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("late", res.body);
+  free_request(&res);
+
+  res = request(&(MockParams){
+    .method = MOCK_GET,
+    .path = "/static/42/page",
+  });
+  ASSERT_EQ(200, res.status_code);
+  free_request(&res);
+  RETURN_OK();
+}
+
+int main(void) {
+  mock_init(setup_routes);
+
+  RUN_TEST(test_freeze);
+  RUN_TEST(test_every_static_route);
+  RUN_TEST(test_root);
+  RUN_TEST(test_method_is_part_of_the_key);
+  RUN_TEST(test_unregistered_literal_falls_to_param);
+  RUN_TEST(test_non_canonical_spelling);
+  RUN_TEST(test_route_added_after_bind);
+
+  mock_cleanup();
+  return 0;
+}
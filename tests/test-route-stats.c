@@ -0,0 +1,199 @@
+// MIT License
+
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ecewo.h"
+#include "ecewo-mock.h"
+#include "tester.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SLOW_MS 40
+
+static void handler_fast(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_text(res, 200, "fast");
+}
+
+static void on_slow_reply(void *user_data) {
+  ecewo_send_text((ecewo_response_t *)user_data, 200, "slow");
+}
+
+static void handler_slow(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_timeout(on_slow_reply, SLOW_MS, res);
+}
+
+static void handler_user(ecewo_request_t *req, ecewo_response_t *res) {
+  ecewo_send_text(res, 200, ecewo_param(req, "id"));
+}
+
+typedef struct {
+  char text[2048];
+  size_t len;
+} stats_dump_t;
+
+static void dump_route(const ecewo_route_stats_t *stats, void *user_data) {
+  stats_dump_t *dump = user_data;
+  int n = snprintf(dump->text + dump->len, sizeof(dump->text) - dump->len,
+                   "%d %s %llu %llu %llu %llu\n",
+                   (int)ecewo_route_stats_method(stats),
+                   ecewo_route_stats_pattern(stats),
+                   (unsigned long long)ecewo_route_stats_count(stats),
+                   (unsigned long long)ecewo_route_stats_percentile(stats, 50),
+                   (unsigned long long)ecewo_route_stats_percentile(stats, 99),
+                   (unsigned long long)ecewo_route_stats_percentile(stats, 99.9));
+  if (n > 0 && dump->len + (size_t)n < sizeof(dump->text))
+    dump->len += (size_t)n;
+}
+
+// One line per route: "<method> <pattern> <count> <p50> <p99> <p999>"
+static void handler_stats(ecewo_request_t *req, ecewo_response_t *res) {
+  stats_dump_t dump = { .len = 0 };
+  dump.text[0] = '\0';
+  ecewo_route_stats_each(ecewo_req_app(req), dump_route, &dump);
+  ecewo_send_text(res, 200, dump.text);
+}
+
+typedef struct {
+  int method;
+  unsigned long long count;
+  unsigned long long p50;
+  unsigned long long p99;
+  unsigned long long p999;
+} route_line_t;
+
+static bool find_route(const char *body, const char *pattern, route_line_t *out) {
+  const char *p = body;
+  while (p && *p) {
+    char pat[128];
+    if (sscanf(p, "%d %127s %llu %llu %llu %llu",
+               &out->method, pat, &out->count, &out->p50, &out->p99, &out->p999)
+            == 6
+        && strcmp(pat, pattern) == 0)
+      return true;
+
+    p = strchr(p, '\n');
+    if (p)
+      p++;
+  }
+  return false;
+}
+
+static int get_status(const char *path) {
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = path
+  };
+  MockResponse res = request(&params);
+  int status = res.status_code;
+  free_request(&res);
+  return status;
+}
+
+static MockResponse get_stats(void) {
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = "/stats"
+  };
+  return request(&params);
+}
+
+int test_route_stats_untouched(void) {
+  MockResponse res = get_stats();
+  ASSERT_EQ(200, res.status_code);
+
+  route_line_t line;
+  ASSERT_TRUE(find_route(res.body, "/never", &line));
+  ASSERT_EQ(ECEWO_METHOD_POST, line.method);
+  ASSERT_EQ(0, line.count);
+  ASSERT_EQ(0, line.p50);
+
+  // Registration order
+  ASSERT_TRUE(strstr(res.body, "/fast") < strstr(res.body, "/slow"));
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+int test_route_stats_counts(void) {
+  for (int i = 0; i < 5; i++)
+    ASSERT_EQ(200, get_status("/fast"));
+  ASSERT_EQ(200, get_status("/users/1"));
+  ASSERT_EQ(200, get_status("/users/2"));
+  ASSERT_EQ(404, get_status("/nowhere"));
+
+  MockResponse res = get_stats();
+  ASSERT_EQ(200, res.status_code);
+
+  route_line_t line;
+  ASSERT_TRUE(find_route(res.body, "/fast", &line));
+  ASSERT_EQ(ECEWO_METHOD_GET, line.method);
+  ASSERT_EQ(5, line.count);
+  ASSERT_LE(line.p50, line.p99);
+  ASSERT_LE(line.p99, line.p999);
+  ASSERT_GT(SLOW_MS * 1000, line.p999);
+
+  // Recorded under the pattern, not the concrete path
+  ASSERT_TRUE(find_route(res.body, "/users/:id", &line));
+  ASSERT_EQ(2, line.count);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+int test_route_stats_async_latency(void) {
+  for (int i = 0; i < 3; i++)
+    ASSERT_EQ(200, get_status("/slow"));
+
+  MockResponse res = get_stats();
+  ASSERT_EQ(200, res.status_code);
+
+  // Measured up to the deferred reply, not the handler's return
+  route_line_t line;
+  ASSERT_TRUE(find_route(res.body, "/slow", &line));
+  ASSERT_EQ(3, line.count);
+  ASSERT_LE(SLOW_MS * 1000, line.p50);
+  ASSERT_GT(SLOW_MS * 1000 * 20, line.p999);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+static void setup_routes(ecewo_app_t *app) {
+  ECEWO_GET(app, "/fast", handler_fast);
+  ECEWO_GET(app, "/slow", handler_slow);
+  ECEWO_GET(app, "/users/:id", handler_user);
+  ECEWO_POST(app, "/never", handler_fast);
+  ECEWO_GET(app, "/stats", handler_stats);
+}
+
+int main(void) {
+  mock_init(setup_routes);
+
+  RUN_TEST(test_route_stats_untouched);
+  RUN_TEST(test_route_stats_counts);
+  RUN_TEST(test_route_stats_async_latency);
+
+  mock_cleanup();
+  return 0;
+}
@@ -165,6 +165,23 @@ static int test_wildcard_mid_does_not_match_different_prefix(void) {
   RETURN_OK();
 }
 
+static int test_wildcard_matches_very_deep_path(void) {
+  // More segments than any pattern can have; the matcher cuts them as it
+  // goes, so the wildcard still takes them all
+  char path[1024] = "/prefix";
+  for (int i = 0; i < 200; i++)
+    strcat(path, "/x");
+
+  MockResponse res = request(&(MockParams){
+    .method = MOCK_GET,
+    .path = path
+  });
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("wildcard-mid", res.body);
+  free_request(&res);
+  RETURN_OK();
+}
+
 // -------------------------------------------------------------------------
 // Edge case 3: percent-encoded characters are opaque to the router
 //
@@ -227,6 +244,7 @@ int main(void) {
   RUN_TEST(test_wildcard_mid_matches_multiple_segments_after_prefix);
   RUN_TEST(test_bare_colon_beats_wildcard_for_prefix_alone);
   RUN_TEST(test_wildcard_mid_does_not_match_different_prefix);
+  RUN_TEST(test_wildcard_matches_very_deep_path);
 
   RUN_TEST(test_percent_encoded_matches_literal_bytes);
   RUN_TEST(test_real_slash_does_not_match_encoded_route);
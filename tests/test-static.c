@@ -0,0 +1,286 @@
+// MIT License
+
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ecewo.h"
+#include "ecewo-mock.h"
+#include "tester.h"
+#include "uv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROOT "static-test-root"
+#define PUBLIC ROOT "/public"
+#define BIG_SIZE (4 * 1024 * 1024 + 123)
+#define CACHE_VALID_MS 2000 // FILE_CACHE_VALID_MS default
+
+static const char index_html[] = "<h1>index</h1>";
+static const char app_js[] = "console.log('app');";
+
+static char *big;
+
+static void write_file(const char *path, const void *data, size_t len) {
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    fprintf(stderr, "Failed to create %s\n", path);
+    exit(1);
+  }
+  fwrite(data, 1, len, f);
+  fclose(f);
+}
+
+static void make_fixtures(void) {
+  uv_fs_t req;
+  uv_fs_mkdir(NULL, &req, ROOT, 0755, NULL);
+  uv_fs_req_cleanup(&req);
+  uv_fs_mkdir(NULL, &req, PUBLIC, 0755, NULL);
+  uv_fs_req_cleanup(&req);
+
+  big = malloc(BIG_SIZE);
+  for (size_t i = 0; i < BIG_SIZE; i++)
+    big[i] = (char)('a' + i % 26);
+
+  write_file(PUBLIC "/index.html", index_html, sizeof(index_html) - 1);
+  write_file(PUBLIC "/app.js", app_js, sizeof(app_js) - 1);
+  write_file(PUBLIC "/big.bin", big, BIG_SIZE);
+  write_file(ROOT "/secret.txt", "secret", 6);
+  write_file(PUBLIC "/changing.txt", "old", 3);
+}
+
+static void remove_fixtures(void) {
+  const char *files[] = {
+    PUBLIC "/index.html",
+    PUBLIC "/app.js",
+    PUBLIC "/big.bin",
+    PUBLIC "/changing.txt",
+    ROOT "/secret.txt",
+  };
+  uv_fs_t req;
+  for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+    uv_fs_unlink(NULL, &req, files[i], NULL);
+    uv_fs_req_cleanup(&req);
+  }
+  uv_fs_rmdir(NULL, &req, PUBLIC, NULL);
+  uv_fs_req_cleanup(&req);
+  uv_fs_rmdir(NULL, &req, ROOT, NULL);
+  uv_fs_req_cleanup(&req);
+  free(big);
+}
+
+static void handler_download(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_header_set(res, "Content-Disposition", "attachment");
+  ecewo_send_file(res, PUBLIC "/big.bin");
+}
+
+static void handler_missing(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  if (ecewo_send_file(res, PUBLIC "/nope.txt") != 0)
+    ecewo_send_text(res, 410, "gone");
+}
+
+static MockResponse get(const char *path, MockHeaders *headers, size_t header_count) {
+  MockParams params = {
+    .method = MOCK_GET,
+    .path = path,
+    .headers = headers,
+    .header_count = header_count,
+  };
+  return request(&params);
+}
+
+static int test_static_file(void) {
+  MockResponse res = get("/assets/app.js", NULL, 0);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR(app_js, res.body);
+  ASSERT_EQ_STR("text/javascript; charset=utf-8", mock_get_header(&res, "Content-Type"));
+  ASSERT_NOT_NULL(mock_get_header(&res, "ETag"));
+  ASSERT_NOT_NULL(mock_get_header(&res, "Last-Modified"));
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+static int test_static_index(void) {
+  MockResponse res = get("/assets/", NULL, 0);
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR(index_html, res.body);
+  ASSERT_EQ_STR("text/html; charset=utf-8", mock_get_header(&res, "Content-Type"));
+  free_request(&res);
+
+  res = get("/assets", NULL, 0);
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR(index_html, res.body);
+  free_request(&res);
+
+  RETURN_OK();
+}
+
+static int test_static_not_modified(void) {
+  MockResponse first = get("/assets/app.js", NULL, 0);
+  ASSERT_EQ(200, first.status_code);
+
+  char etag[64];
+  char last_modified[64];
+  snprintf(etag, sizeof(etag), "%s", mock_get_header(&first, "ETag"));
+  snprintf(last_modified, sizeof(last_modified), "%s", mock_get_header(&first, "Last-Modified"));
+  free_request(&first);
+
+  MockHeaders inm[] = { { "If-None-Match", etag } };
+  MockResponse res = get("/assets/app.js", inm, 1);
+  ASSERT_EQ(304, res.status_code);
+  ASSERT_EQ(0, res.body_len);
+  ASSERT_EQ_STR(etag, mock_get_header(&res, "ETag"));
+  ASSERT_NULL(mock_get_header(&res, "Content-Length"));
+  free_request(&res);
+
+  // Weak comparison, anywhere in a list
+  char list[160];
+  snprintf(list, sizeof(list), "\"other\", W/%s", etag);
+  MockHeaders weak[] = { { "If-None-Match", list } };
+  res = get("/assets/app.js", weak, 1);
+  ASSERT_EQ(304, res.status_code);
+  free_request(&res);
+
+  MockHeaders stale[] = { { "If-None-Match", "\"other\"" } };
+  res = get("/assets/app.js", stale, 1);
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR(app_js, res.body);
+  free_request(&res);
+
+  MockHeaders ims[] = { { "If-Modified-Since", last_modified } };
+  res = get("/assets/app.js", ims, 1);
+  ASSERT_EQ(304, res.status_code);
+  free_request(&res);
+
+  RETURN_OK();
+}
+
+static int test_static_head(void) {
+  MockParams params = {
+    .method = MOCK_HEAD,
+    .path = "/assets/app.js",
+  };
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ(0, res.body_len);
+
+  char expected[16];
+  snprintf(expected, sizeof(expected), "%zu", sizeof(app_js) - 1);
+  ASSERT_EQ_STR(expected, mock_get_header(&res, "Content-Length"));
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+static int test_static_not_found(void) {
+  const char *paths[] = {
+    "/assets/nope.js",
+    "/assets/../secret.txt",
+    "/assets/%2e%2e/secret.txt",
+    "/assets/..%2fsecret.txt",
+    "/assets/app.js%00.png",
+  };
+
+  for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+    MockResponse res = get(paths[i], NULL, 0);
+    ASSERT_EQ(404, res.status_code);
+    free_request(&res);
+  }
+
+  RETURN_OK();
+}
+
+static int test_static_file_changed(void) {
+  MockResponse res = get("/assets/changing.txt", NULL, 0);
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("old", res.body);
+  free_request(&res);
+
+  write_file(PUBLIC "/changing.txt", "changed", 7);
+  uv_sleep(CACHE_VALID_MS + 200);
+
+  // The first request after the window may still get the cached file while
+  // the stat runs in the background; one of the next few must see the change
+  bool fresh = false;
+  for (int i = 0; i < 10 && !fresh; i++) {
+    res = get("/assets/changing.txt", NULL, 0);
+    ASSERT_EQ(200, res.status_code);
+    fresh = strcmp(res.body, "changed") == 0;
+    free_request(&res);
+    if (!fresh)
+      uv_sleep(50);
+  }
+  ASSERT_TRUE(fresh);
+
+  RETURN_OK();
+}
+
+static int test_send_file_large(void) {
+  // Several times the socket buffer, so sendfile has to come back for more
+  MockResponse res = get("/download", NULL, 0);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ(BIG_SIZE, res.body_len);
+  ASSERT_EQ(0, memcmp(big, res.body, BIG_SIZE));
+  ASSERT_EQ_STR("attachment", mock_get_header(&res, "Content-Disposition"));
+  ASSERT_EQ_STR("application/octet-stream", mock_get_header(&res, "Content-Type"));
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+static int test_send_file_missing(void) {
+  MockResponse res = get("/missing", NULL, 0);
+
+  ASSERT_EQ(410, res.status_code);
+  ASSERT_EQ_STR("gone", res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+static void setup_routes(ecewo_app_t *app) {
+  ecewo_static(app, "/assets", PUBLIC);
+  ECEWO_GET(app, "/download", handler_download);
+  ECEWO_GET(app, "/missing", handler_missing);
+}
+
+int main(void) {
+  make_fixtures();
+  mock_init(setup_routes);
+
+  RUN_TEST(test_static_file);
+  RUN_TEST(test_static_index);
+  RUN_TEST(test_static_not_modified);
+  RUN_TEST(test_static_head);
+  RUN_TEST(test_static_not_found);
+  RUN_TEST(test_static_file_changed);
+  RUN_TEST(test_send_file_large);
+  RUN_TEST(test_send_file_missing);
+
+  mock_cleanup();
+  remove_fixtures();
+  return 0;
+}
@@ -0,0 +1,472 @@
+// MIT License
+//
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Streaming response test. Talks to a live server over a raw socket so the
+// chunked framing, Content-Length mode and HTTP/1.0 close-delimited bodies
+// can be checked byte for byte.
+
+#include "ecewo.h"
+#include "tester.h"
+#include "uv.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define APP_PORT 18804
+
+#define BUF_SIZE (2 * 1024 * 1024)
+#define BIG_CHUNK_SIZE (64 * 1024)
+#define BIG_CHUNK_COUNT 16
+
+static uv_thread_t server_thread;
+static _Atomic bool server_ready = false;
+static _Atomic int chunks_done = 0;
+static _Atomic size_t max_queued = 0;
+static _Atomic size_t corked_queued = 0;
+
+static char big_chunk[BIG_CHUNK_SIZE];
+
+// ----- handlers --------------------------------------------------------------
+
+static void on_chunk_done(void *buf, int status) {
+  (void)buf;
+  if (status == 0)
+    atomic_fetch_add(&chunks_done, 1);
+}
+
+static void handler_chunked(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_header_set(res, "Content-Type", "text/plain");
+  ecewo_stream_begin(res, 200);
+  ecewo_stream_write(res, "hello ", 6, NULL);
+  ecewo_stream_write(res, "world", 5, on_chunk_done);
+  ecewo_stream_end(res);
+}
+
+static void handler_length(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_stream_begin_length(res, 200, 11);
+  ecewo_stream_write(res, "hello ", 6, NULL);
+  ecewo_stream_write(res, "world", 5, NULL);
+  // Past the declared length: rejected, nothing is sent
+  if (ecewo_stream_write(res, "!", 1, NULL) == 0)
+    ecewo_stream_write(res, "BUG", 3, NULL);
+  ecewo_stream_end(res);
+}
+
+typedef struct {
+  ecewo_response_t *res;
+  int remaining;
+} ticker_t;
+
+static void on_tick(void *user_data) {
+  ticker_t *t = user_data;
+  char line[16];
+  int n = snprintf(line, sizeof(line), "tick%d\n", t->remaining);
+  ecewo_stream_write(t->res, line, (size_t)n, NULL);
+
+  if (--t->remaining > 0) {
+    ecewo_timeout(on_tick, 5, t);
+    return;
+  }
+  ecewo_stream_end(t->res);
+}
+
+static void handler_ticks(ecewo_request_t *req, ecewo_response_t *res) {
+  ticker_t *t = ecewo_alloc(ecewo_req_arena(req), sizeof(ticker_t));
+  t->res = res;
+  t->remaining = 3;
+  ecewo_stream_begin(res, 200);
+  ecewo_timeout(on_tick, 5, t);
+}
+
+static void handler_big(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_stream_begin(res, 200);
+  for (int i = 0; i < BIG_CHUNK_COUNT; i++) {
+    ecewo_stream_write(res, big_chunk, sizeof(big_chunk), on_chunk_done);
+    size_t queued = ecewo_stream_queue_size(res);
+    if (queued > max_queued)
+      max_queued = queued;
+  }
+  ecewo_stream_end(res);
+}
+
+// Small chunks wait in the cork buffer until the loop iteration ends, and
+// count as queued meanwhile
+static void handler_coalesced(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_stream_begin(res, 200);
+  ecewo_stream_write(res, "one,", 4, NULL);
+  ecewo_stream_write(res, "two,", 4, NULL);
+  ecewo_stream_write(res, "three", 5, NULL);
+  corked_queued = ecewo_stream_queue_size(res);
+  ecewo_stream_end(res);
+}
+
+static void handler_no_content(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_stream_begin(res, 204);
+  ecewo_stream_write(res, "ignored", 7, NULL);
+  ecewo_stream_end(res);
+}
+
+static void handler_send_after_begin(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_stream_begin(res, 200);
+  // Rejected: the head has already been sent
+  ecewo_send_text(res, 500, "BUG");
+  ecewo_stream_write(res, "ok", 2, NULL);
+  ecewo_stream_end(res);
+}
+
+static void handler_shutdown(ecewo_request_t *req, ecewo_response_t *res) {
+  ecewo_send_text(res, 200, "shutting-down");
+  ecewo_shutdown(ecewo_req_app(req));
+}
+
+// ----- minimal HTTP client ---------------------------------------------------
+
+typedef struct {
+  uv_tcp_t tcp;
+  uv_connect_t connect_req;
+  uv_write_t write_req;
+  const char *request_data;
+  char *response_buffer;
+  size_t response_len;
+  bool done;
+  int err;
+} http_client_t;
+
+static void client_alloc(uv_handle_t *handle, size_t suggested, uv_buf_t *buf) {
+  http_client_t *c = handle->data;
+  size_t avail = BUF_SIZE - c->response_len;
+  buf->base = c->response_buffer + c->response_len;
+  buf->len = avail < suggested ? avail : suggested;
+}
+
+static void client_on_close(uv_handle_t *handle) {
+  http_client_t *c = handle->data;
+  c->done = true;
+}
+
+static void client_on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+  (void)buf;
+  http_client_t *c = stream->data;
+  if (nread < 0) {
+    if (nread != UV_EOF)
+      c->err = (int)nread;
+    uv_close((uv_handle_t *)stream, client_on_close);
+    return;
+  }
+  c->response_len += (size_t)nread;
+}
+
+static void client_on_write(uv_write_t *req, int status) {
+  http_client_t *c = req->data;
+  if (status < 0) {
+    c->err = status;
+    uv_close((uv_handle_t *)&c->tcp, client_on_close);
+    return;
+  }
+  uv_read_start((uv_stream_t *)&c->tcp, client_alloc, client_on_read);
+}
+
+static void client_on_connect(uv_connect_t *req, int status) {
+  http_client_t *c = req->data;
+  if (status < 0) {
+    c->err = status;
+    uv_close((uv_handle_t *)&c->tcp, client_on_close);
+    return;
+  }
+  uv_buf_t buf = uv_buf_init((char *)c->request_data, (unsigned int)strlen(c->request_data));
+  c->write_req.data = c;
+  uv_write(&c->write_req, (uv_stream_t *)&c->tcp, &buf, 1, client_on_write);
+}
+
+// Sends a raw request and reads until the server closes the connection.
+// Returns the number of response bytes (NUL-terminated in out), or -1.
+static int http_raw(const char *request, char *out) {
+  uv_loop_t loop;
+  if (uv_loop_init(&loop) < 0)
+    return -1;
+
+  http_client_t c;
+  memset(&c, 0, sizeof(c));
+  c.tcp.data = &c;
+  c.connect_req.data = &c;
+  c.request_data = request;
+  c.response_buffer = out;
+
+  uv_tcp_init(&loop, &c.tcp);
+  struct sockaddr_in addr;
+  uv_ip4_addr("127.0.0.1", APP_PORT, &addr);
+  if (uv_tcp_connect(&c.connect_req, &c.tcp,
+                     (const struct sockaddr *)&addr, client_on_connect)
+      < 0) {
+    uv_close((uv_handle_t *)&c.tcp, client_on_close);
+  }
+
+  uint64_t start = uv_hrtime();
+  while (!c.done && uv_hrtime() - start < 5000ull * 1000000ull) {
+    uv_run(&loop, UV_RUN_NOWAIT);
+    if (c.done)
+      break;
+    uv_sleep(1);
+  }
+
+  if (!c.done) {
+    uv_close((uv_handle_t *)&c.tcp, NULL);
+    uv_run(&loop, UV_RUN_DEFAULT);
+    c.err = UV_ETIMEDOUT;
+  }
+  uv_loop_close(&loop);
+
+  if (c.err != 0 || c.response_len >= BUF_SIZE)
+    return -1;
+
+  out[c.response_len] = '\0';
+  return (int)c.response_len;
+}
+
+static int http_get_raw(const char *path, const char *version, char *out) {
+  char request[256];
+  snprintf(request, sizeof(request),
+           "GET %s %s\r\nHost: localhost\r\nConnection: close\r\n\r\n",
+           path, version);
+  return http_raw(request, out);
+}
+
+static const char *body_of(const char *response) {
+  const char *body = strstr(response, "\r\n\r\n");
+  return body ? body + 4 : NULL;
+}
+
+// Decodes a chunked body into out.
+// Returns the decoded length, or -1 on malformed framing.
+static long dechunk(const char *p, char *out) {
+  long total = 0;
+  for (;;) {
+    char *end;
+    unsigned long size = strtoul(p, &end, 16);
+    if (end == p || strncmp(end, "\r\n", 2) != 0)
+      return -1;
+    p = end + 2;
+    if (size == 0)
+      return strcmp(p, "\r\n") == 0 ? total : -1;
+    memcpy(out + total, p, size);
+    total += (long)size;
+    p += size;
+    if (strncmp(p, "\r\n", 2) != 0)
+      return -1;
+    p += 2;
+  }
+}
+
+// ----- server thread ---------------------------------------------------------
+
+static void server_thread_fn(void *arg) {
+  (void)arg;
+
+  ecewo_app_t *app = ecewo_create();
+  if (!app) {
+    fprintf(stderr, "ecewo_create failed\n");
+    return;
+  }
+
+  ECEWO_GET(app, "/chunked", handler_chunked);
+  ECEWO_HEAD(app, "/chunked", handler_chunked);
+  ECEWO_GET(app, "/length", handler_length);
+  ECEWO_GET(app, "/ticks", handler_ticks);
+  ECEWO_GET(app, "/big", handler_big);
+  ECEWO_GET(app, "/coalesced", handler_coalesced);
+  ECEWO_GET(app, "/no-content", handler_no_content);
+  ECEWO_GET(app, "/send-after-begin", handler_send_after_begin);
+  ECEWO_GET(app, "/shutdown", handler_shutdown);
+
+  if (ecewo_bind(app, APP_PORT) != 0) {
+    fprintf(stderr, "bind failed\n");
+    return;
+  }
+
+  server_ready = true;
+  ecewo_run();
+  server_ready = false;
+}
+
+static bool wait_for_server_ready(char *buf) {
+  for (int i = 0; i < 50; i++) {
+    if (server_ready && http_get_raw("/chunked", "HTTP/1.1", buf) > 0)
+      return true;
+    uv_sleep(100);
+  }
+  return false;
+}
+
+// ----- tests -----------------------------------------------------------------
+
+static char *response;
+static char *decoded;
+
+static int test_stream_chunked(void) {
+  int before = atomic_load(&chunks_done);
+  ASSERT_GT(http_get_raw("/chunked", "HTTP/1.1", response), 0);
+
+  ASSERT_EQ(0, strncmp(response, "HTTP/1.1 200", 12));
+  ASSERT_NOT_NULL(strstr(response, "Transfer-Encoding: chunked\r\n"));
+  ASSERT_NOT_NULL(strstr(response, "Content-Type: text/plain\r\n"));
+  ASSERT_NULL(strstr(response, "Content-Length"));
+  ASSERT_EQ_STR("6\r\nhello \r\n5\r\nworld\r\n0\r\n\r\n", body_of(response));
+  ASSERT_EQ(before + 1, atomic_load(&chunks_done));
+
+  RETURN_OK();
+}
+
+static int test_stream_length(void) {
+  ASSERT_GT(http_get_raw("/length", "HTTP/1.1", response), 0);
+
+  ASSERT_NOT_NULL(strstr(response, "Content-Length: 11\r\n"));
+  ASSERT_NULL(strstr(response, "Transfer-Encoding"));
+  ASSERT_EQ_STR("hello world", body_of(response));
+
+  RETURN_OK();
+}
+
+static int test_stream_async(void) {
+  ASSERT_GT(http_get_raw("/ticks", "HTTP/1.1", response), 0);
+
+  long n = dechunk(body_of(response), decoded);
+  ASSERT_GT(n, 0);
+  decoded[n] = '\0';
+  ASSERT_EQ_STR("tick3\ntick2\ntick1\n", decoded);
+
+  RETURN_OK();
+}
+
+static int test_stream_http10(void) {
+  ASSERT_GT(http_get_raw("/chunked", "HTTP/1.0", response), 0);
+
+  // HTTP/1.0 has no chunked coding: the body runs until the server closes
+  ASSERT_NULL(strstr(response, "Transfer-Encoding"));
+  ASSERT_NULL(strstr(response, "Content-Length"));
+  ASSERT_EQ_STR("hello world", body_of(response));
+
+  RETURN_OK();
+}
+
+static int test_stream_large(void) {
+  int before = atomic_load(&chunks_done);
+  ASSERT_GT(http_get_raw("/big", "HTTP/1.1", response), 0);
+
+  long n = dechunk(body_of(response), decoded);
+  ASSERT_EQ(BIG_CHUNK_SIZE * BIG_CHUNK_COUNT, n);
+  for (int i = 0; i < BIG_CHUNK_COUNT; i++)
+    ASSERT_EQ(0, memcmp(decoded + (long)i * BIG_CHUNK_SIZE, big_chunk, BIG_CHUNK_SIZE));
+
+  // Every in-place chunk is reported back exactly once
+  ASSERT_EQ(before + BIG_CHUNK_COUNT, atomic_load(&chunks_done));
+  // Whatever the socket did not take at once was reported as queued
+  ASSERT_LE(max_queued, BIG_CHUNK_SIZE * BIG_CHUNK_COUNT + 64);
+
+  RETURN_OK();
+}
+
+static int test_stream_coalesced(void) {
+  ASSERT_GT(http_get_raw("/coalesced", "HTTP/1.1", response), 0);
+
+  ASSERT_EQ(0, strncmp(response, "HTTP/1.1 200", 12));
+  ASSERT_EQ_STR("4\r\none,\r\n4\r\ntwo,\r\n5\r\nthree\r\n0\r\n\r\n", body_of(response));
+
+  // The head and all three framed chunks were still corked
+  ASSERT_GT(corked_queued, strlen("4\r\none,\r\n4\r\ntwo,\r\n5\r\nthree\r\n"));
+
+  RETURN_OK();
+}
+
+static int test_stream_no_content(void) {
+  ASSERT_GT(http_get_raw("/no-content", "HTTP/1.1", response), 0);
+
+  ASSERT_EQ(0, strncmp(response, "HTTP/1.1 204", 12));
+  ASSERT_NULL(strstr(response, "Transfer-Encoding"));
+  ASSERT_EQ_STR("", body_of(response));
+
+  RETURN_OK();
+}
+
+static int test_stream_head(void) {
+  ASSERT_GT(http_raw("HEAD /chunked HTTP/1.1\r\nHost: localhost\r\n"
+                     "Connection: close\r\n\r\n",
+                     response),
+            0);
+
+  ASSERT_NOT_NULL(strstr(response, "Transfer-Encoding: chunked\r\n"));
+  ASSERT_EQ_STR("", body_of(response));
+
+  RETURN_OK();
+}
+
+static int test_stream_send_after_begin(void) {
+  ASSERT_GT(http_get_raw("/send-after-begin", "HTTP/1.1", response), 0);
+
+  ASSERT_EQ(0, strncmp(response, "HTTP/1.1 200", 12));
+  ASSERT_EQ_STR("2\r\nok\r\n0\r\n\r\n", body_of(response));
+
+  RETURN_OK();
+}
+
+int main(void) {
+  for (int i = 0; i < BIG_CHUNK_SIZE; i++)
+    big_chunk[i] = (char)('a' + i % 26);
+
+  response = malloc(BUF_SIZE);
+  decoded = malloc(BUF_SIZE);
+  if (!response || !decoded)
+    return 1;
+
+  if (uv_thread_create(&server_thread, server_thread_fn, NULL) != 0) {
+    fprintf(stderr, "Failed to create server thread\n");
+    return 1;
+  }
+
+  if (!wait_for_server_ready(response)) {
+    fprintf(stderr, "Server failed to start\n");
+    return 1;
+  }
+
+  RUN_TEST(test_stream_chunked);
+  RUN_TEST(test_stream_length);
+  RUN_TEST(test_stream_async);
+  RUN_TEST(test_stream_http10);
+  RUN_TEST(test_stream_large);
+  RUN_TEST(test_stream_coalesced);
+  RUN_TEST(test_stream_no_content);
+  RUN_TEST(test_stream_head);
+  RUN_TEST(test_stream_send_after_begin);
+
+  http_get_raw("/shutdown", "HTTP/1.1", response);
+  uv_thread_join(&server_thread);
+
+  free(response);
+  free(decoded);
+  return 0;
+}
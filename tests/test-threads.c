@@ -0,0 +1,328 @@
+// MIT License
+//
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Multi-threaded server test. Boots one app served by several worker loops
+// via ecewo_set_threads(), then verifies that requests are answered from
+// more than one loop, that concurrent clients are all served, and that
+// ecewo_shutdown() called from a worker thread stops every loop.
+
+#include "ecewo.h"
+#include "tester.h"
+#include "uv.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define APP_PORT 18803
+#define THREAD_COUNT 4
+#define CLIENT_COUNT 8
+
+#define BUF_SIZE 4096
+
+static uv_thread_t server_thread;
+static _Atomic bool server_ready = false;
+static _Atomic bool atexit_fired = false;
+static _Atomic int handled = 0;
+
+// ----- handlers --------------------------------------------------------------
+
+static void handler_root(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  atomic_fetch_add(&handled, 1);
+  ecewo_send_text(res, 200, "threads");
+}
+
+static void handler_loop_id(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%p", ecewo_get_loop());
+  ecewo_send_text(res, 200, buf);
+}
+
+static void handler_shutdown(ecewo_request_t *req, ecewo_response_t *res) {
+  ecewo_send_text(res, 200, "shutting-down");
+  ecewo_shutdown(ecewo_req_app(req));
+}
+
+static void on_atexit(void *user_data) {
+  (void)user_data;
+  atexit_fired = true;
+}
+
+// ----- minimal HTTP client ---------------------------------------------------
+
+typedef struct {
+  uv_tcp_t tcp;
+  uv_connect_t connect_req;
+  uv_write_t write_req;
+  uv_shutdown_t shutdown_req;
+  char *request_data;
+  char response_buffer[BUF_SIZE];
+  size_t response_len;
+  bool done;
+  int status_code;
+  int err;
+} http_client_t;
+
+static void client_alloc(uv_handle_t *handle, size_t suggested, uv_buf_t *buf) {
+  http_client_t *c = handle->data;
+  size_t avail = sizeof(c->response_buffer) - c->response_len;
+  buf->base = c->response_buffer + c->response_len;
+  buf->len = avail < suggested ? avail : suggested;
+}
+
+static void client_on_close(uv_handle_t *handle) {
+  http_client_t *c = handle->data;
+  c->done = true;
+}
+
+static void client_on_shutdown(uv_shutdown_t *req, int status) {
+  (void)status;
+  http_client_t *c = req->data;
+  uv_close((uv_handle_t *)&c->tcp, client_on_close);
+}
+
+static void client_on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+  (void)buf;
+  http_client_t *c = stream->data;
+  if (nread < 0) {
+    if (nread != UV_EOF)
+      c->err = (int)nread;
+    uv_read_stop(stream);
+    c->shutdown_req.data = c;
+    uv_shutdown(&c->shutdown_req, stream, client_on_shutdown);
+    return;
+  }
+  if (nread == 0)
+    return;
+  c->response_len += (size_t)nread;
+}
+
+static void client_on_write(uv_write_t *req, int status) {
+  http_client_t *c = req->data;
+  if (status < 0) {
+    c->err = status;
+    uv_close((uv_handle_t *)&c->tcp, client_on_close);
+    return;
+  }
+  uv_read_start((uv_stream_t *)&c->tcp, client_alloc, client_on_read);
+}
+
+static void client_on_connect(uv_connect_t *req, int status) {
+  http_client_t *c = req->data;
+  if (status < 0) {
+    c->err = status;
+    uv_close((uv_handle_t *)&c->tcp, client_on_close);
+    return;
+  }
+  uv_buf_t buf = uv_buf_init(c->request_data, (unsigned int)strlen(c->request_data));
+  c->write_req.data = c;
+  uv_write(&c->write_req, (uv_stream_t *)&c->tcp, &buf, 1, client_on_write);
+}
+
+// Sends a GET request to 127.0.0.1:port and returns the HTTP status code, or
+// -1 on connection failure.
+static int http_get(uint16_t port, const char *path, char *body_out, size_t body_cap) {
+  uv_loop_t loop;
+  if (uv_loop_init(&loop) < 0)
+    return -1;
+
+  http_client_t c;
+  memset(&c, 0, sizeof(c));
+  c.tcp.data = &c;
+  c.connect_req.data = &c;
+
+  char request[512];
+  snprintf(request, sizeof(request),
+           "GET %s HTTP/1.1\r\nHost: localhost:%u\r\nConnection: close\r\n\r\n",
+           path, (unsigned)port);
+  c.request_data = request;
+
+  uv_tcp_init(&loop, &c.tcp);
+  struct sockaddr_in addr;
+  uv_ip4_addr("127.0.0.1", port, &addr);
+  if (uv_tcp_connect(&c.connect_req, &c.tcp,
+                     (const struct sockaddr *)&addr, client_on_connect)
+      < 0) {
+    uv_close((uv_handle_t *)&c.tcp, client_on_close);
+  }
+
+  uint64_t start = uv_hrtime();
+  while (!c.done && uv_hrtime() - start < 5000ull * 1000000ull) {
+    uv_run(&loop, UV_RUN_NOWAIT);
+    if (c.done)
+      break;
+    uv_sleep(2);
+  }
+
+  uv_loop_close(&loop);
+
+  if (c.err != 0)
+    return -1;
+
+  unsigned status = 0;
+  if (sscanf(c.response_buffer, "HTTP/1.1 %u", &status) != 1)
+    return -1;
+
+  if (body_out && body_cap > 0) {
+    body_out[0] = '\0';
+    char *body = strstr(c.response_buffer, "\r\n\r\n");
+    if (body) {
+      body += 4;
+      strncpy(body_out, body, body_cap - 1);
+      body_out[body_cap - 1] = '\0';
+    }
+  }
+
+  return (int)status;
+}
+
+// ----- server thread ---------------------------------------------------------
+
+static void server_thread_fn(void *arg) {
+  (void)arg;
+
+  ecewo_app_t *app = ecewo_create();
+  if (!app) {
+    fprintf(stderr, "ecewo_create failed\n");
+    return;
+  }
+
+  ecewo_set_threads(app, THREAD_COUNT);
+  ecewo_atexit(app, on_atexit, NULL);
+
+  ECEWO_GET(app, "/", handler_root);
+  ECEWO_GET(app, "/loop", handler_loop_id);
+  ECEWO_GET(app, "/shutdown", handler_shutdown);
+
+  if (ecewo_bind(app, APP_PORT) != 0) {
+    fprintf(stderr, "bind failed\n");
+    return;
+  }
+
+  server_ready = true;
+
+  // Returns once every worker loop has stopped.
+  ecewo_run();
+
+  server_ready = false;
+}
+
+static bool wait_for_server_ready(void) {
+  for (int i = 0; i < 50; i++) {
+    if (server_ready) {
+      char body[64];
+      int s = http_get(APP_PORT, "/", body, sizeof(body));
+      if (s == 200)
+        return true;
+    }
+    uv_sleep(100);
+  }
+  return false;
+}
+
+static void client_thread_fn(void *arg) {
+  int *ok = arg;
+  char body[64];
+  for (int i = 0; i < 10; i++) {
+    if (http_get(APP_PORT, "/", body, sizeof(body)) == 200
+        && strcmp(body, "threads") == 0)
+      (*ok)++;
+  }
+}
+
+// ----- tests -----------------------------------------------------------------
+
+static int test_multiple_loops(void) {
+#if defined(_WIN32) || defined(__APPLE__)
+  RETURN_SKIP("SO_REUSEPORT load balancing is not available on this platform");
+#else
+  // Each connection lands on one listener; with enough connections the
+  // kernel spreads them over more than one worker.
+  char first[64];
+  ASSERT_EQ(200, http_get(APP_PORT, "/loop", first, sizeof(first)));
+
+  bool saw_other = false;
+  for (int i = 0; i < 64 && !saw_other; i++) {
+    char body[64];
+    ASSERT_EQ(200, http_get(APP_PORT, "/loop", body, sizeof(body)));
+    if (strcmp(body, first) != 0)
+      saw_other = true;
+  }
+  ASSERT_TRUE(saw_other);
+
+  RETURN_OK();
+#endif
+}
+
+static int test_concurrent_clients(void) {
+  uv_thread_t clients[CLIENT_COUNT];
+  int ok[CLIENT_COUNT] = { 0 };
+  int before = atomic_load(&handled);
+
+  for (int i = 0; i < CLIENT_COUNT; i++)
+    ASSERT_EQ(0, uv_thread_create(&clients[i], client_thread_fn, &ok[i]));
+  for (int i = 0; i < CLIENT_COUNT; i++)
+    uv_thread_join(&clients[i]);
+
+  for (int i = 0; i < CLIENT_COUNT; i++)
+    ASSERT_EQ(10, ok[i]);
+  ASSERT_EQ(before + CLIENT_COUNT * 10, atomic_load(&handled));
+
+  RETURN_OK();
+}
+
+static int test_shutdown_from_worker(void) {
+  // Whichever loop serves this request, every loop must stop and
+  // ecewo_run() must return.
+  char body[64];
+  int s = http_get(APP_PORT, "/shutdown", body, sizeof(body));
+  ASSERT_EQ(200, s);
+  ASSERT_EQ_STR("shutting-down", body);
+
+  uv_thread_join(&server_thread);
+
+  ASSERT_TRUE(atexit_fired);
+  ASSERT_FALSE(server_ready);
+  ASSERT_EQ(-1, http_get(APP_PORT, "/", body, sizeof(body)));
+
+  RETURN_OK();
+}
+
+int main(void) {
+  if (uv_thread_create(&server_thread, server_thread_fn, NULL) != 0) {
+    fprintf(stderr, "Failed to create server thread\n");
+    return 1;
+  }
+
+  if (!wait_for_server_ready()) {
+    fprintf(stderr, "Server failed to start\n");
+    return 1;
+  }
+
+  RUN_TEST(test_multiple_loops);
+  RUN_TEST(test_concurrent_clients);
+  RUN_TEST(test_shutdown_from_worker);
+
+  return 0;
+}
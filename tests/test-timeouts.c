@@ -0,0 +1,290 @@
+// MIT License
+//
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Idle and request timeout test. Raw connections are left idle, stalled
+// mid-request or kept busy, and the server must close exactly the ones
+// whose timeout ran out.
+
+#include "ecewo.h"
+#include "tester.h"
+#include "uv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define APP_PORT 18806
+
+#define IDLE_TIMEOUT_MS 400
+#define REQUEST_TIMEOUT_MS 400
+#define HANDLER_TIMEOUT_MS 150
+
+static uv_thread_t server_thread;
+static _Atomic bool server_ready = false;
+static ecewo_app_t *server_app;
+
+// ----- handlers --------------------------------------------------------------
+
+static void handler_hello(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_send_text(res, 200, "hello");
+}
+
+// Never replies; only its own, shorter timeout ends the request
+static void handler_stuck(ecewo_request_t *req, ecewo_response_t *res) {
+  (void)req;
+  ecewo_timeout_request(res, HANDLER_TIMEOUT_MS);
+}
+
+static void handler_shutdown(ecewo_request_t *req, ecewo_response_t *res) {
+  ecewo_send_text(res, 200, "shutting-down");
+  ecewo_shutdown(ecewo_req_app(req));
+}
+
+// ----- scripted client -------------------------------------------------------
+
+// Writes each request in turn, interval_ms apart, on one connection and
+// then reads until the server closes it or wait_ms pass without that.
+typedef struct {
+  uv_loop_t loop;
+  uv_tcp_t tcp;
+  uv_connect_t connect_req;
+  uv_timer_t timer;
+  const char **requests;
+  int count;
+  int next;
+  uint64_t interval_ms;
+  uint64_t wait_ms;
+  uint64_t last_write_ms;
+  uint64_t closed_after_ms; // since the last write
+  char response[8192];
+  size_t response_len;
+  bool closed_by_server;
+  bool done;
+} script_t;
+
+static void script_alloc(uv_handle_t *handle, size_t suggested, uv_buf_t *buf) {
+  (void)suggested;
+  script_t *s = handle->data;
+  buf->base = s->response + s->response_len;
+  buf->len = sizeof(s->response) - 1 - s->response_len;
+}
+
+static void script_on_close(uv_handle_t *handle) {
+  script_t *s = handle->data;
+  s->done = true;
+}
+
+static void script_finish(script_t *s) {
+  uv_timer_stop(&s->timer);
+  if (!uv_is_closing((uv_handle_t *)&s->tcp))
+    uv_close((uv_handle_t *)&s->tcp, script_on_close);
+}
+
+static void script_on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+  (void)buf;
+  script_t *s = stream->data;
+  if (nread < 0) {
+    s->closed_by_server = true;
+    s->closed_after_ms = uv_now(&s->loop) - s->last_write_ms;
+    script_finish(s);
+    return;
+  }
+  s->response_len += (size_t)nread;
+  s->response[s->response_len] = '\0';
+}
+
+static void script_on_timer(uv_timer_t *timer);
+
+static void script_write_next(script_t *s) {
+  static uv_write_t write_req;
+  const char *request = s->requests[s->next++];
+  uv_buf_t buf = uv_buf_init((char *)request, (unsigned int)strlen(request));
+  uv_write(&write_req, (uv_stream_t *)&s->tcp, &buf, 1, NULL);
+  s->last_write_ms = uv_now(&s->loop);
+
+  uint64_t delay = s->next < s->count ? s->interval_ms : s->wait_ms;
+  uv_timer_start(&s->timer, script_on_timer, delay, 0);
+}
+
+static void script_on_timer(uv_timer_t *timer) {
+  script_t *s = timer->data;
+  if (s->next < s->count)
+    script_write_next(s);
+  else
+    script_finish(s);
+}
+
+static void script_on_connect(uv_connect_t *req, int status) {
+  script_t *s = req->data;
+  if (status < 0) {
+    script_finish(s);
+    return;
+  }
+  uv_read_start((uv_stream_t *)&s->tcp, script_alloc, script_on_read);
+  script_write_next(s);
+}
+
+static void run_script(script_t *s, const char **requests, int count,
+                       uint64_t interval_ms, uint64_t wait_ms) {
+  memset(s, 0, sizeof(*s));
+  s->requests = requests;
+  s->count = count;
+  s->interval_ms = interval_ms;
+  s->wait_ms = wait_ms;
+
+  uv_loop_init(&s->loop);
+  uv_tcp_init(&s->loop, &s->tcp);
+  uv_timer_init(&s->loop, &s->timer);
+  s->tcp.data = s;
+  s->timer.data = s;
+  s->connect_req.data = s;
+
+  struct sockaddr_in addr;
+  uv_ip4_addr("127.0.0.1", APP_PORT, &addr);
+  if (uv_tcp_connect(&s->connect_req, &s->tcp, (const struct sockaddr *)&addr, script_on_connect) < 0)
+    script_finish(s);
+
+  uv_run(&s->loop, UV_RUN_DEFAULT);
+  uv_close((uv_handle_t *)&s->timer, NULL);
+  uv_run(&s->loop, UV_RUN_DEFAULT);
+  uv_loop_close(&s->loop);
+}
+
+// ----- server thread ---------------------------------------------------------
+
+static void server_thread_fn(void *arg) {
+  (void)arg;
+
+  ecewo_app_t *app = ecewo_create();
+  if (!app) {
+    fprintf(stderr, "ecewo_create failed\n");
+    return;
+  }
+
+  ecewo_set_idle_timeout(app, IDLE_TIMEOUT_MS);
+  ecewo_set_request_timeout(app, REQUEST_TIMEOUT_MS);
+
+  ECEWO_GET(app, "/hello", handler_hello);
+  ECEWO_GET(app, "/stuck", handler_stuck);
+  ECEWO_GET(app, "/shutdown", handler_shutdown);
+
+  if (ecewo_bind(app, APP_PORT) != 0) {
+    fprintf(stderr, "bind failed\n");
+    return;
+  }
+
+  server_app = app;
+  server_ready = true;
+  ecewo_run();
+  server_ready = false;
+}
+
+// ----- tests -----------------------------------------------------------------
+
+#define HELLO "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n"
+
+static script_t script;
+
+static int test_idle_connection_closed(void) {
+  uint64_t before = ecewo_timeout_expirations(server_app);
+  const char *requests[] = { HELLO };
+
+  run_script(&script, requests, 1, 0, 3000);
+
+  ASSERT_NOT_NULL(strstr(script.response, "\r\n\r\nhello"));
+  ASSERT_TRUE(script.closed_by_server);
+  ASSERT_LE(IDLE_TIMEOUT_MS - 10, script.closed_after_ms);
+  ASSERT_GT(IDLE_TIMEOUT_MS + 1000, script.closed_after_ms);
+  ASSERT_EQ(before + 1, ecewo_timeout_expirations(server_app));
+
+  RETURN_OK();
+}
+
+static int test_busy_connection_kept(void) {
+  // Five requests spread over twice the idle timeout, each well within it
+  const char *requests[] = { HELLO, HELLO, HELLO, HELLO, HELLO };
+
+  run_script(&script, requests, 5, IDLE_TIMEOUT_MS / 2, 3000);
+
+  ASSERT_TRUE(script.closed_by_server);
+  // Only the silence after the last request ends the connection
+  ASSERT_LE(IDLE_TIMEOUT_MS - 10, script.closed_after_ms);
+
+  int replies = 0;
+  for (const char *p = script.response; (p = strstr(p, "hello")) != NULL; p++)
+    replies++;
+  ASSERT_EQ(5, replies);
+
+  RETURN_OK();
+}
+
+static int test_stalled_request_closed(void) {
+  uint64_t before = ecewo_timeout_expirations(server_app);
+  const char *requests[] = { "GET /hello HTTP/1.1\r\nHost: loc" };
+
+  run_script(&script, requests, 1, 0, 3000);
+
+  ASSERT_EQ(0, (int)script.response_len);
+  ASSERT_TRUE(script.closed_by_server);
+  ASSERT_LE(REQUEST_TIMEOUT_MS - 10, script.closed_after_ms);
+  ASSERT_GT(REQUEST_TIMEOUT_MS + 1000, script.closed_after_ms);
+  ASSERT_EQ(before + 1, ecewo_timeout_expirations(server_app));
+
+  RETURN_OK();
+}
+
+static int test_handler_timeout_override(void) {
+  const char *requests[] = { "GET /stuck HTTP/1.1\r\nHost: localhost\r\n\r\n" };
+
+  run_script(&script, requests, 1, 0, 3000);
+
+  ASSERT_TRUE(script.closed_by_server);
+  ASSERT_LE(HANDLER_TIMEOUT_MS - 10, script.closed_after_ms);
+  ASSERT_GT(REQUEST_TIMEOUT_MS, script.closed_after_ms);
+
+  RETURN_OK();
+}
+
+int main(void) {
+  if (uv_thread_create(&server_thread, server_thread_fn, NULL) != 0) {
+    fprintf(stderr, "Failed to create server thread\n");
+    return 1;
+  }
+
+  for (int i = 0; i < 50 && !server_ready; i++)
+    uv_sleep(100);
+  if (!server_ready) {
+    fprintf(stderr, "Server failed to start\n");
+    return 1;
+  }
+
+  RUN_TEST(test_idle_connection_closed);
+  RUN_TEST(test_busy_connection_kept);
+  RUN_TEST(test_stalled_request_closed);
+  RUN_TEST(test_handler_timeout_override);
+
+  const char *requests[] = { "GET /shutdown HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n" };
+  run_script(&script, requests, 1, 0, 3000);
+  uv_thread_join(&server_thread);
+
+  return 0;
+}
@@ -138,6 +138,33 @@ static int test_query_plus_decoded(void) {
   RETURN_OK();
 }
 
+static int test_query_long_value_decoded(void) {
+  // Escapes straddling the 16- and 32-byte blocks the scanner reads, a
+  // stray '%' that isn't an escape, and a '%' cut short at the end
+  MockResponse res = request(&(MockParams){
+    .method = MOCK_GET,
+    .path = "/search?q=aaaaaaaaaaaaa%41bbbbbbbbbbbbbbbbbbbbbbbbbb+cccc%zzdddddddddd"
+            "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee%2Fffffffffffffffff%4",
+  });
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("aaaaaaaaaaaaaAbbbbbbbbbbbbbbbbbbbbbbbbbb cccc%zzdddddddddd"
+                "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee/ffffffffffffffff%4",
+                res.body);
+  free_request(&res);
+  RETURN_OK();
+}
+
+static int test_param_long_value_decoded(void) {
+  MockResponse res = request(&(MockParams){
+    .method = MOCK_GET,
+    .path = "/users/xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx%20yyyyyyyyyyyyyyyyyyyyyyyyyyyyyyy+zzzz",
+  });
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx yyyyyyyyyyyyyyyyyyyyyyyyyyyyyyy+zzzz", res.body);
+  free_request(&res);
+  RETURN_OK();
+}
+
 // -------------------------------------------------------------------------
 // Combined: encoded param + encoded query
 // -------------------------------------------------------------------------
@@ -163,6 +190,8 @@ int main(void) {
   RUN_TEST(test_query_space_decoded);
   RUN_TEST(test_query_cyrillic_decoded);
   RUN_TEST(test_query_plus_decoded);
+  RUN_TEST(test_query_long_value_decoded);
+  RUN_TEST(test_param_long_value_decoded);
 
   RUN_TEST(test_param_and_query_both_decoded);
 
@@ -88,6 +88,111 @@ int test_path_use_skipped_for_nonmatching(void) {
   RETURN_OK();
 }
 
+int test_path_use_on_param_route(void) {
+  // "/use-api/:id": the prefix covers every path of the route
+  MockParams params = { .method = MOCK_GET, .path = "/use-api/items/42" };
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("global=yes,api=yes", res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+int test_path_use_decided_per_request(void) {
+  // "/:section/list": the prefix applies only when :section is "use-api"
+  MockParams params = { .method = MOCK_GET, .path = "/use-api/list" };
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("global=yes,api=yes", res.body);
+  free_request(&res);
+
+  params.path = "/other/list";
+  res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("global=yes,api=no", res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+int test_path_use_not_bypassed_by_extra_slashes(void) {
+  // Routed to "/use-api/data"; the middleware must run as well
+  MockParams params = { .method = MOCK_GET, .path = "//use-api//data" };
+  MockResponse res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("global=yes,api=yes", res.body);
+  free_request(&res);
+
+  // "/:section/list" decides per request, on the path as it was routed
+  const char *paths[] = { "//use-api/list", "/use-api//list/", "///use-api///list" };
+  for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+    params.path = paths[i];
+    res = request(&params);
+
+    ASSERT_EQ(200, res.status_code);
+    ASSERT_EQ_STR("global=yes,api=yes", res.body);
+    free_request(&res);
+  }
+
+  params.path = "//other//list";
+  res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("global=yes,api=no", res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
+static void late_tag_mw(ecewo_request_t *req, ecewo_response_t *res, ecewo_next_t next) {
+  ecewo_context_set(req, "api", "late");
+  next(req, res);
+}
+
+static void add_middleware_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  ecewo_use(ecewo_req_app(req), "/use-public", late_tag_mw);
+  ecewo_send_text(res, 200, "added");
+}
+
+int test_use_after_bind(void) {
+  MockParams params = { .method = MOCK_POST, .path = "/use-add" };
+  MockResponse res = request(&params);
+  ASSERT_EQ(200, res.status_code);
+  free_request(&res);
+
+  // The chains built at bind time are stale now
+  params.method = MOCK_GET;
+  params.path = "/use-public";
+  res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("global=yes,api=late", res.body);
+  free_request(&res);
+
+  // Chains are built per request until the next freeze; extra slashes
+  // must not skip middleware there either
+  params.path = "//use-api//data";
+  res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("global=yes,api=yes", res.body);
+  free_request(&res);
+
+  params.path = "//use-public/";
+  res = request(&params);
+
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ_STR("global=yes,api=late", res.body);
+
+  free_request(&res);
+  RETURN_OK();
+}
+
 static void setup_routes(ecewo_app_t *app) {
   ecewo_use(app, NULL, global_tag_mw);
   ecewo_use(app, "/use-api", api_tag_mw);
@@ -96,6 +201,9 @@ static void setup_routes(ecewo_app_t *app) {
   ECEWO_GET(app, "/use-api", tag_handler);
   ECEWO_GET(app, "/use-api/data", tag_handler);
   ECEWO_GET(app, "/use-apiv2", tag_handler);
+  ECEWO_GET(app, "/use-api/items/:id", tag_handler);
+  ECEWO_GET(app, "/:section/list", tag_handler);
+  ECEWO_POST(app, "/use-add", add_middleware_handler);
 }
 
 int main(void) {
@@ -105,6 +213,10 @@ int main(void) {
   RUN_TEST(test_path_use_runs_for_prefix);
   RUN_TEST(test_path_use_runs_for_exact_match);
   RUN_TEST(test_path_use_skipped_for_nonmatching);
+  RUN_TEST(test_path_use_on_param_route);
+  RUN_TEST(test_path_use_decided_per_request);
+  RUN_TEST(test_path_use_not_bypassed_by_extra_slashes);
+  RUN_TEST(test_use_after_bind);
 
   mock_cleanup();
   return 0;
@@ -0,0 +1,129 @@
+// MIT License
+
+// Copyright (c) 2025-2026 Savas Sahin <savashn@proton.me>
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ecewo.h"
+#include "ecewo-mock.h"
+#include "tester.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Past the largest size class of the write pool
+#define LARGE_CHUNK_SIZE (64 * 1024)
+
+#define HITS "ecewo_write_pool_hits_total"
+#define MISSES "ecewo_write_pool_misses_total"
+
+static ecewo_app_t *test_app;
+
+// Past WRITE_COALESCE_SIZE but within the largest size class, so every
+// chunk is copied and takes a write request of its own
+#define STREAM_CHUNK_SIZE 8192
+
+static void stream_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  char *chunk = ecewo_alloc(ecewo_req_arena(req), STREAM_CHUNK_SIZE);
+  memset(chunk, 'x', STREAM_CHUNK_SIZE);
+
+  ecewo_stream_begin(res, 200);
+  for (int i = 0; i < 3; i++)
+    ecewo_stream_write(res, chunk, STREAM_CHUNK_SIZE, NULL);
+  ecewo_stream_end(res);
+}
+
+static void large_handler(ecewo_request_t *req, ecewo_response_t *res) {
+  char *chunk = ecewo_alloc(ecewo_req_arena(req), LARGE_CHUNK_SIZE);
+  memset(chunk, 'x', LARGE_CHUNK_SIZE);
+
+  ecewo_stream_begin_length(res, 200, LARGE_CHUNK_SIZE);
+  ecewo_stream_write(res, chunk, LARGE_CHUNK_SIZE, NULL);
+  ecewo_stream_end(res);
+}
+
+static void setup_routes(ecewo_app_t *app) {
+  test_app = app;
+
+  ECEWO_GET(app, "/stream", stream_handler);
+  ECEWO_GET(app, "/large", large_handler);
+}
+
+static MockResponse get(const char *path) {
+  return request(&(MockParams){
+    .method = MOCK_GET,
+    .path = path,
+  });
+}
+
+static int test_blocks_are_reused(void) {
+  // The first stream fills the free lists
+  MockResponse res = get("/stream");
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ(3 * STREAM_CHUNK_SIZE, (int64_t)strlen(res.body));
+  free_request(&res);
+
+  long long hits, misses;
+  metric_pair(test_app, HITS, MISSES, &hits, &misses);
+  ASSERT_TRUE(hits >= 0);
+  ASSERT_TRUE(misses > 0);
+
+  for (int i = 0; i < 20; i++) {
+    res = get("/stream");
+    ASSERT_EQ(200, res.status_code);
+    ASSERT_EQ(3 * STREAM_CHUNK_SIZE, (int64_t)strlen(res.body));
+    free_request(&res);
+  }
+
+  long long hits_after, misses_after;
+  metric_pair(test_app, HITS, MISSES, &hits_after, &misses_after);
+
+  // A copy and a write request per chunk; the head is rendered into the
+  // cork buffer and flushed ahead of the first chunk
+  ASSERT_EQ(misses, misses_after);
+  ASSERT_EQ(hits + 20 * 6, hits_after);
+  RETURN_OK();
+}
+
+static int test_large_copy_is_allocated(void) {
+  long long hits, misses;
+  metric_pair(test_app, HITS, MISSES, &hits, &misses);
+
+  MockResponse res = get("/large");
+  ASSERT_EQ(200, res.status_code);
+  ASSERT_EQ(LARGE_CHUNK_SIZE, (int64_t)strlen(res.body));
+  free_request(&res);
+
+  long long hits_after, misses_after;
+  metric_pair(test_app, HITS, MISSES, &hits_after, &misses_after);
+
+  // Only the copy of the chunk is too large for the pool
+  ASSERT_EQ(misses + 1, misses_after);
+  RETURN_OK();
+}
+
+int main(void) {
+  mock_init(setup_routes);
+
+  RUN_TEST(test_blocks_are_reused);
+  RUN_TEST(test_large_copy_is_allocated);
+
+  mock_cleanup();
+  return 0;
+}
@@ -29,6 +29,7 @@
 #include <stdbool.h>
 #include <inttypes.h>
 #include <stdint.h>
+#include "ecewo.h"
 
 // =============================================================================
 // TEST RUNNER
@@ -125,4 +126,38 @@ enum TestStatus {
 #define ASSERT_EQ_STR(a, b) \
   ASSERT_BASE_STR(strcmp(a, b) == 0, a, ==, b, char *, "s")
 
+// =============================================================================
+// METRICS
+// =============================================================================
+
+// Value of the sample in ecewo_metrics_render() output whose name, labels
+// included, is name, or -1 if there is none
+static inline long long metric(const char *text, const char *name) {
+  size_t name_len = strlen(name);
+  const char *p = text;
+
+  while (p && *p) {
+    if (strncmp(p, name, name_len) == 0 && p[name_len] == ' ')
+      return strtoll(p + name_len + 1, NULL, 10);
+
+    p = strchr(p, '\n');
+    if (p)
+      p++;
+  }
+  return -1;
+}
+
+// Reads a pair of counters, such as a pool's hits and misses, straight from
+// ecewo_metrics_render(); no request is made, so none is counted
+static inline void metric_pair(ecewo_app_t *app,
+                               const char *hits_name,
+                               const char *misses_name,
+                               long long *hits,
+                               long long *misses) {
+  char text[8192];
+  ecewo_metrics_render(app, text, sizeof(text));
+  *hits = metric(text, hits_name);
+  *misses = metric(text, misses_name);
+}
+
 #endif